@@ -127,7 +127,7 @@ void Client::socketDisconnected()
 
 void Client::messageReceived(const Message &msg)
 {
-    m_statModel->addMessage(msg.address(), msg.type(), msg.size());
+    m_statModel->addMessage(msg, MessageStatisticsModel::Received);
     // server version must be the very first message we get
     if (!(m_initState & VersionChecked)) {
         if (msg.address() != endpointAddress() || msg.type() != Protocol::ServerVersion) {
@@ -283,6 +283,6 @@ void Client::unmonitorObject(Protocol::ObjectAddress objectAddress)
 
 void Client::doSendMessage(const GammaRay::Message &msg)
 {
-    m_statModel->addMessage(msg.address(), msg.type(), msg.size());
     Endpoint::doSendMessage(msg);
+    m_statModel->addMessage(msg, MessageStatisticsModel::Sent);
 }
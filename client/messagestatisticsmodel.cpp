@@ -30,8 +30,11 @@
 
 #include <ui/uiintegration.h>
 
+#include <common/message.h>
 #include <core/metaenum.h>
 
+#include <compat/qasconst.h>
+
 #include <algorithm>
 #include <numeric>
 
@@ -67,6 +70,7 @@ static const MetaEnum::Value<Protocol::MessageType> message_type_table[] = {
     M(ModelColumnsRemoved),
     M(ModelReset),
     M(ModelLayoutChanged),
+    M(ModelRowsPermuted),
     M(SelectionModelSelect),
     M(SelectionModelCurrent),
     M(MethodCall),
@@ -80,10 +84,79 @@ static const MetaEnum::Value<Protocol::MessageType> message_type_table[] = {
 #undef M
 Q_STATIC_ASSERT(Protocol::MESSAGE_TYPE_COUNT - 1 == (sizeof(message_type_table) / sizeof(MetaEnum::Value<Protocol::MessageType>)));
 
+// the server processing time of all requests of an object, after the message type columns
+static const int ServerProcessingColumn = Protocol::MESSAGE_TYPE_COUNT - 1;
+
+// upper bound of outstanding requests per object and type, protects against replies that never arrive
+static const int MaxPendingRequests = 1024;
+
+static bool expectsReply(Protocol::MessageType msgType)
+{
+    switch (msgType) {
+    case Protocol::ModelRowColumnCountRequest:
+    case Protocol::ModelContentRequest:
+    case Protocol::ModelHeaderRequest:
+    case Protocol::ModelSyncBarrier:
+        return true;
+    }
+    return false;
+}
+
+static Protocol::MessageType requestForReply(Protocol::MessageType msgType)
+{
+    switch (msgType) {
+    case Protocol::ModelRowColumnCountReply:
+        return Protocol::ModelRowColumnCountRequest;
+    case Protocol::ModelContentReply:
+        return Protocol::ModelContentRequest;
+    case Protocol::ModelHeaderReply:
+        return Protocol::ModelHeaderRequest;
+    case Protocol::ModelSyncBarrier:
+        return Protocol::ModelSyncBarrier;
+    }
+    return Protocol::InvalidMessageType;
+}
+
+void MessageStatisticsModel::LatencyHistogram::add(qint64 usecs)
+{
+    const auto value = quint64(qMax<qint64>(usecs, 0));
+    int bucket = 0;
+    for (auto v = value >> 1; v && bucket < BucketCount - 1; v >>= 1)
+        ++bucket;
+    ++buckets[bucket];
+    ++count;
+    max = qMax(max, value);
+}
+
+qint64 MessageStatisticsModel::LatencyHistogram::percentile(int percent) const
+{
+    if (!count)
+        return 0;
+
+    const auto rank = (count * percent + 99) / 100;
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return qint64(qMin((quint64(2) << bucket) - 1, max));
+    }
+    return qint64(max);
+}
+
+MessageStatisticsModel::LatencyHistogram &MessageStatisticsModel::LatencyHistogram::operator+=(const LatencyHistogram &other)
+{
+    for (int bucket = 0; bucket < BucketCount; ++bucket)
+        buckets[bucket] += other.buckets[bucket];
+    count += other.count;
+    max = qMax(max, other.max);
+    return *this;
+}
+
 MessageStatisticsModel::Info::Info()
 {
     messageCount.resize(Protocol::MESSAGE_TYPE_COUNT);
     messageSize.resize(Protocol::MESSAGE_TYPE_COUNT);
+    messageWireSize.resize(Protocol::MESSAGE_TYPE_COUNT);
 }
 
 int MessageStatisticsModel::Info::totalCount() const
@@ -96,11 +169,18 @@ quint64 MessageStatisticsModel::Info::totalSize() const
     return std::accumulate(messageSize.begin(), messageSize.end(), 0ull);
 }
 
+quint64 MessageStatisticsModel::Info::totalWireSize() const
+{
+    return std::accumulate(messageWireSize.begin(), messageWireSize.end(), 0ull);
+}
+
 MessageStatisticsModel::MessageStatisticsModel(QObject *parent)
     : QAbstractTableModel(parent)
     , m_totalCount(0)
     , m_totalSize(0)
+    , m_totalWireSize(0)
 {
+    m_clock.start();
 }
 
 MessageStatisticsModel::~MessageStatisticsModel() = default;
@@ -111,6 +191,8 @@ void MessageStatisticsModel::clear()
     m_data.clear();
     m_totalCount = 0;
     m_totalSize = 0;
+    m_totalWireSize = 0;
+    m_clock.restart();
     endResetModel();
 }
 
@@ -128,31 +210,70 @@ void MessageStatisticsModel::addObject(Protocol::ObjectAddress addr, const QStri
     }
 }
 
-void MessageStatisticsModel::addMessage(Protocol::ObjectAddress addr, Protocol::MessageType msgType, int size)
+void MessageStatisticsModel::addMessage(const Message &msg, Direction direction)
 {
+    const auto now = m_clock.nsecsElapsed() / 1000;
+    const auto requestType = direction == Sent ? Protocol::InvalidMessageType : requestForReply(msg.type());
+    const auto size = msg.size();
+    const auto wireSize = msg.wireSize();
+
+    auto addr = msg.address();
+    auto msgType = msg.type();
     addr -= 1;
     msgType -= 1;
 
     ++m_totalCount;
     m_totalSize += size;
+    m_totalWireSize += wireSize;
 
-    if (addr < m_data.size()) {
-        m_data[addr].messageCount[msgType]++;
-        m_data[addr].messageSize[msgType] += size;
-        emit dataChanged(index(addr, msgType + 1), index(addr, msgType + 1));
-    } else {
+    if (addr >= m_data.size()) {
         beginInsertRows(QModelIndex(), m_data.size(), addr);
         m_data.resize(addr + 1);
-        m_data[addr].messageCount[msgType] = 1;
-        m_data[addr].messageSize[msgType] = size;
         endInsertRows();
     }
+
+    auto &info = m_data[addr];
+    info.messageCount[msgType]++;
+    info.messageSize[msgType] += size;
+    info.messageWireSize[msgType] += wireSize;
+    emit dataChanged(index(addr, msgType), index(addr, msgType));
+
+    if (direction == Sent && expectsReply(msgType + 1)) {
+        auto &pending = info.pendingRequests[msgType];
+        if (pending.size() >= MaxPendingRequests)
+            pending.erase(pending.begin());
+        pending.insert(msg.requestId(), now);
+    } else if (requestType != Protocol::InvalidMessageType) {
+        const int requestColumn = requestType - 1;
+        auto it = info.pendingRequests.find(requestColumn);
+        if (it == info.pendingRequests.end())
+            return;
+        auto &pending = it.value();
+        const auto request = pending.find(msg.requestId());
+        if (request == pending.end())
+            return; // unsolicited, or we missed the request
+        const auto latency = now - request.value();
+        info.latency[requestColumn].add(latency);
+        Protocol::Timestamp received, replied;
+        if (requestType != Protocol::ModelSyncBarrier && msg.replyTimestamps(received, replied)) {
+            const auto processing = qint64(replied - received);
+            info.processing[requestColumn].add(processing);
+            info.transfer[requestColumn].add(latency - processing);
+        }
+        // replies arrive in order, the server doesn't answer requests for stale indexes
+        // or a missing model, and won't do so later on
+        while (pending.begin() != request)
+            pending.erase(pending.begin());
+        pending.erase(request);
+        emit dataChanged(index(addr, requestColumn), index(addr, requestColumn));
+        emit dataChanged(index(addr, ServerProcessingColumn), index(addr, ServerProcessingColumn));
+    }
 }
 
 int MessageStatisticsModel::columnCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return Protocol::MESSAGE_TYPE_COUNT - 1;
+    return ServerProcessingColumn + 1;
 }
 
 int MessageStatisticsModel::rowCount(const QModelIndex &parent) const
@@ -185,10 +306,25 @@ QVariant MessageStatisticsModel::data(const QModelIndex &index, int role) const
     const auto &info = m_data.at(index.row());
     const auto msgType = index.column();
 
+    if (msgType == ServerProcessingColumn) {
+        LatencyHistogram processing;
+        for (const auto &h : info.processing)
+            processing += h;
+        if (role == Qt::DisplayRole && processing.count)
+            return tr("p95: %1 ms").arg(processing.percentile(95) / 1000.0, 0, 'f', 1);
+        if (role == Qt::ToolTipRole)
+            return tr("Object: %1").arg(info.name) + processingSummary(info.processing);
+        return QVariant();
+    }
+
     if (role == Qt::DisplayRole) {
-        return QString(QString::number(info.messageCount[msgType])
-                       + QStringLiteral(" / ")
-                       + QString::number(info.messageSize[msgType]));
+        auto s = QString(QString::number(info.messageCount[msgType])
+                         + QStringLiteral(" / ")
+                         + QString::number(info.messageSize[msgType]));
+        const auto it = info.latency.constFind(msgType);
+        if (it != info.latency.constEnd())
+            s += QStringLiteral(" / ") + tr("p95: %1 ms").arg(it.value().percentile(95) / 1000.0, 0, 'f', 1);
+        return s;
     }
 
     if (role == Qt::BackgroundRole && m_totalCount > 0 && m_totalSize > 0) {
@@ -211,7 +347,10 @@ QVariant MessageStatisticsModel::data(const QModelIndex &index, int role) const
                arg(100.0 * (double)info.messageCount[msgType] / (double)m_totalCount, 0, 'f', 2).
                arg(info.messageSize[msgType]).
                arg(m_totalSize).
-               arg(100.0 * (double)info.messageSize[msgType] / (double)m_totalSize, 0, 'f', 2);
+               arg(100.0 * (double)info.messageSize[msgType] / (double)m_totalSize, 0, 'f', 2)
+               + trafficSummary(info.messageSize[msgType], info.messageWireSize[msgType])
+               + latencySummary(info.latency.value(msgType), info.processing.value(msgType),
+                                info.transfer.value(msgType));
     }
 
     return QVariant();
@@ -219,7 +358,19 @@ QVariant MessageStatisticsModel::data(const QModelIndex &index, int role) const
 
 QVariant MessageStatisticsModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
-    if (orientation == Qt::Horizontal) {
+    if (orientation == Qt::Horizontal && section == ServerProcessingColumn) {
+        if (role == Qt::DisplayRole)
+            return tr("Server Processing");
+        if (role == Qt::ToolTipRole) {
+            QHash<int, LatencyHistogram> processing;
+            for (const auto &info : m_data) {
+                for (auto it = info.processing.constBegin(); it != info.processing.constEnd(); ++it)
+                    processing[it.key()] += it.value();
+            }
+            return tr("Time the server spent answering remote model requests, excluding transfer and queueing.")
+                   + processingSummary(processing);
+        }
+    } else if (orientation == Qt::Horizontal) {
         if (role == Qt::DisplayRole)
             return MetaEnum::enumToString(static_cast<Protocol::MessageType>(section + 1), message_type_table);
 
@@ -241,7 +392,11 @@ QVariant MessageStatisticsModel::headerData(int section, Qt::Orientation orienta
                    arg(100.0 * (double)count / (double)m_totalCount, 0, 'f', 2).
                    arg(size).
                    arg(m_totalSize).
-                   arg(100.0 * (double)size / (double)m_totalSize, 0, 'f', 2);
+                   arg(100.0 * (double)size / (double)m_totalSize, 0, 'f', 2)
+                   + trafficSummary(size, wireSizePerType(section))
+                   + latencySummary(latencyPerType(&Info::latency, section),
+                                    latencyPerType(&Info::processing, section),
+                                    latencyPerType(&Info::transfer, section));
         }
     } else if (orientation == Qt::Vertical) {
         const auto &info = m_data.at(section);
@@ -266,7 +421,8 @@ QVariant MessageStatisticsModel::headerData(int section, Qt::Orientation orienta
                    arg(size).
                    arg(m_totalSize).
                    arg(100.0 * (double)size / (double)m_totalSize, 0, 'f', 2).
-                   arg(section + 1);
+                   arg(section + 1)
+                   + trafficSummary(size, info.totalWireSize());
         }
     }
 
@@ -290,3 +446,72 @@ quint64 MessageStatisticsModel::sizePerType(int msgType) const
     }
     return c;
 }
+
+quint64 MessageStatisticsModel::wireSizePerType(int msgType) const
+{
+    quint64 c = 0;
+    for (const auto &info : m_data) {
+        c += info.messageWireSize.at(msgType);
+    }
+    return c;
+}
+
+MessageStatisticsModel::LatencyHistogram MessageStatisticsModel::latencyPerType(QHash<int, LatencyHistogram> Info::*member, int msgType) const
+{
+    LatencyHistogram h;
+    for (const auto &info : m_data) {
+        const auto &histograms = info.*member;
+        const auto it = histograms.constFind(msgType);
+        if (it != histograms.constEnd())
+            h += it.value();
+    }
+    return h;
+}
+
+QString MessageStatisticsModel::trafficSummary(quint64 size, quint64 wireSize) const
+{
+    if (!wireSize)
+        return QString();
+    const auto secs = std::max<qint64>(m_clock.elapsed(), 1) / 1000.0;
+    return tr("\nTransferred Size: %1 (compression ratio %2)\nAverage Bandwidth: %3 bytes/s over %4 s").
+           arg(wireSize).
+           arg((double)size / (double)wireSize, 0, 'f', 2).
+           arg((double)wireSize / secs, 0, 'f', 0).
+           arg(secs, 0, 'f', 0);
+}
+
+QString MessageStatisticsModel::percentiles(const QString &label, const LatencyHistogram &h)
+{
+    return tr("\n%1 (%2 replies): p50 %3 ms, p95 %4 ms, p99 %5 ms, max %6 ms").
+           arg(label).
+           arg(h.count).
+           arg(h.percentile(50) / 1000.0, 0, 'f', 2).
+           arg(h.percentile(95) / 1000.0, 0, 'f', 2).
+           arg(h.percentile(99) / 1000.0, 0, 'f', 2).
+           arg(h.max / 1000.0, 0, 'f', 2);
+}
+
+QString MessageStatisticsModel::latencySummary(const LatencyHistogram &latency, const LatencyHistogram &processing,
+                                               const LatencyHistogram &transfer)
+{
+    if (!latency.count)
+        return QString();
+    auto s = percentiles(tr("Round-trip Latency"), latency);
+    if (processing.count) {
+        s += percentiles(tr("Server Processing"), processing)
+             + percentiles(tr("Transfer and Queueing"), transfer);
+    }
+    return s;
+}
+
+QString MessageStatisticsModel::processingSummary(const QHash<int, LatencyHistogram> &processing)
+{
+    auto msgTypes = processing.keys();
+    std::sort(msgTypes.begin(), msgTypes.end());
+    QString s;
+    for (const auto msgType : qAsConst(msgTypes)) {
+        s += percentiles(MetaEnum::enumToString(static_cast<Protocol::MessageType>(msgType + 1), message_type_table),
+                         processing.value(msgType));
+    }
+    return s;
+}
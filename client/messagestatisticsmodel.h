@@ -32,11 +32,23 @@
 #include <common/protocol.h>
 
 #include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QLinearGradient>
+#include <QMap>
 #include <QVector>
 
 namespace GammaRay {
-/** Diagnostics for GammaRay-internal communication. */
+class Message;
+
+/** Diagnostics for GammaRay-internal communication.
+ *  Besides message counts and sizes this tracks the transferred (compressed) size
+ *  and the round-trip latency of remote model requests, by matching each reply
+ *  to the request of the same object with the request id it echoes. The round-trip
+ *  time is split into the server processing time, taken from the timestamps the server
+ *  appends to the reply, and the remaining transfer and queueing time.
+ *  The last column shows the server processing time of all requests of an object.
+ */
 class MessageStatisticsModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -44,9 +56,14 @@ public:
     explicit MessageStatisticsModel(QObject *parent = nullptr);
     ~MessageStatisticsModel() override;
 
+    enum Direction {
+        Sent,
+        Received
+    };
+
     void clear();
     void addObject(Protocol::ObjectAddress addr, const QString &name);
-    void addMessage(Protocol::ObjectAddress addr, Protocol::MessageType msgType, int size);
+    void addMessage(const Message &msg, Direction direction);
 
     int columnCount(const QModelIndex &parent) const override;
     int rowCount(const QModelIndex &parent) const override;
@@ -54,21 +71,54 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
 private:
+    /// Power of two buckets of round-trip times in microseconds.
+    struct LatencyHistogram {
+        enum { BucketCount = 32 };
+
+        void add(qint64 usecs);
+        /// Upper bound of the bucket containing the given percentile, in microseconds.
+        qint64 percentile(int percent) const;
+        LatencyHistogram &operator+=(const LatencyHistogram &other);
+
+        quint64 buckets[BucketCount] = {};
+        quint64 count = 0;
+        quint64 max = 0;
+    };
+
     int countPerType(int msgType) const;
     quint64 sizePerType(int msgType) const;
+    quint64 wireSizePerType(int msgType) const;
+    struct Info;
+    /// Sum of the histograms @p member of all objects for requests of type @p msgType.
+    LatencyHistogram latencyPerType(QHash<int, LatencyHistogram> Info::*member, int msgType) const;
+    QString trafficSummary(quint64 size, quint64 wireSize) const;
+    static QString latencySummary(const LatencyHistogram &latency, const LatencyHistogram &processing,
+                                  const LatencyHistogram &transfer);
+    static QString percentiles(const QString &label, const LatencyHistogram &h);
+    static QString processingSummary(const QHash<int, LatencyHistogram> &processing);
 
     struct Info {
         Info();
         int totalCount() const;
         quint64 totalSize() const;
+        quint64 totalWireSize() const;
 
         QString name;
         QVector<int> messageCount;
         QVector<quint64> messageSize;
+        QVector<quint64> messageWireSize;
+        // keyed by request message type, ie. column
+        QHash<int, LatencyHistogram> latency;
+        QHash<int, LatencyHistogram> processing;
+        QHash<int, LatencyHistogram> transfer;
+        // send times of the outstanding requests by request id
+        QHash<int, QMap<Protocol::RequestId, qint64>> pendingRequests;
     };
     QVector<Info> m_data;
     int m_totalCount;
     quint64 m_totalSize;
+    quint64 m_totalWireSize;
+    QElapsedTimer m_clock;
 };
 }
 
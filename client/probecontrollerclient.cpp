@@ -46,3 +46,15 @@ void ProbeControllerClient::quitHost()
 {
     Endpoint::instance()->invokeObject(objectName(), "quitHost");
 }
+
+void ProbeControllerClient::requestModelSnapshot(const QString &modelName, const QString &targetFilePath)
+{
+    Endpoint::instance()->invokeObject(objectName(), "requestModelSnapshot",
+                                       QVariantList() << modelName << targetFilePath);
+}
+
+void ProbeControllerClient::cancelModelSnapshot(const QString &targetFilePath)
+{
+    Endpoint::instance()->invokeObject(objectName(), "cancelModelSnapshot",
+                                       QVariantList() << targetFilePath);
+}
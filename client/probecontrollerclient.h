@@ -41,6 +41,8 @@ public:
 
     void detachProbe() override;
     void quitHost() override;
+    void requestModelSnapshot(const QString &modelName, const QString &targetFilePath) override;
+    void cancelModelSnapshot(const QString &targetFilePath) override;
 };
 }
 
@@ -29,6 +29,7 @@
 #include "processtracker.h"
 
 #include <QDebug>
+#include <QPointer>
 #include <QTimer>
 
 using namespace GammaRay;
@@ -39,7 +40,7 @@ class ProcessTracker::D : public QObject
 
 public:
     GammaRay::ProcessTracker *tracker;
-    GammaRay::ProcessTrackerBackend *backend;
+    QPointer<GammaRay::ProcessTrackerBackend> backend;
     QTimer *ticker;
     GammaRay::ProcessTrackerInfo previousInfo;
     qint64 pid;
@@ -111,6 +112,7 @@ void ProcessTracker::setBackend(GammaRay::ProcessTrackerBackend *backend)
     if (d->backend) {
         disconnect(d->backend, &ProcessTrackerBackend::processChecked,
                    d.data(), &D::processChecked);
+        d->backend->stopChecking();
     }
 
     d->backend = backend;
@@ -149,6 +151,8 @@ void ProcessTracker::stop()
 {
     d->previousInfo = ProcessTrackerInfo();
     d->ticker->stop();
+    if (d->backend)
+        d->backend->stopChecking();
 }
 
 bool ProcessTrackerInfo::operator==(const GammaRay::ProcessTrackerInfo &other) const
@@ -169,4 +173,8 @@ ProcessTrackerBackend::ProcessTrackerBackend(QObject *parent)
 {
 }
 
+void ProcessTrackerBackend::stopChecking()
+{
+}
+
 #include "processtracker.moc"
@@ -101,6 +101,8 @@ public:
 
 public slots:
     virtual void checkProcess(qint64 pid) = 0;
+    /// Stops whatever a backend checks on its own in between checkProcess() calls.
+    virtual void stopChecking();
 
 signals:
     void processChecked(const GammaRay::ProcessTrackerInfo &info);
@@ -31,76 +31,189 @@
 
 #include "processtracker_linux.h"
 
-#include <QFile>
-#include <QStringList>
-#include <QTextCodec>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace {
-static QString readFile(const QString &filePath, const QByteArray &codec = QByteArrayLiteral("UTF-8"))
+// polling is fast right after a change, as stops are often short, and backs off while nothing happens
+static const int MinPollInterval = 25;
+static const int MaxPollInterval = 2000;
+
+static int pidfdOpen(qint64 pid)
 {
-    QFile file(filePath);
+#ifdef SYS_pidfd_open
+    return int(syscall(SYS_pidfd_open, pid_t(pid), 0));
+#else
+    Q_UNUSED(pid);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
 
-    if (!file.exists()) {
-        qWarning("%s: File does not exists", Q_FUNC_INFO);
-        return QString();
+static QByteArray fieldValue(const QByteArray &status, const char *field)
+{
+    const int start = status.indexOf(field);
+    if (start < 0)
+        return QByteArray();
+    const int valueStart = start + int(qstrlen(field));
+    int end = status.indexOf('\n', valueStart);
+    if (end < 0)
+        end = status.size();
+    return status.mid(valueStart, end - valueStart).trimmed();
+}
+}
+
+using namespace GammaRay;
+
+ProcessTrackerBackendLinux::ProcessTrackerBackendLinux(QObject *parent)
+    : GammaRay::ProcessTrackerBackend(parent)
+    , m_pollTimer(new QTimer(this))
+{
+    m_pollTimer->setSingleShot(true);
+    connect(m_pollTimer, &QTimer::timeout, this, &ProcessTrackerBackendLinux::poll);
+}
+
+ProcessTrackerBackendLinux::~ProcessTrackerBackendLinux()
+{
+    unwatch();
+}
+
+void ProcessTrackerBackendLinux::checkProcess(qint64 pid)
+{
+    if (pid == m_exitedPid) {
+        emit processChecked(GammaRay::ProcessTrackerInfo(pid));
+        return;
     }
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning("%s: File can not be opened", Q_FUNC_INFO);
-        return QString();
+    if (pid != m_info.pid || m_statusFd < 0) {
+        watch(pid);
+    } else {
+        if (m_exitNotifier)
+            m_exitNotifier->setEnabled(true);
+        poll();
     }
 
-    QTextCodec *tc = QTextCodec::codecForName(codec);
-    if (!tc) {
-        tc = QTextCodec::codecForLocale();
+    emit processChecked(m_info);
+}
+
+void ProcessTrackerBackendLinux::stopChecking()
+{
+    // the descriptors stay open, so checking again later still refers to the same process
+    m_pollTimer->stop();
+    if (m_exitNotifier)
+        m_exitNotifier->setEnabled(false);
+}
+
+void ProcessTrackerBackendLinux::watch(qint64 pid)
+{
+    unwatch();
+    m_info = GammaRay::ProcessTrackerInfo(pid);
+    m_exitedPid = -1;
+
+    // the descriptors refer to the process rather than the pid, so pid reuse can't confuse us
+    m_statusFd = ::open(QByteArray("/proc/" + QByteArray::number(pid) + "/status").constData(), O_RDONLY | O_CLOEXEC);
+    if (m_statusFd < 0)
+        return;
+
+    // wakes us up on exit, without it we only notice when polling fails
+    m_pidFd = pidfdOpen(pid);
+    if (m_pidFd >= 0) {
+        m_exitNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read, this);
+        // the activated() overloads in Qt 5.15 make the function pointer syntax ambiguous
+        connect(m_exitNotifier, SIGNAL(activated(int)), this, SLOT(processExited()));
     }
 
-    return tc->toUnicode(file.readAll());
+    m_pollInterval = MinPollInterval;
+    poll();
 }
+
+void ProcessTrackerBackendLinux::unwatch()
+{
+    m_pollTimer->stop();
+    if (m_exitNotifier) {
+        // we might be in its activated() signal
+        m_exitNotifier->setEnabled(false);
+        m_exitNotifier->deleteLater();
+        m_exitNotifier = nullptr;
+    }
+    if (m_pidFd >= 0) {
+        ::close(m_pidFd);
+        m_pidFd = -1;
+    }
+    if (m_statusFd >= 0) {
+        ::close(m_statusFd);
+        m_statusFd = -1;
+    }
 }
 
-using namespace GammaRay;
+bool ProcessTrackerBackendLinux::readStatus(GammaRay::ProcessTrackerInfo *info) const
+{
+    // the whole file fits, re-reading from the start regenerates it
+    char buffer[4096];
+    const auto size = ::pread(m_statusFd, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+        return false; // ESRCH once the process is gone
+    const auto status = QByteArray::fromRawData(buffer, int(size));
+
+    info->traced = fieldValue(status, "TracerPid:").toLongLong();
+
+    // status decoding as taken from fs/proc/array.c
+    const auto state = fieldValue(status, "State:");
+    switch (state.isEmpty() ? '\0' : state.at(0)) {
+    case 'T':
+    case 't': // Tracing stop
+        info->state = GammaRay::ProcessTracker::Suspended;
+        break;
+    case 'S': // Sleeping
+    case 'R':
+        info->state = GammaRay::ProcessTracker::Running;
+        break;
+    //case 'Z': // Zombie
+    //case 'D': // Disk Sleep
+    //case 'W': // Paging
+    default:
+        info->state = GammaRay::ProcessTracker::Unknown;
+        break;
+    }
+    return true;
+}
 
-ProcessTrackerBackendLinux::ProcessTrackerBackendLinux(QObject *parent)
-    : GammaRay::ProcessTrackerBackend(parent)
+void ProcessTrackerBackendLinux::processExited()
 {
+    // the pidfd stays readable, and a zombie still has a status file
+    unwatch();
+    m_exitedPid = m_info.pid;
+    const GammaRay::ProcessTrackerInfo info(m_info.pid);
+    if (info != m_info) {
+        m_info = info;
+        emit processChecked(m_info);
+    }
 }
 
-void ProcessTrackerBackendLinux::checkProcess(qint64 pid)
+void ProcessTrackerBackendLinux::poll()
 {
-    GammaRay::ProcessTrackerInfo pinfo(pid);
-    QString buffer(readFile(QString::fromLatin1("/proc/%1/status").arg(pid)));
-
-    if (!buffer.isEmpty()) {
-        const QStringList values = buffer.remove(QLatin1Char('\t')).split(QLatin1Char('\n'));
-
-        for (const QString &value : values) {
-            if (value.startsWith(QStringLiteral("TracerPid:"))) {
-                pinfo.traced = value.split(QLatin1Char(':')).value(1).simplified().toLongLong();
-            }
-            else if (value.startsWith(QStringLiteral("State:"))) {
-                const char status(value.split(QLatin1Char(':')).value(1).simplified()[0].toUpper().toLatin1());
-
-                // status decoding as taken from fs/proc/array.c
-                switch (status) {
-                    case 'T': {
-                        pinfo.state = GammaRay::ProcessTracker::Suspended;
-                        break;
-                    }
-
-                    case 'S': // Sleeping
-                    case 'R': {
-                        pinfo.state = GammaRay::ProcessTracker::Running;
-                        break;
-                    }
-
-                    //case 'Z': // Zombie
-                    //case 'D': // Disk Sleep
-                    //case 'W': // Paging
-                }
-            }
-        }
+    if (m_statusFd < 0)
+        return;
+
+    GammaRay::ProcessTrackerInfo info(m_info.pid);
+    if (!readStatus(&info)) {
+        processExited();
+        return;
     }
 
-    emit processChecked(pinfo);
+    if (info != m_info) {
+        m_info = info;
+        m_pollInterval = MinPollInterval;
+        emit processChecked(m_info);
+    } else {
+        m_pollInterval = std::min(m_pollInterval * 2, MaxPollInterval);
+    }
+    m_pollTimer->start(m_pollInterval);
 }
@@ -31,17 +31,48 @@
 
 #include "processtracker.h"
 
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 
+/*! Tracks a process by the pidfd for its exit, and by polling its status for stops and tracing.
+ *
+ *  Changes are reported by processChecked() as soon as they are noticed, not only on checkProcess(),
+ *  until stopChecking() is called. The polling interval adapts, it is short right after a change and
+ *  backs off while nothing changes. Once the process exited its pid is not watched again, as it might
+ *  belong to another process by then.
+ */
 class GAMMARAY_CLIENT_EXPORT ProcessTrackerBackendLinux : public ProcessTrackerBackend
 {
     Q_OBJECT
 
 public:
     explicit ProcessTrackerBackendLinux(QObject *parent = nullptr);
+    ~ProcessTrackerBackendLinux() override;
 
 public slots:
     void checkProcess(qint64 pid) override;
+    void stopChecking() override;
+
+private slots:
+    void processExited();
+
+private:
+    void watch(qint64 pid);
+    void unwatch();
+    bool readStatus(GammaRay::ProcessTrackerInfo *info) const;
+    void poll();
+
+    GammaRay::ProcessTrackerInfo m_info;
+    qint64 m_exitedPid = -1;
+    int m_statusFd = -1;
+    int m_pidFd = -1;
+    QSocketNotifier *m_exitNotifier = nullptr;
+    QTimer *m_pollTimer;
+    int m_pollInterval = 0;
 };
 
 }
@@ -100,6 +100,7 @@ RemoteModel::RemoteModel(const QString &serverObject, QObject *parent)
     , m_myAddress(Protocol::InvalidObjectAddress)
     , m_currentSyncBarrier(0)
     , m_targetSyncBarrier(0)
+    , m_lastRequestId(0)
     , m_proxyDynamicSortFilter(false)
     , m_proxyCaseSensitivity(Qt::CaseSensitive)
     , m_proxyKeyColumn(0)
@@ -280,8 +281,9 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
     switch (msg.type()) {
     case Protocol::ModelRowColumnCountReply:
     {
+        Protocol::RequestId requestId;
         quint32 size;
-        msg >> size;
+        msg >> requestId >> size;
         Q_ASSERT(size > 0);
 
         for (quint32 i = 0; i < size; ++i) {
@@ -346,8 +348,9 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
 
     case Protocol::ModelContentReply:
     {
+        Protocol::RequestId requestId;
         quint32 size;
-        msg >> size;
+        msg >> requestId >> size;
         Q_ASSERT(size > 0);
 
         QHash<QModelIndex, QVector<QModelIndex> > dataChangedIndexes;
@@ -402,10 +405,11 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
 
     case Protocol::ModelHeaderReply:
     {
+        Protocol::RequestId requestId;
         qint8 orientation;
         qint32 section;
         QHash<qint32, QVariant> data;
-        msg >> orientation >> section >> data;
+        msg >> requestId >> orientation >> section >> data;
         Q_ASSERT(orientation == Qt::Horizontal || orientation == Qt::Vertical);
         Q_ASSERT(section >= 0);
         auto &headers = orientation == Qt::Horizontal ? m_horizontalHeaders : m_verticalHeaders;
@@ -622,6 +626,46 @@ void RemoteModel::newMessage(const GammaRay::Message &msg)
         break;
     }
 
+    case Protocol::ModelRowsPermuted:
+    {
+        QVector<Protocol::ModelIndex> parents;
+        QVector<QVector<qint32> > moves;
+        QVector<QVector<qint32> > permutations;
+        msg >> parents >> moves >> permutations;
+        Q_ASSERT(parents.size() == moves.size() && parents.size() == permutations.size());
+
+        QVector<Node *> parentNodes;
+        parentNodes.reserve(parents.size());
+        for (const auto &p : qAsConst(parents))
+            parentNodes.push_back(nodeForIndex(p));
+
+        emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+        for (int i = 0; i < parentNodes.size() && i < moves.size() && i < permutations.size(); ++i) {
+            auto node = parentNodes.at(i);
+            if (!node || node->rowCount < 0)
+                continue; // we don't know the parent yet, so we don't care about changes to it either
+
+            QVector<qint32> newRows = permutations.at(i);
+            if (newRows.isEmpty()) {
+                // runs of (old row, new row, count), all other rows stay where they are
+                const auto &runs = moves.at(i);
+                newRows.reserve(node->children.size());
+                for (int row = 0; row < node->children.size(); ++row)
+                    newRows.push_back(row);
+                for (int run = 0; run + 2 < runs.size(); run += 3) {
+                    for (int row = 0; row < runs.at(run + 2); ++row) {
+                        if (runs.at(run) + row >= newRows.size())
+                            break;
+                        newRows[runs.at(run) + row] = runs.at(run + 1) + row;
+                    }
+                }
+            }
+            doPermuteRows(node, newRows);
+        }
+        emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+        break;
+    }
+
     case Protocol::ModelReset:
         clear();
         break;
@@ -761,7 +805,7 @@ void RemoteModel::doRequests() const
         switch (it.key()) {
         case RowColumnCount: {
             Message msg(m_myAddress, Protocol::ModelRowColumnCountRequest);
-            msg << quint32(indexes.size());
+            msg << ++m_lastRequestId << quint32(indexes.size());
             for (const auto &index : indexes)
                 msg << index;
             sendMessage(msg);
@@ -770,7 +814,7 @@ void RemoteModel::doRequests() const
 
         case DataAndFlags: {
             Message msg(m_myAddress, Protocol::ModelContentRequest);
-            msg << quint32(indexes.size());
+            msg << ++m_lastRequestId << quint32(indexes.size());
             for (const auto &index : indexes)
                 msg << index;
             sendMessage(msg);
@@ -791,7 +835,7 @@ void RemoteModel::requestHeaderData(Qt::Orientation orientation, int section) co
     headers[section][Qt::DisplayRole] = s_emptyDisplayValue;
 
     Message msg(m_myAddress, Protocol::ModelHeaderRequest);
-    msg << qint8(orientation) << qint32(section);
+    msg << ++m_lastRequestId << qint8(orientation) << qint32(section);
     sendMessage(msg);
 }
 
@@ -946,6 +990,51 @@ void RemoteModel::doMoveRows(RemoteModel::Node *sourceParentNode, int sourceStar
     resetLoadingState(destParentNode, destEnd);
 }
 
+void RemoteModel::doPermuteRows(RemoteModel::Node *parentNode, const QVector<qint32> &newRows)
+{
+    Q_ASSERT(parentNode->rowCount == parentNode->children.size());
+    bool valid = parentNode->children.size() == newRows.size();
+    QVector<bool> taken(newRows.size(), false);
+    for (int row = 0; valid && row < newRows.size(); ++row) {
+        const int newRow = newRows.at(row);
+        valid = newRow >= 0 && newRow < newRows.size() && !taken.at(newRow);
+        if (valid)
+            taken[newRow] = true;
+    }
+    if (!valid) {
+        // out of sync, refetch this level
+        foreach (const auto &persistentIndex, persistentIndexList()) {
+            auto persistentNode = nodeForIndex(persistentIndex);
+            if (persistentNode && isAncestor(parentNode, persistentNode))
+                changePersistentIndex(persistentIndex, QModelIndex());
+        }
+        parentNode->clearChildrenStructure();
+        return;
+    }
+
+    foreach (const auto &persistentIndex, persistentIndexList()) {
+        auto persistentNode = nodeForIndex(persistentIndex);
+        if (!persistentNode || persistentNode->parent != parentNode)
+            continue;
+        const int newRow = newRows.at(persistentIndex.row());
+        changePersistentIndex(persistentIndex, createIndex(newRow, persistentIndex.column(), persistentNode));
+    }
+
+    QVector<Node *> children(parentNode->children.size(), nullptr);
+    for (int row = 0; row < newRows.size(); ++row) {
+        const int newRow = newRows.at(row);
+        children[newRow] = parentNode->children.at(row);
+        children[newRow]->rowHint = newRow;
+    }
+    parentNode->children = children;
+
+    // vertical headers are positional, refetch them on demand
+    if (parentNode == m_root)
+        m_verticalHeaders.clear();
+
+    resetLoadingState(parentNode, 0);
+}
+
 void RemoteModel::doInsertColumns(RemoteModel::Node *parentNode, int first, int last)
 {
     const auto newColCount = last - first + 1;
@@ -141,6 +141,8 @@ private:
     /// execute a rowsMoved() operation
     void doMoveRows(Node *sourceParentNode, int sourceStart, int sourceEnd, Node *destParentNode,
                     int destStart);
+    /// reorder the children of @p parentNode, moving row i to @p newRows[i]
+    void doPermuteRows(Node *parentNode, const QVector<qint32> &newRows);
 
     /// execute a insertColumns() operation
     void doInsertColumns(Node *parentNode, int first, int last);
@@ -178,6 +180,8 @@ private:
     Protocol::ObjectAddress m_myAddress;
 
     qint32 m_currentSyncBarrier, m_targetSyncBarrier;
+    // echoed in the replies, only used to match them in the message statistics
+    mutable Protocol::RequestId m_lastRequestId;
 
     // default data() values for empty cells
     static QVariant s_emptyDisplayValue;
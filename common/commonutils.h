@@ -39,7 +39,14 @@
 
 namespace GammaRay {
 namespace CommonUtils {
-
+/*!
+ * Mixes @p hash into @p seed, order dependent as in qHashMulti.
+ * Use this to implement qHash() for composite keys.
+ */
+inline uint hashCombine(uint seed, uint hash)
+{
+    return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
 }
 }
 
@@ -224,6 +224,9 @@ void Endpoint::invokeObject(const QString &objectName, const char *method,
         return;
 #endif
 
+    // the receiver might depend on property changes that happened before this call
+    m_propertySyncer->flush();
+
     Message msg(obj->address, Protocol::MethodCall);
     const QByteArray name(method);
     Q_ASSERT(!name.isEmpty());
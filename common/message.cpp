@@ -99,6 +99,7 @@ public:
     void clear()
     {
         data.buffer().resize(0);
+        wireSize = 0;
         resetStatus();
     }
 
@@ -112,6 +113,7 @@ public:
     QBuffer data;
     QByteArray scratchSpace;
     QDataStream stream;
+    int wireSize = 0;
 };
 
 Q_GLOBAL_STATIC_WITH_ARGS(SharedPool<MessageBuffer>, s_sharedMessageBufferPool, (5))
@@ -204,6 +206,7 @@ Message Message::readMessage(QIODevice *device)
         }
     }
 
+    msg.m_buffer->wireSize = payloadSize;
     msg.m_buffer->resetStatus();
 
     return msg;
@@ -245,6 +248,7 @@ void Message::write(QIODevice *device) const
         compress(m_buffer->data.buffer(), compressedData);
 
     const bool isCompressed = compressedData.size() && compressedData.size() < buffSize;
+    m_buffer->wireSize = isCompressed ? compressedData.size() : buffSize;
     if (isCompressed)
         writeNumber<Protocol::PayloadSize>(device, -compressedData.size()); // send compressed Buffer
     else
@@ -266,7 +270,32 @@ void Message::write(QIODevice *device) const
     }
 }
 
+Protocol::RequestId Message::requestId() const
+{
+    const auto &data = m_buffer->data.buffer();
+    if (data.size() < int(sizeof(Protocol::RequestId)))
+        return 0;
+    // QDataStream writes big endian
+    return qFromBigEndian<Protocol::RequestId>(reinterpret_cast<const uchar *>(data.constData()));
+}
+
+bool Message::replyTimestamps(Protocol::Timestamp &received, Protocol::Timestamp &replied) const
+{
+    const auto &data = m_buffer->data.buffer();
+    if (data.size() < int(sizeof(Protocol::RequestId) + 2 * sizeof(Protocol::Timestamp)))
+        return false;
+    const auto trailer = reinterpret_cast<const uchar *>(data.constData()) + data.size() - 2 * sizeof(Protocol::Timestamp);
+    received = qFromBigEndian<Protocol::Timestamp>(trailer);
+    replied = qFromBigEndian<Protocol::Timestamp>(trailer + sizeof(Protocol::Timestamp));
+    return true;
+}
+
 int Message::size() const
 {
     return m_buffer->data.size();
 }
+
+int Message::wireSize() const
+{
+    return m_buffer->wireSize;
+}
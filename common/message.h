@@ -120,8 +120,23 @@ public:
     /** Write this message to @p device. */
     void write(QIODevice *device) const;
 
+    /** The Protocol::RequestId leading the payload of remote model requests and replies,
+     *  read without affecting further reading from or writing to the payload.
+     */
+    Protocol::RequestId requestId() const;
+
+    /** The server receive and reply Protocol::Timestamps trailing the payload of remote model replies,
+     *  read without affecting further reading from the payload.
+     *  @return @c false if the payload is too small to contain them.
+     */
+    bool replyTimestamps(Protocol::Timestamp &received, Protocol::Timestamp &replied) const;
+
     /** Size of the uncompressed message payload. */
     int size() const;
+    /** Size of the message payload as transferred, ie. after compression.
+     *  Only valid for received messages and after write() has been called.
+     */
+    int wireSize() const;
 
 private:
     Message();
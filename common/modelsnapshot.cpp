@@ -0,0 +1,464 @@
+/*
+  modelsnapshot.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "modelsnapshot.h"
+
+#include <QDataStream>
+#include <QHash>
+#include <QIODevice>
+#include <QPointer>
+#include <QQueue>
+#include <QtEndian>
+
+#include <limits>
+
+using namespace GammaRay;
+
+/*
+ * File layout, all fixed size values are little endian:
+ * - header: magic, version, QDataStream encoded column count and horizontal header data
+ * - one QDataStream encoded QVector<QMap<int, QVariant>> per row, in breadth-first order,
+ *   so the children of each row are stored consecutively
+ * - index: one IndexEntrySize record per row, in the same order
+ * - footer: index offset, row count, top-level row count, magic
+ */
+static const quint32 SnapshotMagic = 0x534d5247; // "GRMS"
+static const quint32 SnapshotVersion = 1;
+static const int HeaderSize = 2 * sizeof(quint32);
+static const int IndexEntrySize = sizeof(quint64) + 4 * sizeof(qint32);
+static const int FooterSize = sizeof(quint64) + 2 * sizeof(qint32) + sizeof(quint32);
+static const QDataStream::Version StreamVersion = QDataStream::Qt_5_5;
+
+template<typename T>
+static void appendRaw(QByteArray &buffer, T value)
+{
+    value = qToLittleEndian(value);
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static T readRaw(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+namespace {
+struct WriteState
+{
+    explicit WriteState(QIODevice *device)
+        : device(device)
+        , pos(0)
+    {
+    }
+
+    bool write(const QByteArray &data)
+    {
+        if (device->write(data) != data.size())
+            return false;
+        pos += data.size();
+        return true;
+    }
+
+    bool isStreamable(const QVariant &value)
+    {
+        if (!value.isValid())
+            return false;
+        const int type = value.userType();
+        const auto it = streamableTypes.constFind(type);
+        if (it != streamableTypes.constEnd())
+            return it.value();
+
+        bool streamable = type != QMetaType::QObjectStar && type != QMetaType::VoidStar
+                          && !(QMetaType::typeFlags(type) & QMetaType::PointerToQObject);
+        if (streamable && type >= QMetaType::User) {
+            QByteArray buffer;
+            QDataStream stream(&buffer, QIODevice::WriteOnly);
+            streamable = QMetaType::save(stream, type, value.constData());
+        }
+        streamableTypes.insert(type, streamable);
+        return streamable;
+    }
+
+    QMap<int, QVariant> streamableData(QMap<int, QVariant> data)
+    {
+        for (auto it = data.begin(); it != data.end();) {
+            if (isStreamable(it.value()))
+                ++it;
+            else
+                it = data.erase(it);
+        }
+        return data;
+    }
+
+    QIODevice *device;
+    qint64 pos;
+    QHash<int, bool> streamableTypes;
+};
+
+struct WriteEntry
+{
+    quint64 offset;
+    qint32 parent;
+    qint32 row;
+    qint32 firstChild;
+    qint32 childCount;
+};
+}
+
+namespace GammaRay {
+class ModelSnapshotWriterPrivate
+{
+public:
+    ModelSnapshotWriterPrivate(const QAbstractItemModel *model, QIODevice *device)
+        : model(model)
+        , state(device)
+    {
+        // pending rows are plain indexes, structural changes in between invalidate them
+        const auto invalidate = [this]() { structureChanged = true; };
+        connections = {
+            QObject::connect(model, &QAbstractItemModel::rowsAboutToBeInserted, invalidate),
+            QObject::connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, invalidate),
+            QObject::connect(model, &QAbstractItemModel::rowsAboutToBeMoved, invalidate),
+            QObject::connect(model, &QAbstractItemModel::columnsAboutToBeInserted, invalidate),
+            QObject::connect(model, &QAbstractItemModel::columnsAboutToBeRemoved, invalidate),
+            QObject::connect(model, &QAbstractItemModel::columnsAboutToBeMoved, invalidate),
+            QObject::connect(model, &QAbstractItemModel::layoutAboutToBeChanged, invalidate),
+            QObject::connect(model, &QAbstractItemModel::modelAboutToBeReset, invalidate)
+        };
+    }
+
+    ~ModelSnapshotWriterPrivate()
+    {
+        for (const auto &connection : qAsConst(connections))
+            QObject::disconnect(connection);
+    }
+
+    bool writeHeader();
+    bool writeRow();
+    bool writeIndex();
+
+    QPointer<const QAbstractItemModel> model;
+    WriteState state;
+    QVector<WriteEntry> entries;
+    QVector<QMetaObject::Connection> connections;
+    // breadth-first, children get consecutive node ids when their parent is written
+    QQueue<QModelIndex> pending;
+    qint32 node = 0;
+    qint32 rootChildCount = 0;
+    bool headerWritten = false;
+    bool finished = false;
+    bool structureChanged = false;
+};
+}
+
+bool ModelSnapshotWriterPrivate::writeHeader()
+{
+    QByteArray buffer;
+    appendRaw(buffer, SnapshotMagic);
+    appendRaw(buffer, SnapshotVersion);
+    {
+        const int columnCount = model->columnCount();
+        QVector<QMap<int, QVariant> > headerData;
+        headerData.reserve(columnCount);
+        for (int section = 0; section < columnCount; ++section) {
+            QMap<int, QVariant> sectionData;
+            for (int role : { int(Qt::DisplayRole), int(Qt::ToolTipRole) })
+                sectionData.insert(role, model->headerData(section, Qt::Horizontal, role));
+            headerData.push_back(state.streamableData(sectionData));
+        }
+        QDataStream stream(&buffer, QIODevice::WriteOnly | QIODevice::Append);
+        stream.setVersion(StreamVersion);
+        stream << qint32(columnCount) << headerData;
+    }
+
+    rootChildCount = model->rowCount();
+    for (int row = 0; row < rootChildCount; ++row) {
+        entries.push_back({ 0, -1, row, -1, 0 });
+        pending.enqueue(model->index(row, 0));
+    }
+    headerWritten = true;
+    return state.write(buffer);
+}
+
+bool ModelSnapshotWriterPrivate::writeRow()
+{
+    const QModelIndex index = pending.dequeue();
+    entries[node].offset = state.pos;
+
+    QVector<QMap<int, QVariant> > rowData;
+    const int columnCount = model->columnCount(index.parent());
+    rowData.reserve(columnCount);
+    for (int column = 0; column < columnCount; ++column)
+        rowData.push_back(state.streamableData(model->itemData(index.sibling(index.row(), column))));
+
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(StreamVersion);
+    stream << rowData;
+    if (!state.write(buffer))
+        return false;
+
+    const int childCount = model->rowCount(index);
+    if (childCount > 0) {
+        entries[node].firstChild = entries.size();
+        entries[node].childCount = childCount;
+        for (int row = 0; row < childCount; ++row) {
+            entries.push_back({ 0, node, row, -1, 0 });
+            pending.enqueue(model->index(row, 0, index));
+        }
+    }
+    ++node;
+    return true;
+}
+
+bool ModelSnapshotWriterPrivate::writeIndex()
+{
+    const quint64 indexOffset = state.pos;
+    QByteArray buffer;
+    buffer.reserve(entries.size() * IndexEntrySize + FooterSize);
+    for (const auto &entry : qAsConst(entries)) {
+        appendRaw(buffer, entry.offset);
+        appendRaw(buffer, entry.parent);
+        appendRaw(buffer, entry.row);
+        appendRaw(buffer, entry.firstChild);
+        appendRaw(buffer, entry.childCount);
+    }
+    appendRaw(buffer, indexOffset);
+    appendRaw(buffer, qint32(entries.size()));
+    appendRaw(buffer, qint32(rootChildCount));
+    appendRaw(buffer, SnapshotMagic);
+    finished = true;
+    return state.write(buffer);
+}
+
+ModelSnapshotWriter::ModelSnapshotWriter(const QAbstractItemModel *model, QIODevice *device)
+    : d(new ModelSnapshotWriterPrivate(model, device))
+{
+    Q_ASSERT(model);
+    Q_ASSERT(device);
+}
+
+ModelSnapshotWriter::~ModelSnapshotWriter() = default;
+
+bool ModelSnapshotWriter::writeRows(int maxRows)
+{
+    if (d->finished)
+        return true;
+    if (!d->model || d->structureChanged)
+        return false;
+    if (!d->headerWritten && !d->writeHeader())
+        return false;
+
+    for (int i = 0; i < maxRows && !d->pending.isEmpty(); ++i) {
+        if (!d->writeRow())
+            return false;
+    }
+    if (d->pending.isEmpty())
+        return d->writeIndex();
+    return true;
+}
+
+bool ModelSnapshotWriter::isFinished() const
+{
+    return d->finished;
+}
+
+bool ModelSnapshot::write(const QAbstractItemModel *model, QIODevice *device)
+{
+    ModelSnapshotWriter writer(model, device);
+    while (!writer.isFinished()) {
+        if (!writer.writeRows(std::numeric_limits<int>::max()))
+            return false;
+    }
+    return true;
+}
+
+ModelSnapshotModel::ModelSnapshotModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_indexOffset(0)
+    , m_nodeCount(0)
+    , m_rootChildCount(0)
+    , m_columnCount(0)
+    , m_rowCache(256)
+{
+}
+
+ModelSnapshotModel::~ModelSnapshotModel() = default;
+
+void ModelSnapshotModel::clear()
+{
+    m_rowCache.clear();
+    m_headerData.clear();
+    if (m_data)
+        m_file.unmap(const_cast<uchar *>(m_data));
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_indexOffset = 0;
+    m_nodeCount = 0;
+    m_rootChildCount = 0;
+    m_columnCount = 0;
+}
+
+bool ModelSnapshotModel::load(const QString &fileName)
+{
+    beginResetModel();
+    clear();
+
+    bool valid = false;
+    m_file.setFileName(fileName);
+    if (m_file.open(QIODevice::ReadOnly) && m_file.size() >= HeaderSize + FooterSize) {
+        m_size = m_file.size();
+        m_data = m_file.map(0, m_size);
+    }
+
+    if (m_data
+        && readRaw<quint32>(m_data) == SnapshotMagic
+        && readRaw<quint32>(m_data + sizeof(quint32)) == SnapshotVersion
+        && readRaw<quint32>(m_data + m_size - sizeof(quint32)) == SnapshotMagic) {
+        const uchar *footer = m_data + m_size - FooterSize;
+        m_indexOffset = readRaw<quint64>(footer);
+        m_nodeCount = readRaw<qint32>(footer + sizeof(quint64));
+        m_rootChildCount = readRaw<qint32>(footer + sizeof(quint64) + sizeof(qint32));
+        valid = m_nodeCount >= 0 && m_rootChildCount >= 0 && m_rootChildCount <= m_nodeCount
+                && m_indexOffset >= quint64(HeaderSize)
+                && m_indexOffset + quint64(m_nodeCount) * IndexEntrySize + FooterSize == quint64(m_size);
+    }
+
+    if (valid) {
+        const quint64 headerEnd = m_nodeCount > 0 ? entry(0).offset : m_indexOffset;
+        valid = headerEnd >= quint64(HeaderSize) && headerEnd <= m_indexOffset;
+        if (valid) {
+            const QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data) + HeaderSize,
+                                                              headerEnd - HeaderSize);
+            QDataStream stream(buffer);
+            stream.setVersion(StreamVersion);
+            qint32 columnCount = 0;
+            stream >> columnCount >> m_headerData;
+            m_columnCount = columnCount;
+            valid = stream.status() == QDataStream::Ok && columnCount >= 0;
+        }
+    }
+
+    if (!valid)
+        clear();
+    endResetModel();
+    return valid;
+}
+
+ModelSnapshotModel::IndexEntry ModelSnapshotModel::entry(qint32 node) const
+{
+    Q_ASSERT(node >= 0 && node < m_nodeCount);
+    const uchar *data = m_data + m_indexOffset + quint64(node) * IndexEntrySize;
+    IndexEntry e;
+    e.offset = readRaw<quint64>(data);
+    data += sizeof(quint64);
+    e.parent = readRaw<qint32>(data);
+    e.row = readRaw<qint32>(data + sizeof(qint32));
+    e.firstChild = readRaw<qint32>(data + 2 * sizeof(qint32));
+    e.childCount = readRaw<qint32>(data + 3 * sizeof(qint32));
+    return e;
+}
+
+const ModelSnapshotModel::RowData *ModelSnapshotModel::rowData(qint32 node) const
+{
+    if (auto cached = m_rowCache.object(node))
+        return cached;
+
+    const quint64 begin = entry(node).offset;
+    const quint64 end = node + 1 < m_nodeCount ? entry(node + 1).offset : m_indexOffset;
+    auto data = new RowData;
+    if (begin <= end && end <= m_indexOffset) {
+        const QByteArray buffer = QByteArray::fromRawData(reinterpret_cast<const char *>(m_data) + begin,
+                                                          end - begin);
+        QDataStream stream(buffer);
+        stream.setVersion(StreamVersion);
+        stream >> *data;
+    }
+    m_rowCache.insert(node, data);
+    return data;
+}
+
+int ModelSnapshotModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+    if (!parent.isValid())
+        return m_rootChildCount;
+    return qMax(0, entry(qint32(parent.internalId())).childCount);
+}
+
+int ModelSnapshotModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return m_columnCount;
+}
+
+QModelIndex ModelSnapshotModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    const qint32 firstChild = parent.isValid() ? entry(qint32(parent.internalId())).firstChild : 0;
+    const qint32 node = firstChild + row;
+    if (firstChild < 0 || node >= m_nodeCount)
+        return QModelIndex();
+    return createIndex(row, column, quintptr(node));
+}
+
+QModelIndex ModelSnapshotModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+    const qint32 parentNode = entry(qint32(child.internalId())).parent;
+    if (parentNode < 0 || parentNode >= m_nodeCount)
+        return QModelIndex();
+    return createIndex(entry(parentNode).row, 0, quintptr(parentNode));
+}
+
+QVariant ModelSnapshotModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+    return rowData(qint32(index.internalId()))->value(index.column()).value(role);
+}
+
+QMap<int, QVariant> ModelSnapshotModel::itemData(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QMap<int, QVariant>();
+    return rowData(qint32(index.internalId()))->value(index.column());
+}
+
+QVariant ModelSnapshotModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal)
+        return m_headerData.value(section).value(role);
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
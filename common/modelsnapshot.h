@@ -0,0 +1,136 @@
+/*
+  modelsnapshot.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef GAMMARAY_MODELSNAPSHOT_H
+#define GAMMARAY_MODELSNAPSHOT_H
+
+#include "gammaray_common_export.h"
+
+#include <QAbstractItemModel>
+#include <QCache>
+#include <QFile>
+#include <QVector>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+namespace ModelSnapshot {
+/**
+ * Writes the content of @p model to @p device in the binary model snapshot format.
+ *
+ * Rows are serialized one at a time while traversing the model, only a small
+ * fixed-size index entry per row is kept in memory until the end. Values that
+ * cannot be streamed (e.g. object pointers) are skipped.
+ * The result can be loaded with ModelSnapshotModel.
+ */
+GAMMARAY_COMMON_EXPORT bool write(const QAbstractItemModel *model, QIODevice *device);
+}
+
+class ModelSnapshotWriterPrivate;
+
+/**
+ * Incremental version of ModelSnapshot::write(), for exporting large models
+ * in steps without blocking the event loop in between.
+ *
+ * Pending rows are kept as plain model indexes, so the export fails if the
+ * structure of the model changes while the writer is paused.
+ */
+class GAMMARAY_COMMON_EXPORT ModelSnapshotWriter
+{
+public:
+    ModelSnapshotWriter(const QAbstractItemModel *model, QIODevice *device);
+    ~ModelSnapshotWriter();
+
+    /// Writes up to @p maxRows rows, and the index once all rows are written.
+    /// Returns @c false on write errors, if the model has been destroyed, or if its
+    /// structure changed since the previous call.
+    bool writeRows(int maxRows);
+    /// Returns @c true once the complete snapshot has been written.
+    bool isFinished() const;
+
+private:
+    Q_DISABLE_COPY(ModelSnapshotWriter)
+    std::unique_ptr<ModelSnapshotWriterPrivate> d;
+};
+
+/**
+ * Read-only model providing the content of a file written by ModelSnapshot::write().
+ *
+ * The file is memory-mapped, the tree structure is read directly from the mapped
+ * index, and item data is only decoded when accessed. This allows random access
+ * to snapshots that are much larger than what would be sensible to load at once.
+ */
+class GAMMARAY_COMMON_EXPORT ModelSnapshotModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    explicit ModelSnapshotModel(QObject *parent = nullptr);
+    ~ModelSnapshotModel() override;
+
+    /// Loads the snapshot in @p fileName, returns @c false if that is not a valid snapshot.
+    bool load(const QString &fileName);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    typedef QVector<QMap<int, QVariant> > RowData;
+    struct IndexEntry {
+        quint64 offset;
+        qint32 parent;
+        qint32 row;
+        qint32 firstChild;
+        qint32 childCount;
+    };
+
+    void clear();
+    IndexEntry entry(qint32 node) const;
+    const RowData *rowData(qint32 node) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    quint64 m_indexOffset;
+    qint32 m_nodeCount;
+    qint32 m_rootChildCount;
+    int m_columnCount;
+    RowData m_headerData;
+    mutable QCache<qint32, RowData> m_rowCache;
+};
+}
+
+#endif // GAMMARAY_MODELSNAPSHOT_H
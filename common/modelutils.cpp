@@ -27,8 +27,9 @@
 */
 
 #include "modelutils.h"
+#include "objectmodel.h"
 
-#include <QAbstractItemModel>
+#include <QAbstractProxyModel>
 
 using namespace GammaRay;
 
@@ -73,3 +74,44 @@ QModelIndexList ModelUtils::match(const QModelIndex &start, int role, MatchAccep
 
     return result;
 }
+
+// find the model providing an indexForObject method at the bottom of a proxy chain
+static bool hasObjectLookup(const QAbstractItemModel *model)
+{
+    if (!model)
+        return false;
+    if (model->metaObject()->indexOfMethod(QMetaObject::normalizedSignature(
+                                               "indexForObject(QObject*)")) != -1)
+        return true;
+    if (auto proxy = qobject_cast<const QAbstractProxyModel *>(model))
+        return hasObjectLookup(proxy->sourceModel());
+    return false;
+}
+
+static QModelIndex lookupIndex(const QAbstractItemModel *model, QObject *object)
+{
+    if (auto proxy = qobject_cast<const QAbstractProxyModel *>(model)) {
+        if (model->metaObject()->indexOfMethod(QMetaObject::normalizedSignature(
+                                                   "indexForObject(QObject*)")) == -1)
+            return proxy->mapFromSource(lookupIndex(proxy->sourceModel(), object));
+    }
+
+    QModelIndex index;
+    QMetaObject::invokeMethod(const_cast<QAbstractItemModel *>(model), "indexForObject",
+                              Qt::DirectConnection, Q_RETURN_ARG(QModelIndex, index),
+                              Q_ARG(QObject *, object));
+    return index;
+}
+
+QModelIndex ModelUtils::indexForObject(const QAbstractItemModel *model, QObject *object)
+{
+    if (!model || !object)
+        return QModelIndex();
+
+    if (hasObjectLookup(model))
+        return lookupIndex(model, object);
+
+    return model->match(model->index(0, 0), ObjectModel::ObjectRole,
+                        QVariant::fromValue(object), 1,
+                        Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap).value(0);
+}
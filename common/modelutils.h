@@ -33,6 +33,11 @@
 
 #include <QModelIndex>
 
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+class QObject;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 namespace ModelUtils {
 
@@ -52,6 +57,16 @@ typedef bool (*MatchAcceptor)(const QVariant &);
 GAMMARAY_COMMON_EXPORT QModelIndexList match(const QModelIndex &start, int role,
                                              MatchAcceptor accept, int hits = 1,
                                              Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchWrap));
+
+/**
+ * Returns the index of @p object in @p model, or an invalid index if @p object isn't in the model.
+ *
+ * Models knowing the row of their objects can make this a constant time lookup by providing
+ * a method with the signature "Q_INVOKABLE QModelIndex indexForObject(QObject*) const".
+ * Proxy models on top of such a model are resolved via QAbstractProxyModel::mapFromSource().
+ * Otherwise this falls back to a recursive search for @p object in ObjectModel::ObjectRole.
+ */
+GAMMARAY_COMMON_EXPORT QModelIndex indexForObject(const QAbstractItemModel *model, QObject *object);
 }
 }
 
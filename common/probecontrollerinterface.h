@@ -51,6 +51,23 @@ public:
     /*! Detach GammaRay but keep host application running. */
     virtual void detachProbe() = 0;
 
+    /*! Export the registered model @p modelName as a model snapshot to
+     *  @p targetFilePath on the client side, see ModelSnapshot.
+     *  The data is delivered in chunks via modelSnapshotData().
+     */
+    virtual void requestModelSnapshot(const QString &modelName, const QString &targetFilePath) = 0;
+
+    /*! Abort a snapshot export started by requestModelSnapshot(). */
+    virtual void cancelModelSnapshot(const QString &targetFilePath) = 0;
+
+signals:
+    /*! The next part of a model snapshot, @p offset is the position of @p data
+     *  in the target file. An empty and finished chunk at offset -1 indicates
+     *  that the export failed.
+     */
+    void modelSnapshotData(const QString &targetFilePath, const QByteArray &data,
+                           qint64 offset, bool finished);
+
 private:
     Q_DISABLE_COPY(ProbeControllerInterface)
 };
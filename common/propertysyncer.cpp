@@ -33,8 +33,7 @@
 
 #include <QDebug>
 #include <QMetaProperty>
-
-#include <algorithm>
+#include <QTimer>
 
 using namespace GammaRay;
 
@@ -45,9 +44,13 @@ static int qobjectPropertyOffset()
 
 PropertySyncer::PropertySyncer(QObject *parent)
     : QObject(parent)
+    , m_flushTimer(new QTimer(this))
     , m_address(Protocol::InvalidObjectAddress)
     , m_initialSync(false)
 {
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, &QTimer::timeout, this, &PropertySyncer::flush);
 }
 
 PropertySyncer::~PropertySyncer() = default;
@@ -57,40 +60,51 @@ void PropertySyncer::setRequestInitialSync(bool initialSync)
     m_initialSync = initialSync;
 }
 
+const PropertySyncer::NotifyTable &PropertySyncer::notifyTable(const QMetaObject *mo)
+{
+    auto it = m_notifyTables.find(mo);
+    if (it != m_notifyTables.end())
+        return it.value();
+
+    NotifyTable table;
+    for (int i = qobjectPropertyOffset(); i < mo->propertyCount(); ++i) {
+        const auto prop = mo->property(i);
+        if (prop.hasNotifySignal())
+            table[prop.notifySignalIndex()].push_back(i);
+    }
+    return m_notifyTables.insert(mo, table).value();
+}
+
 void PropertySyncer::addObject(Protocol::ObjectAddress addr, QObject *obj)
 {
     Q_ASSERT(addr != Protocol::InvalidObjectAddress);
     Q_ASSERT(obj);
-    if (qobjectPropertyOffset() == obj->metaObject()->propertyCount())
+    const auto mo = obj->metaObject();
+    if (qobjectPropertyOffset() == mo->propertyCount())
         return; // no properties we could sync
 
-    for (int i = qobjectPropertyOffset(); i < obj->metaObject()->propertyCount(); ++i) {
-        const auto prop = obj->metaObject()->property(i);
-        if (!prop.hasNotifySignal())
-            continue;
-        connect(obj, QByteArray("2") + prop.notifySignal().methodSignature(), this, SLOT(propertyChanged()));
-    }
+    const auto &table = notifyTable(mo);
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it)
+        connect(obj, QByteArray("2") + mo->method(it.key()).methodSignature(), this, SLOT(propertyChanged()));
 
     connect(obj, &QObject::destroyed, this, &PropertySyncer::objectDestroyed);
 
     ObjectInfo info;
-    info.addr = addr;
     info.obj = obj;
     info.recursionLock = false;
     info.enabled = false;
-    m_objects.push_back(info);
+    m_objects.insert(addr, info);
+    m_objectAddresses.insert(obj, addr);
 }
 
 void PropertySyncer::setObjectEnabled(Protocol::ObjectAddress addr, bool enabled)
 {
-    const auto it = std::find_if(m_objects.begin(), m_objects.end(), [addr](
-                                     const ObjectInfo &info) {
-        return info.addr == addr;
-    });
+    const auto it = m_objects.find(addr);
     if (it == m_objects.end() || (*it).enabled == enabled)
         return;
 
     (*it).enabled = enabled;
+    (*it).pendingProperties.clear();
     if (enabled && m_initialSync) {
         Message msg(m_address, Protocol::PropertySyncRequest);
         msg << addr;
@@ -118,20 +132,20 @@ void PropertySyncer::handleMessage(const GammaRay::Message &msg)
         msg >> addr;
         Q_ASSERT(addr != Protocol::InvalidObjectAddress);
 
-        const auto it
-            = std::find_if(m_objects.constBegin(), m_objects.constEnd(),
-                           [addr](const ObjectInfo &info) {
-                return info.addr == addr;
-            });
-        if (it == m_objects.constEnd())
+        const auto it = m_objects.find(addr);
+        if (it == m_objects.end())
             break;
 
+        // a full sync supersedes anything we had queued for this object
+        (*it).pendingProperties.clear();
+
+        const auto obj = (*it).obj;
         QVector<QPair<QByteArray, QVariant> > values;
-        const auto propCount = (*it).obj->metaObject()->propertyCount();
+        const auto propCount = obj->metaObject()->propertyCount();
         values.reserve(propCount);
         for (int i = qobjectPropertyOffset(); i < propCount; ++i) {
-            const auto prop = (*it).obj->metaObject()->property(i);
-            values.push_back(qMakePair(QByteArray(prop.name()), prop.read((*it).obj)));
+            const auto prop = obj->metaObject()->property(i);
+            values.push_back(qMakePair(QByteArray(prop.name()), prop.read(obj)));
         }
         Q_ASSERT(!values.isEmpty());
 
@@ -150,9 +164,7 @@ void PropertySyncer::handleMessage(const GammaRay::Message &msg)
         Q_ASSERT(addr != Protocol::InvalidObjectAddress);
         Q_ASSERT(changeSize > 0);
 
-        auto it = std::find_if(m_objects.begin(), m_objects.end(), [addr](const ObjectInfo &info) {
-                return info.addr == addr;
-            });
+        auto it = m_objects.find(addr);
         if (it == m_objects.end())
             break;
 
@@ -160,13 +172,17 @@ void PropertySyncer::handleMessage(const GammaRay::Message &msg)
             QByteArray propName;
             QVariant propValue;
             msg >> propName >> propValue;
+
+            // the remote value wins over a local change we haven't sent yet
+            auto &pending = (*it).pendingProperties;
+            if (!pending.isEmpty())
+                pending.removeOne((*it).obj->metaObject()->indexOfProperty(propName));
+
             (*it).recursionLock = true;
             (*it).obj->setProperty(propName, propValue);
 
             // it can be invalid if as a result of the above call new objects have been registered for example
-            it = std::find_if(m_objects.begin(), m_objects.end(), [addr](const ObjectInfo &info) {
-                    return info.addr == addr;
-                });
+            it = m_objects.find(addr);
             Q_ASSERT(it != m_objects.end());
             (*it).recursionLock = false;
         }
@@ -178,41 +194,62 @@ void PropertySyncer::handleMessage(const GammaRay::Message &msg)
     }
 }
 
+void PropertySyncer::flush()
+{
+    m_flushTimer->stop();
+
+    QVector<Protocol::ObjectAddress> objects;
+    objects.swap(m_pendingObjects);
+    for (const auto addr : qAsConst(objects)) {
+        const auto it = m_objects.find(addr);
+        if (it == m_objects.end() || (*it).pendingProperties.isEmpty())
+            continue; // destroyed, disabled or fully synced in the meantime
+
+        QVector<int> properties;
+        properties.swap((*it).pendingProperties);
+        const auto obj = (*it).obj;
+
+        Message msg(m_address, Protocol::PropertyValuesChanged);
+        msg << addr << (quint32)properties.size();
+        for (const auto propIdx : qAsConst(properties)) {
+            const auto prop = obj->metaObject()->property(propIdx);
+            msg << QByteArray(prop.name()) << prop.read(obj);
+        }
+        emit message(msg);
+    }
+}
+
 void PropertySyncer::propertyChanged()
 {
-    const auto *obj = sender();
+    auto *obj = sender();
     Q_ASSERT(obj);
-    const auto it
-        = std::find_if(m_objects.constBegin(), m_objects.constEnd(), [obj](const ObjectInfo &info) {
-        return info.obj == obj;
-    });
-    Q_ASSERT(it != m_objects.constEnd());
+    const auto it = m_objects.find(m_objectAddresses.value(obj, Protocol::InvalidObjectAddress));
+    Q_ASSERT(it != m_objects.end());
 
     if ((*it).recursionLock || !(*it).enabled)
         return;
 
-    const auto sigIndex = senderSignalIndex();
-    QVector<QPair<QByteArray, QVariant> > changes;
-    for (int i = qobjectPropertyOffset(); i < obj->metaObject()->propertyCount(); ++i) {
-        const auto prop = obj->metaObject()->property(i);
-        if (prop.notifySignalIndex() != sigIndex)
-            continue;
-        changes.push_back(qMakePair(QByteArray(prop.name()), prop.read(obj)));
+    const auto &properties = notifyTable(obj->metaObject()).value(senderSignalIndex());
+    Q_ASSERT(!properties.isEmpty());
+
+    auto &pending = (*it).pendingProperties;
+    if (pending.isEmpty())
+        m_pendingObjects.push_back(it.key());
+    for (const auto propIdx : properties) {
+        if (!pending.contains(propIdx))
+            pending.push_back(propIdx);
     }
-    Q_ASSERT(!changes.isEmpty());
 
-    Message msg(m_address, Protocol::PropertyValuesChanged);
-    msg << (*it).addr << (quint32)changes.size();
-    for (const auto &change : qAsConst(changes))
-        msg << change.first << change.second;
-    emit message(msg);
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
 }
 
 void PropertySyncer::objectDestroyed(QObject *obj)
 {
-    const auto it = std::find_if(m_objects.begin(), m_objects.end(), [obj](const ObjectInfo &info) {
-        return info.obj == obj;
-    });
-    Q_ASSERT(it != m_objects.end());
-    m_objects.erase(it);
+    const auto addrIt = m_objectAddresses.find(obj);
+    Q_ASSERT(addrIt != m_objectAddresses.end());
+    const auto it = m_objects.find(addrIt.value());
+    if (it != m_objects.end() && (*it).obj == obj)
+        m_objects.erase(it);
+    m_objectAddresses.erase(addrIt);
 }
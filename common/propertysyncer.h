@@ -33,13 +33,21 @@
 
 #include <common/protocol.h>
 
+#include <QHash>
 #include <QObject>
 #include <QVector>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 class Message;
 
-/** Infrastructure for syncing property values between a local and a remote object. */
+/** Infrastructure for syncing property values between a local and a remote object.
+ *  Property changes are coalesced per object and sent once per event loop pass,
+ *  carrying the latest value of each changed property.
+ */
 class GAMMARAY_COMMON_EXPORT PropertySyncer : public QObject
 {
     Q_OBJECT
@@ -69,6 +77,11 @@ public slots:
     /** Feed in incoming network messages here. */
     void handleMessage(const GammaRay::Message &msg);
 
+    /** Send all pending property changes immediately.
+     *  Use this before sending messages that need to be ordered after property changes.
+     */
+    void flush();
+
 signals:
     /** Outgoing network messages, send those via Endpoint. */
     void message(const GammaRay::Message &msg);
@@ -78,13 +91,21 @@ private slots:
     void objectDestroyed(QObject *obj);
 
 private:
+    /// signal index -> indexes of the properties it notifies about
+    typedef QHash<int, QVector<int> > NotifyTable;
+    const NotifyTable &notifyTable(const QMetaObject *mo);
+
     struct ObjectInfo {
-        Protocol::ObjectAddress addr;
         QObject *obj;
+        QVector<int> pendingProperties;
         bool recursionLock;
         bool enabled;
     };
-    QVector<ObjectInfo> m_objects;
+    QHash<Protocol::ObjectAddress, ObjectInfo> m_objects;
+    QHash<QObject *, Protocol::ObjectAddress> m_objectAddresses;
+    QHash<const QMetaObject *, NotifyTable> m_notifyTables;
+    QVector<Protocol::ObjectAddress> m_pendingObjects;
+    QTimer *m_flushTimer;
     Protocol::ObjectAddress m_address;
     bool m_initialSync;
 };
@@ -54,7 +54,7 @@ QModelIndex toQModelIndex(const QAbstractItemModel *model, const Protocol::Model
 
 qint32 version()
 {
-    return 36;
+    return 40;
 }
 
 qint32 broadcastFormatVersion()
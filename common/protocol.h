@@ -48,6 +48,11 @@ using PayloadSize = qint32;
 using ObjectAddress = quint16;
 /*! Message type type. */
 using MessageType = quint8;
+/*! Remote model request id type, it leads the payload of a request and of its reply. */
+using RequestId = quint32;
+/*! Server side timestamp in microseconds of a monotonic clock. Remote model replies end with
+ *  the time the server received the request and the time it sent the reply. */
+using Timestamp = quint64;
 
 /*! Invalid object address. */
 static const ObjectAddress InvalidObjectAddress = 0;
@@ -96,6 +101,7 @@ enum BuildInMessageType {
     ModelColumnsRemoved,
     ModelReset,
     ModelLayoutChanged,
+    ModelRowsPermuted,
 
     // server <-> client
     SelectionModelSelect,
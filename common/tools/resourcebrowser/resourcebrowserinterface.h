@@ -42,12 +42,18 @@ public:
 public slots:
     virtual void downloadResource(const QString &sourceFilePath, const QString &targetFilePath) = 0;
     virtual void selectResource(const QString &sourceFilePath, int line = -1, int column = -1) = 0;
+    virtual void cancelDownload(const QString &targetFilePath) = 0;
 
 signals:
     void resourceDeselected();
     void resourceSelected(const QByteArray &contents, int line, int column);
 
-    void resourceDownloaded(const QString &targetFilePath, const QByteArray &contents);
+    /**
+     * Downloads are transferred in chunks, @p offset is the position of @p contents
+     * in the resource, @p finished is set for the last chunk.
+     */
+    void resourceDownloaded(const QString &targetFilePath, const QByteArray &contents,
+                            qint64 offset, bool finished);
 };
 }
 
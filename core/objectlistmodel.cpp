@@ -54,6 +54,14 @@ QPair<int, QVariant> ObjectListModel::defaultSelectedItem() const
     return QPair<int, QVariant>(ObjectModel::ObjectRole, QVariant::fromValue<QObject *>(qApp));
 }
 
+QModelIndex ObjectListModel::indexForObject(QObject *object) const
+{
+    const auto it = std::lower_bound(m_objects.constBegin(), m_objects.constEnd(), object);
+    if (it == m_objects.constEnd() || *it != object)
+        return QModelIndex();
+    return index(std::distance(m_objects.constBegin(), it), 0);
+}
+
 QVariant ObjectListModel::data(const QModelIndex &index, int role) const
 {
     QMutexLocker lock(Probe::objectLock());
@@ -59,6 +59,7 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
     Q_INVOKABLE QPair<int, QVariant> defaultSelectedItem() const;
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
 
     /*!
      * Returns a list of all objects.
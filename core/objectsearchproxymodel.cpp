@@ -0,0 +1,261 @@
+/*
+  objectsearchproxymodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "objectsearchproxymodel.h"
+#include "objectdataprovider.h"
+#include "probe.h"
+#include "util.h"
+
+#include <common/objectmodel.h>
+
+#include <QMutexLocker>
+
+using namespace GammaRay;
+
+ObjectSearchProxyModel::ObjectSearchProxyModel(QObject *parent)
+    : KRecursiveFilterProxyModel(parent)
+{
+    if (Probe::isInitialized())
+        connect(Probe::instance(), &Probe::objectDestroyed, this, &ObjectSearchProxyModel::objectDestroyed);
+}
+
+ObjectSearchProxyModel::~ObjectSearchProxyModel() = default;
+
+void ObjectSearchProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const auto &connection : qAsConst(m_sourceConnections))
+        disconnect(connection);
+    m_sourceConnections.clear();
+    clearIndex();
+
+    // connect before the base class does, so the index is up to date once
+    // the filter is re-evaluated for changed rows
+    if (sourceModel) {
+        m_sourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::dataChanged,
+                                              this, &ObjectSearchProxyModel::sourceDataChanged));
+        m_sourceConnections.push_back(connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset,
+                                              this, &ObjectSearchProxyModel::clearIndex));
+    }
+
+    KRecursiveFilterProxyModel::setSourceModel(sourceModel);
+}
+
+bool ObjectSearchProxyModel::canUseIndex() const
+{
+    const QRegExp &regExp = filterRegExp();
+    return filterKeyColumn() == -1
+           && regExp.patternSyntax() == QRegExp::FixedString
+           && regExp.caseSensitivity() == Qt::CaseInsensitive;
+}
+
+bool ObjectSearchProxyModel::acceptRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (filterRegExp().isEmpty() || !canUseIndex())
+        return KRecursiveFilterProxyModel::acceptRow(sourceRow, sourceParent);
+    if (m_pattern != filterRegExp().pattern())
+        updatePattern();
+
+    const QModelIndex sourceIndex = sourceModel()->index(sourceRow, 0, sourceParent);
+    QObject *object = sourceIndex.data(ObjectModel::ObjectRole).value<QObject *>();
+    if (!object)
+        return KRecursiveFilterProxyModel::acceptRow(sourceRow, sourceParent);
+
+    QMutexLocker lock(Probe::objectLock());
+    if (!Probe::instance()->isValidObject(object)) {
+        removeEntry(object);
+        return false;
+    }
+
+    const int id = entryId(object, sourceRow, sourceParent);
+    if (m_matchesValid)
+        return m_matches.contains(id);
+    return m_entries.at(id).text.contains(m_foldedPattern);
+}
+
+void ObjectSearchProxyModel::updatePattern() const
+{
+    const QString previousPattern = m_foldedPattern;
+    const bool previousMatchesValid = m_matchesValid;
+    m_pattern = filterRegExp().pattern();
+    m_foldedPattern = m_pattern.toCaseFolded();
+
+    // extending the pattern only ever removes matches
+    if (previousMatchesValid && m_foldedPattern.contains(previousPattern)) {
+        for (auto it = m_matches.begin(); it != m_matches.end();) {
+            if (m_entries.at(*it).text.contains(m_foldedPattern))
+                ++it;
+            else
+                it = m_matches.erase(it);
+        }
+        return;
+    }
+
+    m_matches.clear();
+    m_matchesValid = m_foldedPattern.size() >= 3;
+    if (!m_matchesValid)
+        return;
+
+    // every match contains all trigrams of the pattern, the rarest one
+    // yields the fewest candidates to check
+    const QVector<int> *candidates = nullptr;
+    for (int i = 0; i + 3 <= m_foldedPattern.size(); ++i) {
+        const quint64 trigram = (quint64(m_foldedPattern.at(i).unicode()) << 32)
+                                | (quint64(m_foldedPattern.at(i + 1).unicode()) << 16)
+                                | m_foldedPattern.at(i + 2).unicode();
+        const auto it = m_trigrams.constFind(trigram);
+        if (it == m_trigrams.constEnd())
+            return;
+        if (!candidates || it->size() < candidates->size())
+            candidates = &it.value();
+    }
+
+    for (int id : *candidates) {
+        const SearchEntry &entry = m_entries.at(id);
+        if (entry.object && entry.text.contains(m_foldedPattern))
+            m_matches.insert(id);
+    }
+}
+
+int ObjectSearchProxyModel::entryId(QObject *object, int sourceRow,
+                                    const QModelIndex &sourceParent) const
+{
+    // object models don't notify about name changes, and addresses get
+    // reused, so validate the entry against what it was built from
+    const QString name = ObjectDataProvider::name(object);
+    const auto it = m_entryIds.constFind(object);
+    if (it != m_entryIds.constEnd()) {
+        const SearchEntry &entry = m_entries.at(it.value());
+        if (entry.metaObject == object->metaObject() && entry.name == name)
+            return it.value();
+        removeEntry(object);
+    }
+
+    // same content the base class would search through, plus the address
+    QString text = Util::addressToString(object);
+    const int columns = sourceModel()->columnCount(sourceParent);
+    for (int column = 0; column < columns; ++column) {
+        text += QLatin1Char('\n');
+        text += sourceModel()->index(sourceRow, column, sourceParent).data().toString();
+    }
+
+    int id;
+    if (m_freeIds.isEmpty()) {
+        id = m_entries.size();
+        m_entries.resize(id + 1);
+    } else {
+        id = m_freeIds.takeLast();
+    }
+    SearchEntry &entry = m_entries[id];
+    entry.object = object;
+    entry.name = name;
+    entry.metaObject = object->metaObject();
+    entry.text = text.toCaseFolded();
+    m_entryIds.insert(object, id);
+    addTrigrams(id);
+
+    if (m_matchesValid && entry.text.contains(m_foldedPattern))
+        m_matches.insert(id);
+    return id;
+}
+
+void ObjectSearchProxyModel::addTrigrams(int id) const
+{
+    const QString text = m_entries.at(id).text;
+    m_entries[id].postingCount = 0;
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        const quint64 trigram = (quint64(text.at(i).unicode()) << 32)
+                                | (quint64(text.at(i + 1).unicode()) << 16)
+                                | text.at(i + 2).unicode();
+        auto &postings = m_trigrams[trigram];
+        // trigrams of one entry are added in a row, so this catches repeats
+        if (postings.isEmpty() || postings.last() != id) {
+            postings.push_back(id);
+            ++m_entries[id].postingCount;
+        }
+    }
+    m_postingCount += m_entries.at(id).postingCount;
+}
+
+void ObjectSearchProxyModel::removeEntry(QObject *object) const
+{
+    const auto it = m_entryIds.find(object);
+    if (it == m_entryIds.end())
+        return;
+
+    const int id = it.value();
+    m_entryIds.erase(it);
+    m_matches.remove(id);
+    SearchEntry &entry = m_entries[id];
+    m_stalePostingCount += entry.postingCount;
+    entry = SearchEntry();
+    m_freeIds.push_back(id);
+
+    if (m_stalePostingCount > m_postingCount / 2)
+        rebuildTrigrams();
+}
+
+void ObjectSearchProxyModel::rebuildTrigrams() const
+{
+    m_trigrams.clear();
+    m_postingCount = 0;
+    m_stalePostingCount = 0;
+    for (int id = 0; id < m_entries.size(); ++id) {
+        if (m_entries.at(id).object)
+            addTrigrams(id);
+    }
+}
+
+void ObjectSearchProxyModel::objectDestroyed(QObject *object)
+{
+    removeEntry(object);
+}
+
+void ObjectSearchProxyModel::sourceDataChanged(const QModelIndex &topLeft,
+                                               const QModelIndex &bottomRight)
+{
+    if (m_entryIds.isEmpty())
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const QModelIndex index = sourceModel()->index(row, 0, topLeft.parent());
+        removeEntry(index.data(ObjectModel::ObjectRole).value<QObject *>());
+    }
+}
+
+void ObjectSearchProxyModel::clearIndex()
+{
+    m_entries.clear();
+    m_freeIds.clear();
+    m_entryIds.clear();
+    m_trigrams.clear();
+    m_postingCount = 0;
+    m_stalePostingCount = 0;
+    m_matches.clear();
+    m_matchesValid = false;
+    m_pattern.clear();
+    m_foldedPattern.clear();
+}
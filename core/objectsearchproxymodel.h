@@ -0,0 +1,107 @@
+/*
+  objectsearchproxymodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_OBJECTSEARCHPROXYMODEL_H
+#define GAMMARAY_OBJECTSEARCHPROXYMODEL_H
+
+#include "gammaray_core_export.h"
+
+#include <3rdparty/kde/krecursivefilterproxymodel.h>
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+namespace GammaRay {
+/**
+ * Recursive filter proxy for object models, answering the fixed string
+ * searches sent by the client's search lines from a per-object index
+ * instead of formatting the display data of every row on each keystroke.
+ *
+ * The index holds the case-folded object name, type name and address of
+ * each object, filled lazily on first use, and a trigram index over that
+ * text. When the search pattern changes, the matching objects are looked
+ * up once, by narrowing the previous matches if the pattern was extended
+ * or through the trigram with the shortest posting list otherwise, and
+ * each row is then answered by a set lookup.
+ *
+ * Object models do not report name changes, so each entry remembers the
+ * name and type it was built from and is rebuilt when those no longer
+ * match. Entries are dropped on dataChanged, model reset and object
+ * destruction. Any other filter configuration falls back to the regular
+ * KRecursiveFilterProxyModel behavior.
+ */
+class GAMMARAY_CORE_EXPORT ObjectSearchProxyModel : public KRecursiveFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit ObjectSearchProxyModel(QObject *parent = nullptr);
+    ~ObjectSearchProxyModel() override;
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+protected:
+    bool acceptRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    bool canUseIndex() const;
+    void updatePattern() const;
+    int entryId(QObject *object, int sourceRow, const QModelIndex &sourceParent) const;
+    void addTrigrams(int id) const;
+    void removeEntry(QObject *object) const;
+    void rebuildTrigrams() const;
+    void objectDestroyed(QObject *object);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void clearIndex();
+
+    struct SearchEntry
+    {
+        QObject *object = nullptr;
+        QString name;
+        const QMetaObject *metaObject = nullptr;
+        QString text;
+        int postingCount = 0;
+    };
+
+    mutable QVector<SearchEntry> m_entries;
+    mutable QVector<int> m_freeIds;
+    mutable QHash<QObject *, int> m_entryIds;
+    // postings of removed entries are dropped lazily, candidates are
+    // always checked against the entry text
+    mutable QHash<quint64, QVector<int> > m_trigrams;
+    mutable int m_postingCount = 0;
+    mutable int m_stalePostingCount = 0;
+
+    mutable QString m_pattern;
+    mutable QString m_foldedPattern;
+    mutable QSet<int> m_matches;
+    mutable bool m_matchesValid = false;
+    QVector<QMetaObject::Connection> m_sourceConnections;
+};
+}
+
+#endif // GAMMARAY_OBJECTSEARCHPROXYMODEL_H
@@ -49,15 +49,13 @@ public:
                       const QModelIndex &parent = QModelIndex()) const override;
 
     Q_INVOKABLE QPair<int, QVariant> defaultSelectedItem() const;
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
 
 private slots:
     void objectAdded(QObject *obj);
     void objectRemoved(QObject *obj);
     void objectReparented(QObject *obj);
 
-private:
-    QModelIndex indexForObject(QObject *object) const;
-
 private:
     QHash<QObject *, QObject *> m_childParentMap;
     QHash<QObject *, QVector<QObject *> > m_parentChildMap;
@@ -52,6 +52,7 @@
 #include "remote/selectionmodelserver.h"
 #include "toolpluginerrormodel.h"
 #include "probeguard.h"
+#include "probeoverhead.h"
 
 #include <common/objectbroker.h>
 #include <common/streamoperators.h>
@@ -66,7 +67,9 @@
 #include <QMouseEvent>
 #include <QUrl>
 #include <QThread>
+#include <QThreadStorage>
 #include <QTimer>
+#include <QVarLengthArray>
 #include <private/qobject_p.h>
 #include <algorithm>
 #include <iostream>
@@ -86,13 +89,24 @@ using namespace std;
 QAtomicPointer<Probe> Probe::s_instance = QAtomicPointer<Probe>(nullptr);
 
 namespace GammaRay {
+static bool beginActivation(QObject *caller)
+{
+    return !Probe::instance()->filterObject(caller);
+}
+
+static bool endActivation(QObject *caller)
+{
+    return Probe::instance()->isTrackedObject(caller); // implies filterObject()
+}
+
 static void signal_begin_callback(QObject *caller, int method_index, void **argv)
 {
-    if (method_index == 0 || !Probe::instance() || Probe::instance()->filterObject(caller))
+    ProbeOverhead::Scope overhead(ProbeOverhead::SignalBegin);
+    if (method_index == 0 || !Probe::instance() || !beginActivation(caller))
         return;
 
     method_index = Util::signalIndexToMethodIndex(caller->metaObject(), method_index);
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
+    Probe::executeSignalCallback(caller, method_index, [=](const SignalSpyCallbackSet &callbacks) {
             if (callbacks.signalBeginCallback)
                 callbacks.signalBeginCallback(caller, method_index, argv);
         });
@@ -100,16 +114,15 @@ static void signal_begin_callback(QObject *caller, int method_index, void **argv
 
 static void signal_end_callback(QObject *caller, int method_index)
 {
+    ProbeOverhead::Scope overhead(ProbeOverhead::SignalEnd);
     if (method_index == 0 || !Probe::instance())
         return;
 
-    QMutexLocker locker(Probe::objectLock());
-    if (!Probe::instance()->isValidObject(caller)) // implies filterObject()
+    if (!endActivation(caller))
         return; // deleted in the slot
-    locker.unlock();
 
     method_index = Util::signalIndexToMethodIndex(caller->metaObject(), method_index);
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
+    Probe::executeSignalCallback(caller, method_index, [=](const SignalSpyCallbackSet &callbacks) {
             if (callbacks.signalEndCallback)
                 callbacks.signalEndCallback(caller, method_index);
         });
@@ -117,10 +130,11 @@ static void signal_end_callback(QObject *caller, int method_index)
 
 static void slot_begin_callback(QObject *caller, int method_index, void **argv)
 {
-    if (method_index == 0 || !Probe::instance() || Probe::instance()->filterObject(caller))
+    ProbeOverhead::Scope overhead(ProbeOverhead::SlotBegin);
+    if (method_index == 0 || !Probe::instance() || !beginActivation(caller))
         return;
 
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
+    Probe::executeSignalCallback(caller, method_index, [=](const SignalSpyCallbackSet &callbacks) {
             if (callbacks.slotBeginCallback)
                 callbacks.slotBeginCallback(caller, method_index, argv);
         });
@@ -128,15 +142,14 @@ static void slot_begin_callback(QObject *caller, int method_index, void **argv)
 
 static void slot_end_callback(QObject *caller, int method_index)
 {
+    ProbeOverhead::Scope overhead(ProbeOverhead::SlotEnd);
     if (method_index == 0 || !Probe::instance())
         return;
 
-    QMutexLocker locker(Probe::objectLock());
-    if (!Probe::instance()->isValidObject(caller)) // implies filterObject()
+    if (!endActivation(caller))
         return; // deleted in the slot
-    locker.unlock();
 
-    Probe::executeSignalCallback([=](const SignalSpyCallbackSet &callbacks) {
+    Probe::executeSignalCallback(caller, method_index, [=](const SignalSpyCallbackSet &callbacks) {
             if (callbacks.slotEndCallback)
                 callbacks.slotEndCallback(caller, method_index);
         });
@@ -264,6 +277,8 @@ Probe::~Probe()
     };
     qt_register_signal_spy_callbacks(prevCallbacks);
 #endif
+    m_signalSpyDispatch.storeRelease(nullptr);
+    qDeleteAll(m_signalSpyDispatchHistory);
 
     ObjectBroker::clear();
     ProbeSettings::resetLauncherIdentifier();
@@ -276,6 +291,7 @@ Probe::~Probe()
 void Probe::setWindow(QObject *window)
 {
     m_window = window;
+    clearFilterVerdicts();
 }
 
 QObject *Probe::window() const
@@ -459,10 +475,28 @@ void Probe::showInProcessUi()
 
 bool Probe::filterObject(QObject *obj) const
 {
+    // without destruction hooks we would not notice addresses being reused, so don't cache then
+    const bool useCache = !needsObjectDiscovery();
+
+    // visited objects, with the generation of their shard at the time
+    QVarLengthArray<QPair<const QObject *, quint32>, 16> path;
     QSet<QObject *> visitedObjects;
     int iteration = 0;
+    bool verdict = false;
     QObject *o = obj;
     do {
+        quint32 generation = 0;
+        if (useCache) {
+            auto &shard = objectStateShard(o);
+            QMutexLocker lock(&shard.mutex);
+            const auto it = shard.verdicts.constFind(o);
+            if (it != shard.verdicts.constEnd()) {
+                verdict = it.value();
+                break;
+            }
+            generation = shard.generation;
+        }
+
         if (iteration > 100) {
             // Probably we have a loop in the tree. Do loop detection.
             if (visitedObjects.contains(o)) {
@@ -476,12 +510,116 @@ bool Probe::filterObject(QObject *obj) const
         }
         ++iteration;
 
-        if (o == this || o == window() || (qstrncmp(o->metaObject()->className(), "GammaRay::", 10) == 0)) {
-            return true;
+        path.push_back(qMakePair<const QObject *, quint32>(o, generation));
+        if (isProbeObject(o)) {
+            verdict = true;
+            break;
+        }
+        if (isProbeType(o->metaObject())) {
+            verdict = true;
+            break;
         }
         o = o->parent();
     } while (o);
-    return false;
+
+    if (!useCache)
+        return verdict;
+
+    // the verdict applies to every object between obj and the ancestor that decided it
+    for (const auto &visited : qAsConst(path)) {
+        auto &shard = objectStateShard(visited.first);
+        QMutexLocker lock(&shard.mutex);
+        if (shard.generation == visited.second)
+            shard.verdicts.insert(visited.first, verdict);
+    }
+    return verdict;
+}
+
+bool Probe::isProbeType(const QMetaObject *mo) const
+{
+    {
+        QReadLocker lock(&m_probeMetaObjectLock);
+        const auto it = m_probeMetaObjects.constFind(mo);
+        if (it != m_probeMetaObjects.constEnd())
+            return it.value();
+    }
+
+    const bool probeType = qstrncmp(mo->className(), "GammaRay::", 10) == 0;
+    QWriteLocker lock(&m_probeMetaObjectLock);
+    m_probeMetaObjects.insert(mo, probeType);
+    return probeType;
+}
+
+bool Probe::isTrackedObject(const QObject *obj) const
+{
+    auto &shard = objectStateShard(obj);
+    QMutexLocker lock(&shard.mutex);
+    return shard.tracked.contains(obj);
+}
+
+// pre-condition: lock is held already, so this matches m_validObjects
+void Probe::setTracked(const QObject *obj, bool tracked)
+{
+    auto &shard = objectStateShard(obj);
+    QMutexLocker lock(&shard.mutex);
+    if (tracked)
+        shard.tracked.insert(obj);
+    else
+        shard.tracked.remove(obj);
+}
+
+Probe::ObjectStateShard &Probe::objectStateShard(const QObject *obj) const
+{
+    // the low bits are the same for all objects due to alignment
+    return m_objectStateShards[(quintptr(obj) >> 4) % ObjectStateShardCount];
+}
+
+bool Probe::isProbeObject(const QObject *obj) const
+{
+    return obj == this || obj == window();
+}
+
+/*
+ * Drops the cached filter verdicts of @p obj and all its descendants,
+ * needed whenever @p obj moves in the object tree.
+ * pre-conditions: arbitrary thread, obj is still alive
+ */
+void Probe::invalidateFilterVerdict(QObject *obj)
+{
+    QVector<QObject *> pending;
+    pending.push_back(obj);
+    while (!pending.isEmpty()) {
+        QObject *o = pending.takeLast();
+        auto &shard = objectStateShard(o);
+        {
+            QMutexLocker lock(&shard.mutex);
+            shard.verdicts.remove(o);
+            ++shard.generation;
+        }
+        for (QObject *child : o->children())
+            pending.push_back(child);
+    }
+}
+
+/*
+ * A destroyed object can't be looked up concurrently, so unlike a tree change
+ * this doesn't need to stop concurrent lookups from storing their result.
+ * pre-conditions: arbitrary thread, obj might be under destruction already
+ */
+void Probe::forgetFilterVerdict(const QObject *obj)
+{
+    auto &shard = objectStateShard(obj);
+    QMutexLocker lock(&shard.mutex);
+    shard.verdicts.remove(obj);
+}
+
+void Probe::clearFilterVerdicts()
+{
+    for (auto &shard : m_objectStateShards) {
+        QMutexLocker lock(&shard.mutex);
+        shard.verdicts.clear();
+        ++shard.generation;
+    }
 }
 
 void Probe::registerModel(const QString &objectName, QAbstractItemModel *model)
@@ -541,6 +679,7 @@ QMutex *Probe::objectLock()
  */
 void Probe::objectAdded(QObject *obj, bool fromCtor)
 {
+    ProbeOverhead::Scope overhead(ProbeOverhead::ObjectAdded);
     QMutexLocker lock(s_lock());
 
     // attempt to ignore objects created by GammaRay itself, especially short-lived ones
@@ -593,6 +732,7 @@ void Probe::objectAdded(QObject *obj, bool fromCtor)
     Q_ASSERT(!obj->parent() || instance()->m_validObjects.contains(obj->parent()));
 
     instance()->m_validObjects << obj;
+    instance()->setTracked(obj, true);
 
     if (!fromCtor && obj->parent() && instance()->isObjectCreationQueued(obj->parent())) {
         // when a child event triggers a call to objectAdded while inside the ctor
@@ -663,11 +803,14 @@ void Probe::objectFullyConstructed(QObject *obj)
         return;
     }
 
+    // a verdict computed while the ctor was still running saw the wrong meta object
+    invalidateFilterVerdict(obj);
     if (filterObject(obj)) {
         // when the call was delayed from the ctor construction,
         // the parent might not have been set properly yet. hence
         // apply the filter again
         m_validObjects.remove(obj);
+        setTracked(obj, false);
         IF_DEBUG(cout << "now filtered fully constructed: " << hex << obj << endl;
                  )
         return;
@@ -700,6 +843,7 @@ void Probe::objectFullyConstructed(QObject *obj)
  */
 void Probe::objectRemoved(QObject *obj)
 {
+    ProbeOverhead::Scope overhead(ProbeOverhead::ObjectRemoved);
     QMutexLocker lock(s_lock());
 
     if (!isInitialized()) {
@@ -725,7 +869,10 @@ void Probe::objectRemoved(QObject *obj)
     IF_DEBUG(cout << "object removed:" << hex << obj << " " << obj->parent() << endl;
              )
 
+    instance()->forgetFilterVerdict(obj);
+
     bool success = instance()->m_validObjects.remove(obj);
+    instance()->setTracked(obj, false);
     if (!success) {
         // object was not tracked by the probe, probably a gammaray object
         EXPENSIVE_ASSERT(!instance()->isObjectCreationQueued(obj));
@@ -811,9 +958,16 @@ void Probe::notifyQueuedObjectChanges()
 
 bool Probe::eventFilter(QObject *receiver, QEvent *event)
 {
+    // the object moved in the tree, so its and its children's filter verdicts might have changed
+    if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved)
+        invalidateFilterVerdict(static_cast<QChildEvent *>(event)->child());
+    else if (event->type() == QEvent::ParentChange)
+        invalidateFilterVerdict(receiver);
+
     if (ProbeGuard::insideProbe() && receiver->thread() == QThread::currentThread())
         return QObject::eventFilter(receiver, event);
 
+    ProbeOverhead::Scope overhead(ProbeOverhead::EventFilter);
     if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved) {
         QChildEvent *childEvent = static_cast<QChildEvent *>(event);
         QObject *obj = childEvent->child();
@@ -876,8 +1030,15 @@ bool Probe::eventFilter(QObject *receiver, QEvent *event)
 
     // filters provided by plugins
     if (!filterObject(receiver)) {
-        for (QObject *filter : qAsConst(m_globalEventFilters)) {
-            filter->eventFilter(receiver, event);
+        if (ProbeOverhead::isEnabled()) {
+            for (QObject *filter : qAsConst(m_globalEventFilters)) {
+                ProbeOverhead::Scope filterOverhead(filter->metaObject());
+                filter->eventFilter(receiver, event);
+            }
+        } else {
+            for (QObject *filter : qAsConst(m_globalEventFilters)) {
+                filter->eventFilter(receiver, event);
+            }
         }
     }
 
@@ -963,6 +1124,17 @@ void Probe::registerSignalSpyCallbackSet(const SignalSpyCallbackSet &callbacks)
     if (callbacks.isNull())
         return;
     m_signalSpyCallbacks.push_back(callbacks);
+
+    // serials are unique across probe instances, see signalSpyInterests()
+    static quint64 s_nextSerial = 0;
+    auto dispatch = new SignalSpyDispatch;
+    dispatch->serial = ++s_nextSerial;
+    dispatch->callbacks = m_signalSpyCallbacks;
+    dispatch->hasSubscriptions = std::any_of(m_signalSpyCallbacks.constBegin(), m_signalSpyCallbacks.constEnd(),
+                                             [](const SignalSpyCallbackSet &set) { return set.hasSubscriptions(); });
+    m_signalSpyDispatchHistory.push_back(dispatch);
+    m_signalSpyDispatch.storeRelease(dispatch);
+
     setupSignalSpyCallbacks();
 }
 
@@ -983,12 +1155,85 @@ void Probe::setupSignalSpyCallbacks()
 #endif
 }
 
+static bool inheritsClass(const QMetaObject *mo, const QByteArray &className)
+{
+    for (; mo; mo = mo->superClass()) {
+        if (className == mo->className())
+            return true;
+    }
+    return false;
+}
+
+const QVector<Probe::SignalSpyInterest> &Probe::signalSpyInterests(const SignalSpyDispatch *dispatch, const QMetaObject *mo)
+{
+    // Per-thread cache, so lookups need no locking. Entries are never removed and QHash nodes
+    // don't move on rehashing, so the returned reference survives nested emissions adding entries.
+    typedef QHash<QPair<quint64, const QMetaObject *>, QVector<SignalSpyInterest>> InterestCache;
+    static QThreadStorage<InterestCache *> s_caches;
+    if (!s_caches.hasLocalData())
+        s_caches.setLocalData(new InterestCache);
+    InterestCache *cache = s_caches.localData();
+
+    const auto key = qMakePair(dispatch->serial, mo);
+    const auto it = cache->constFind(key);
+    if (it != cache->constEnd())
+        return it.value();
+
+    QVector<SignalSpyInterest> interests;
+    for (int i = 0; i < dispatch->callbacks.size(); ++i) {
+        bool interested = false;
+        bool allMethods = false;
+        QVector<int> methodIndexes;
+        foreach (const auto &subscription, dispatch->callbacks.at(i).subscriptions) {
+            if (!inheritsClass(mo, subscription.className))
+                continue;
+            interested = true;
+            allMethods = allMethods || subscription.methodSignatures.isEmpty();
+            for (const auto &signature : subscription.methodSignatures) {
+                const int methodIndex = mo->indexOfMethod(signature.constData());
+                if (methodIndex >= 0)
+                    methodIndexes.push_back(methodIndex);
+            }
+        }
+        if (!interested)
+            continue;
+        if (allMethods) {
+            methodIndexes.clear();
+        } else if (methodIndexes.isEmpty()) {
+            continue; // none of the methods exists in this class
+        }
+        std::sort(methodIndexes.begin(), methodIndexes.end());
+        interests.push_back({ i, methodIndexes });
+    }
+    return cache->insert(key, interests).value();
+}
+
 template<typename Func>
-void Probe::executeSignalCallback(const Func &func)
+void Probe::executeSignalCallback(const QObject *caller, int methodIndex, const Func &func)
 {
-    std::for_each(instance()->m_signalSpyCallbacks.constBegin(),
-                  instance()->m_signalSpyCallbacks.constEnd(),
-                  func);
+    const SignalSpyDispatch *dispatch = instance()->m_signalSpyDispatch.loadAcquire();
+    if (!dispatch)
+        return;
+    if (!dispatch->hasSubscriptions) {
+        std::for_each(dispatch->callbacks.constBegin(), dispatch->callbacks.constEnd(), func);
+        return;
+    }
+
+    const auto &interests = signalSpyInterests(dispatch, caller->metaObject());
+    auto interest = interests.constBegin();
+    for (int i = 0; i < dispatch->callbacks.size(); ++i) {
+        const auto &callbacks = dispatch->callbacks.at(i);
+        if (callbacks.hasSubscriptions()) {
+            while (interest != interests.constEnd() && interest->callbackSet < i)
+                ++interest;
+            if (interest == interests.constEnd() || interest->callbackSet != i)
+                continue;
+            if (!interest->methodIndexes.isEmpty()
+                && !std::binary_search(interest->methodIndexes.constBegin(), interest->methodIndexes.constEnd(), methodIndex))
+                continue;
+        }
+        func(callbacks);
+    }
 }
 
 SourceLocation Probe::objectCreationSourceLocation(QObject *object) const
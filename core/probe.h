@@ -35,8 +35,11 @@
 #include <common/sourcelocation.h>
 
 #include <QObject>
+#include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QPoint>
+#include <QReadWriteLock>
 #include <QSet>
 #include <QVector>
 
@@ -215,7 +218,9 @@ public:
 
     ///@cond internal
     static void startupHookReceived();
-    template<typename Func> static void executeSignalCallback(const Func &func);
+    template<typename Func> static void executeSignalCallback(const QObject *caller, int methodIndex, const Func &func);
+    /*! Same as isValidObject(), but does not require the objectLock to be locked. */
+    bool isTrackedObject(const QObject *obj) const;
     ///@endcond
 
     ProblemCollector *problemCollector() const;
@@ -287,6 +292,13 @@ private:
 
     void objectFullyConstructed(QObject *obj);
 
+    bool isProbeObject(const QObject *obj) const;
+    bool isProbeType(const QMetaObject *mo) const;
+    void setTracked(const QObject *obj, bool tracked);
+    void invalidateFilterVerdict(QObject *obj);
+    void forgetFilterVerdict(const QObject *obj);
+    void clearFilterVerdicts();
+
     void queueCreatedObject(QObject *obj);
     void queueDestroyedObject(QObject *obj);
     bool isObjectCreationQueued(QObject *obj) const;
@@ -308,6 +320,19 @@ private:
     /*! Set up all needed signal spy callbacks. */
     void setupSignalSpyCallbacks();
 
+    // callback sets with subscriptions interested in a given meta object
+    struct SignalSpyInterest {
+        int callbackSet;
+        QVector<int> methodIndexes; // sorted, empty for all methods
+    };
+    // immutable once published, a new one is published for every registration
+    struct SignalSpyDispatch {
+        quint64 serial;
+        QVector<SignalSpyCallbackSet> callbacks;
+        bool hasSubscriptions;
+    };
+    static const QVector<SignalSpyInterest> &signalSpyInterests(const SignalSpyDispatch *dispatch, const QMetaObject *mo);
+
     ObjectListModel *m_objectListModel;
     ObjectTreeModel *m_objectTreeModel;
     ProblemCollector *m_problemCollector;
@@ -316,6 +341,24 @@ private:
     QSet<const QObject *> m_validObjects;
     MetaObjectRegistry *m_metaObjectRegistry;
 
+    // per-object state needed by the signal spy hooks, spread over independently
+    // locked shards by object address, so hooks in different threads rarely contend
+    struct ObjectStateShard {
+        QMutex mutex;
+        // cached results of filterObject()
+        QHash<const QObject *, bool> verdicts;
+        // mirrors m_validObjects, so the hooks don't need the object lock
+        QSet<const QObject *> tracked;
+        // bumped when verdicts of this shard are dropped due to a tree change,
+        // so concurrent lookups don't store results computed before that
+        quint32 generation = 0;
+    };
+    static const int ObjectStateShardCount = 64;
+    ObjectStateShard &objectStateShard(const QObject *obj) const;
+    mutable ObjectStateShard m_objectStateShards[ObjectStateShardCount];
+    mutable QReadWriteLock m_probeMetaObjectLock;
+    mutable QHash<const QMetaObject *, bool> m_probeMetaObjects;
+
     // all delayed object changes need to go through a single queue, as the order is crucial
     struct ObjectChange {
         QObject *obj;
@@ -330,6 +373,10 @@ private:
     QTimer *m_queueTimer;
     QVector<QObject *> m_globalEventFilters;
     QVector<SignalSpyCallbackSet> m_signalSpyCallbacks;
+    // read by the signal spy hooks without locking
+    QAtomicPointer<const SignalSpyDispatch> m_signalSpyDispatch;
+    // previously published dispatch tables might still be in use by hooks in other threads
+    QVector<const SignalSpyDispatch *> m_signalSpyDispatchHistory;
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
     QSignalSpyCallbackSet *m_previousSignalSpyCallbackSet;
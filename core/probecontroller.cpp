@@ -29,18 +29,34 @@
 #include "probecontroller.h"
 
 #include "probe.h"
+#include "remote/remotemodelserver.h"
 
+#include <common/endpoint.h>
+#include <common/modelevent.h>
+#include <common/modelsnapshot.h>
+#include <common/objectbroker.h>
+
+#include <QBuffer>
 #include <QDebug>
 #include <QCoreApplication>
 #include <QMutexLocker>
+#include <QTimer>
 
 using namespace GammaRay;
 
+// rows serialized per event loop pass and export, keeps the target responsive
+static const int SnapshotRowsPerChunk = 500;
+
 ProbeController::ProbeController(QObject *parent)
     : ProbeControllerInterface(parent)
+    , m_snapshotTimer(new QTimer(this))
 {
+    m_snapshotTimer->setInterval(0);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &ProbeController::writeNextSnapshotChunk);
 }
 
+ProbeController::~ProbeController() = default;
+
 void ProbeController::detachProbe()
 {
     Probe::instance()->deleteLater();
@@ -50,3 +66,89 @@ void ProbeController::quitHost()
 {
     QCoreApplication::instance()->quit();
 }
+
+void ProbeController::requestModelSnapshot(const QString &modelName, const QString &targetFilePath)
+{
+    cancelModelSnapshot(targetFilePath);
+
+    auto model = ObjectBroker::model(modelName);
+    if (!model) {
+        qWarning() << "Unknown model for snapshot export:" << modelName;
+        emit modelSnapshotData(targetFilePath, QByteArray(), -1, true);
+        return;
+    }
+
+    SnapshotExport snapshot;
+    snapshot.targetFilePath = targetFilePath;
+    snapshot.model = model;
+    snapshot.buffer.reset(new QBuffer);
+    snapshot.buffer->open(QIODevice::WriteOnly);
+    snapshot.writer.reset(new ModelSnapshotWriter(model, snapshot.buffer.get()));
+    snapshot.offset = 0;
+    m_snapshotExports.push_back(std::move(snapshot));
+    m_snapshotTimer->start();
+}
+
+void ProbeController::cancelModelSnapshot(const QString &targetFilePath)
+{
+    for (auto it = m_snapshotExports.begin(); it != m_snapshotExports.end(); ++it) {
+        if (it->targetFilePath == targetFilePath) {
+            const QPointer<QAbstractItemModel> model = it->model;
+            m_snapshotExports.erase(it);
+            releaseModel(model);
+            break;
+        }
+    }
+    if (m_snapshotExports.empty())
+        m_snapshotTimer->stop();
+}
+
+void ProbeController::writeNextSnapshotChunk()
+{
+    if (m_snapshotExports.empty()) {
+        m_snapshotTimer->stop();
+        return;
+    }
+
+    // round-robin over all pending exports, one chunk per event loop pass
+    SnapshotExport snapshot = std::move(m_snapshotExports.front());
+    m_snapshotExports.erase(m_snapshotExports.begin());
+
+    const QString targetFilePath = snapshot.targetFilePath;
+    const bool ok = snapshot.writer->writeRows(SnapshotRowsPerChunk);
+    const bool finished = !ok || snapshot.writer->isFinished();
+    const QByteArray chunk = ok ? snapshot.buffer->data() : QByteArray();
+    const qint64 offset = ok ? snapshot.offset : -1;
+    snapshot.buffer->buffer().clear();
+    snapshot.buffer->seek(0);
+    snapshot.offset += chunk.size();
+
+    const QPointer<QAbstractItemModel> model = snapshot.model;
+    if (!finished)
+        m_snapshotExports.push_back(std::move(snapshot));
+    else
+        releaseModel(model);
+    if (m_snapshotExports.empty())
+        m_snapshotTimer->stop();
+    emit modelSnapshotData(targetFilePath, chunk, offset, finished);
+}
+
+void ProbeController::releaseModel(QAbstractItemModel *model) const
+{
+    if (!model)
+        return;
+    for (const auto &snapshot : m_snapshotExports) {
+        if (snapshot.model == model)
+            return;
+    }
+
+    // ObjectBroker::model() marked it as used, which isn't reference counted.
+    // An in-process UI keeps using its models, and a remote client uses them
+    // through their model server while it monitors them.
+    if (!Endpoint::isConnected())
+        return;
+    const auto server = model->findChild<RemoteModelServer *>(QString(), Qt::FindDirectChildrenOnly);
+    if (server && server->isMonitored())
+        return;
+    Model::unused(model);
+}
@@ -31,7 +31,20 @@
 
 #include <common/probecontrollerinterface.h>
 
+#include <QPointer>
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+class QBuffer;
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
+class ModelSnapshotWriter;
+
 /** @brief Server-side part for the object property inspector.
  *  Use this to integrate a property inspector like in the QObject view into your tool.
  */
@@ -41,10 +54,29 @@ class ProbeController : public ProbeControllerInterface
     Q_INTERFACES(GammaRay::ProbeControllerInterface)
 public:
     explicit ProbeController(QObject *parent = nullptr);
+    ~ProbeController() override;
 
 public slots:
     void detachProbe() override;
     void quitHost() override;
+    void requestModelSnapshot(const QString &modelName, const QString &targetFilePath) override;
+    void cancelModelSnapshot(const QString &targetFilePath) override;
+
+private slots:
+    void writeNextSnapshotChunk();
+
+private:
+    void releaseModel(QAbstractItemModel *model) const;
+
+    struct SnapshotExport {
+        QString targetFilePath;
+        QPointer<QAbstractItemModel> model;
+        std::unique_ptr<QBuffer> buffer;
+        std::unique_ptr<ModelSnapshotWriter> writer;
+        qint64 offset;
+    };
+    std::vector<SnapshotExport> m_snapshotExports;
+    QTimer *m_snapshotTimer;
 };
 }
 
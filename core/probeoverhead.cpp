@@ -0,0 +1,201 @@
+/*
+  probeoverhead.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "probeoverhead.h"
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadStorage>
+
+#include <compat/qasconst.h>
+
+using namespace GammaRay;
+
+namespace {
+struct AtomicStatistics
+{
+    QAtomicInteger<quint64> calls;
+    QAtomicInteger<quint64> totalTime;
+    QAtomicInteger<quint64> exclusiveTime;
+    QAtomicInteger<quint64> maxTime;
+
+    void record(quint64 nsecs, quint64 exclusiveNsecs)
+    {
+        calls.fetchAndAddRelaxed(1);
+        totalTime.fetchAndAddRelaxed(nsecs);
+        exclusiveTime.fetchAndAddRelaxed(exclusiveNsecs);
+        quint64 max = maxTime.loadAcquire();
+        while (nsecs > max && !maxTime.testAndSetOrdered(max, nsecs, max)) {}
+    }
+
+    ProbeOverhead::Statistics statistics() const
+    {
+        ProbeOverhead::Statistics s;
+        s.calls = calls.loadAcquire();
+        s.totalTime = totalTime.loadAcquire();
+        s.exclusiveTime = exclusiveTime.loadAcquire();
+        s.maxTime = maxTime.loadAcquire();
+        return s;
+    }
+
+    void reset()
+    {
+        calls.storeRelease(0);
+        totalTime.storeRelease(0);
+        exclusiveTime.storeRelease(0);
+        maxTime.storeRelease(0);
+    }
+};
+
+struct EventFilterStatistics
+{
+    QMutex mutex;
+    QVector<const QMetaObject *> types; // in order of first appearance
+    QHash<const QMetaObject *, ProbeOverhead::Statistics> statistics;
+};
+}
+
+static QAtomicInt s_enabled;
+static AtomicStatistics s_hookStatistics[ProbeOverhead::HookCount];
+Q_GLOBAL_STATIC(EventFilterStatistics, s_eventFilterStatistics)
+
+// innermost active scope of the current thread, stored as an integer as
+// QThreadStorage would take ownership of a pointer
+static QThreadStorage<quintptr> s_currentScope;
+
+static quint64 clampedTime(qint64 nsecs)
+{
+    return quint64(qMax<qint64>(0, nsecs));
+}
+
+bool ProbeOverhead::isEnabled()
+{
+    return s_enabled.loadAcquire();
+}
+
+void ProbeOverhead::setEnabled(bool enabled)
+{
+    s_enabled.storeRelease(enabled);
+}
+
+void ProbeOverhead::reset()
+{
+    for (auto &stats : s_hookStatistics)
+        stats.reset();
+
+    QMutexLocker lock(&s_eventFilterStatistics()->mutex);
+    s_eventFilterStatistics()->types.clear();
+    s_eventFilterStatistics()->statistics.clear();
+}
+
+void ProbeOverhead::record(Hook hook, qint64 nsecs, qint64 exclusiveNsecs)
+{
+    Q_ASSERT(hook >= 0 && hook < HookCount);
+    s_hookStatistics[hook].record(clampedTime(nsecs), clampedTime(exclusiveNsecs));
+}
+
+ProbeOverhead::Statistics ProbeOverhead::statistics(Hook hook)
+{
+    Q_ASSERT(hook >= 0 && hook < HookCount);
+    return s_hookStatistics[hook].statistics();
+}
+
+void ProbeOverhead::recordEventFilter(const QMetaObject *filterType, qint64 nsecs, qint64 exclusiveNsecs)
+{
+    const quint64 time = clampedTime(nsecs);
+    QMutexLocker lock(&s_eventFilterStatistics()->mutex);
+    auto it = s_eventFilterStatistics()->statistics.find(filterType);
+    if (it == s_eventFilterStatistics()->statistics.end()) {
+        s_eventFilterStatistics()->types.push_back(filterType);
+        it = s_eventFilterStatistics()->statistics.insert(filterType, Statistics());
+    }
+    ++it->calls;
+    it->totalTime += time;
+    it->exclusiveTime += clampedTime(exclusiveNsecs);
+    it->maxTime = qMax(it->maxTime, time);
+}
+
+QVector<QPair<const QMetaObject *, ProbeOverhead::Statistics> > ProbeOverhead::eventFilterStatistics()
+{
+    QMutexLocker lock(&s_eventFilterStatistics()->mutex);
+    QVector<QPair<const QMetaObject *, Statistics> > result;
+    result.reserve(s_eventFilterStatistics()->types.size());
+    for (auto type : qAsConst(s_eventFilterStatistics()->types))
+        result.push_back(qMakePair(type, s_eventFilterStatistics()->statistics.value(type)));
+    return result;
+}
+
+ProbeOverhead::Scope::Scope(Hook hook)
+    : m_filterType(nullptr)
+    , m_parent(nullptr)
+    , m_nestedTime(0)
+    , m_hook(hook)
+    , m_active(ProbeOverhead::isEnabled())
+{
+    if (m_active)
+        begin();
+}
+
+ProbeOverhead::Scope::Scope(const QMetaObject *filterType)
+    : m_filterType(filterType)
+    , m_parent(nullptr)
+    , m_nestedTime(0)
+    , m_hook(EventFilter)
+    , m_active(ProbeOverhead::isEnabled())
+{
+    if (m_active)
+        begin();
+}
+
+void ProbeOverhead::Scope::begin()
+{
+    m_parent = reinterpret_cast<Scope *>(s_currentScope.localData());
+    s_currentScope.setLocalData(reinterpret_cast<quintptr>(this));
+    m_timer.start();
+}
+
+ProbeOverhead::Scope::~Scope()
+{
+    if (!m_active)
+        return;
+
+    const qint64 elapsed = m_timer.nsecsElapsed();
+    s_currentScope.setLocalData(reinterpret_cast<quintptr>(m_parent));
+    if (m_filterType) {
+        ProbeOverhead::recordEventFilter(m_filterType, elapsed, elapsed - m_nestedTime);
+        // only hooks nested in the filter are excluded from the enclosing scope
+        if (m_parent)
+            m_parent->m_nestedTime += m_nestedTime;
+    } else {
+        ProbeOverhead::record(m_hook, elapsed, elapsed - m_nestedTime);
+        if (m_parent)
+            m_parent->m_nestedTime += elapsed;
+    }
+}
@@ -0,0 +1,117 @@
+/*
+  probeoverhead.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef GAMMARAY_PROBEOVERHEAD_H
+#define GAMMARAY_PROBEOVERHEAD_H
+
+#include "gammaray_core_export.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+struct QMetaObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/**
+ * Accounting of the time the probe spends in its hooks.
+ *
+ * Recording is disabled by default and only enabled while somebody looks at the
+ * results, so this costs a single atomic load per hook invocation otherwise.
+ * All methods are thread-safe.
+ */
+class GAMMARAY_CORE_EXPORT ProbeOverhead
+{
+public:
+    enum Hook {
+        ObjectAdded,
+        ObjectRemoved,
+        SignalBegin,
+        SignalEnd,
+        SlotBegin,
+        SlotEnd,
+        EventFilter,
+        RemoteModelRequest,
+        HookCount
+    };
+
+    /// Times are in nanoseconds. Hooks nest (e.g. object creation during
+    /// event filtering), the exclusive time excludes nested hooks.
+    struct Statistics
+    {
+        quint64 calls = 0;
+        quint64 totalTime = 0;
+        quint64 exclusiveTime = 0;
+        quint64 maxTime = 0;
+    };
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+    /// Discards all statistics recorded so far.
+    static void reset();
+
+    static void record(Hook hook, qint64 nsecs, qint64 exclusiveNsecs);
+    static Statistics statistics(Hook hook);
+
+    /// Time spent in event filters installed via Probe::installGlobalEventFilter(), by filter type.
+    static void recordEventFilter(const QMetaObject *filterType, qint64 nsecs, qint64 exclusiveNsecs);
+    static QVector<QPair<const QMetaObject *, Statistics> > eventFilterStatistics();
+
+    /**
+     * Records the lifetime of this object for @p hook, if recording is enabled.
+     * Scopes form a per-thread stack, so the time of nested scopes can be
+     * excluded from the enclosing one.
+     */
+    class GAMMARAY_CORE_EXPORT Scope
+    {
+    public:
+        explicit Scope(Hook hook);
+        /// Times a single global event filter inside an EventFilter scope. This
+        /// is a breakdown of the enclosing scope, which keeps its time.
+        explicit Scope(const QMetaObject *filterType);
+        ~Scope();
+
+    private:
+        Q_DISABLE_COPY(Scope)
+        void begin();
+
+        QElapsedTimer m_timer;
+        const QMetaObject *m_filterType;
+        Scope *m_parent;
+        qint64 m_nestedTime;
+        Hook m_hook;
+        bool m_active;
+    };
+
+private:
+    ProbeOverhead() = delete;
+};
+}
+
+#endif // GAMMARAY_PROBEOVERHEAD_H
@@ -29,6 +29,7 @@
 #include "remotemodelserver.h"
 #include "server.h"
 #include <core/probeguard.h>
+#include <core/probeoverhead.h>
 #include <common/protocol.h>
 #include <common/message.h>
 #include <common/modelevent.h>
@@ -37,9 +38,11 @@
 #include <compat/qasconst.h>
 
 #include <QAbstractItemModel>
+#include <QAbstractProxyModel>
 #include <QSortFilterProxyModel>
 #include <QDataStream>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QBuffer>
 #include <QIcon>
 
@@ -50,6 +53,21 @@ using namespace std;
 
 void(*RemoteModelServer::s_registerServerCallback)() = nullptr;
 
+namespace {
+struct ServerClock
+{
+    ServerClock() { timer.start(); }
+    QElapsedTimer timer;
+};
+}
+
+Q_GLOBAL_STATIC(ServerClock, s_serverClock)
+
+static Protocol::Timestamp serverTimestamp()
+{
+    return s_serverClock()->timer.nsecsElapsed() / 1000;
+}
+
 RemoteModelServer::RemoteModelServer(const QString &objectName, QObject *parent)
     : QObject(parent)
     , m_model(nullptr)
@@ -68,6 +86,11 @@ QAbstractItemModel *RemoteModelServer::model() const
     return m_model;
 }
 
+bool RemoteModelServer::isMonitored() const
+{
+    return m_monitored;
+}
+
 void RemoteModelServer::setModel(QAbstractItemModel *model)
 {
     if (model == m_model)
@@ -107,6 +130,8 @@ void RemoteModelServer::connectModel()
             this, &RemoteModelServer::columnsRemoved);
     connect(m_model.data(), &QAbstractItemModel::dataChanged,
             this, &RemoteModelServer::dataChanged);
+    connect(m_model.data(), &QAbstractItemModel::layoutAboutToBeChanged,
+            this, &RemoteModelServer::layoutAboutToBeChanged);
     connect(m_model.data(),
             &QAbstractItemModel::layoutChanged,
             this,
@@ -138,27 +163,33 @@ void RemoteModelServer::disconnectModel()
                this, &RemoteModelServer::columnsRemoved);
     disconnect(m_model.data(), &QAbstractItemModel::dataChanged,
                this, &RemoteModelServer::dataChanged);
+    disconnect(m_model.data(), &QAbstractItemModel::layoutAboutToBeChanged,
+               this, &RemoteModelServer::layoutAboutToBeChanged);
     disconnect(m_model.data(), &QAbstractItemModel::layoutChanged,
                this, &RemoteModelServer::layoutChanged);
+    m_pendingPermutations.clear();
     disconnect(m_model.data(), &QAbstractItemModel::modelReset, this, &RemoteModelServer::modelReset);
     disconnect(m_model.data(), &QObject::destroyed, this, &RemoteModelServer::modelDeleted);
 }
 
 void RemoteModelServer::newRequest(const GammaRay::Message &msg)
 {
+    ProbeOverhead::Scope overhead(ProbeOverhead::RemoteModelRequest);
     if (!m_model && msg.type() != Protocol::ModelSyncBarrier)
         return;
+    const auto received = serverTimestamp();
 
     ProbeGuard g;
     switch (msg.type()) {
     case Protocol::ModelRowColumnCountRequest:
     {
+        Protocol::RequestId requestId;
         quint32 size;
-        msg >> size;
+        msg >> requestId >> size;
         Q_ASSERT(size > 0);
 
         Message reply(m_myAddress, Protocol::ModelRowColumnCountReply);
-        reply << size;
+        reply << requestId << size;
         for (quint32 i = 0; i < size; ++i) {
             Protocol::ModelIndex index;
             msg >> index;
@@ -172,14 +203,16 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
 
             reply << index << rowCount << columnCount;
         }
+        reply << received << serverTimestamp();
         sendMessage(reply);
         break;
     }
 
     case Protocol::ModelContentRequest:
     {
+        Protocol::RequestId requestId;
         quint32 size;
-        msg >> size;
+        msg >> requestId >> size;
         Q_ASSERT(size > 0);
 
         QVector<QModelIndex> indexes;
@@ -196,11 +229,12 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
             break;
 
         Message msg(m_myAddress, Protocol::ModelContentReply);
-        msg << quint32(indexes.size());
+        msg << requestId << quint32(indexes.size());
         for (const auto &qmIndex : qAsConst(indexes))
             msg << Protocol::fromQModelIndex(qmIndex)
                           << filterItemData(m_model->itemData(qmIndex))
                           << qint32(m_model->flags(qmIndex));
+        msg << received << serverTimestamp();
 
         sendMessage(msg);
         break;
@@ -208,9 +242,10 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
 
     case Protocol::ModelHeaderRequest:
     {
+        Protocol::RequestId requestId;
         qint8 orientation;
         qint32 section;
-        msg >> orientation >> section;
+        msg >> requestId >> orientation >> section;
         Q_ASSERT(orientation == Qt::Horizontal || orientation == Qt::Vertical);
         Q_ASSERT(section >= 0);
 
@@ -224,7 +259,7 @@ void RemoteModelServer::newRequest(const GammaRay::Message &msg)
                                         Qt::ToolTipRole));
 
         Message msg(m_myAddress, Protocol::ModelHeaderReply);
-        msg << orientation << section << data;
+        msg << requestId << orientation << section << data << received << serverTimestamp();
         sendMessage(msg);
         break;
     }
@@ -404,9 +439,70 @@ void RemoteModelServer::columnsRemoved(const QModelIndex &parent, int start, int
 }
 
 
+void RemoteModelServer::layoutAboutToBeChanged(const QList<QPersistentModelIndex> &parents,
+                                               QAbstractItemModel::LayoutChangeHint hint)
+{
+    m_pendingPermutations.clear();
+    if (!isConnected() || hint != QAbstractItemModel::VerticalSortHint)
+        return;
+
+    // sorting without explicit parents reorders rows on all levels of a tree,
+    // that is better handled by a full layout change
+    if (parents.isEmpty() && !isFlat())
+        return;
+
+    // a sort proxy doesn't forward the hint of source layout changes, so its
+    // rows keep their source row, which saves a persistent index per row
+    const auto proxy = qobject_cast<QSortFilterProxyModel *>(m_model.data());
+
+    QVector<PendingPermutation> pending;
+    const QList<QPersistentModelIndex> sortedParents
+        = parents.isEmpty() ? QList<QPersistentModelIndex>() << QPersistentModelIndex() : parents;
+    pending.reserve(sortedParents.size());
+    for (const auto &parent : sortedParents) {
+        PendingPermutation permutation;
+        permutation.parent = parent;
+        const int rowCount = m_model->rowCount(parent);
+        if (proxy) {
+            permutation.sourceRows.reserve(rowCount);
+            for (int row = 0; row < rowCount; ++row)
+                permutation.sourceRows.push_back(proxy->mapToSource(proxy->index(row, 0, parent)).row());
+        } else {
+            permutation.rows.reserve(rowCount);
+            for (int row = 0; row < rowCount; ++row)
+                permutation.rows.push_back(m_model->index(row, 0, parent));
+        }
+        pending.push_back(permutation);
+    }
+    m_pendingPermutations = pending;
+}
+
+bool RemoteModelServer::isFlat() const
+{
+    const QAbstractItemModel *model = m_model;
+    while (auto proxy = qobject_cast<const QAbstractProxyModel *>(model))
+        model = proxy->sourceModel();
+    if (qobject_cast<const QAbstractListModel *>(model) || qobject_cast<const QAbstractTableModel *>(model))
+        return true;
+
+    const int rowCount = m_model->rowCount();
+    for (int row = 0; row < rowCount; ++row) {
+        if (m_model->hasChildren(m_model->index(row, 0)))
+            return false;
+    }
+    return true;
+}
+
 void RemoteModelServer::layoutChanged(const QList<QPersistentModelIndex> &parents,
                                       QAbstractItemModel::LayoutChangeHint hint)
 {
+    if (!m_pendingPermutations.isEmpty()) {
+        const bool permuted = sendRowsPermuted();
+        m_pendingPermutations.clear();
+        if (permuted)
+            return;
+    }
+
     QVector<Protocol::ModelIndex> indexes;
     indexes.reserve(parents.size());
     for (const auto &index : parents)
@@ -425,6 +521,81 @@ void RemoteModelServer::sendLayoutChanged(const QVector< Protocol::ModelIndex >
     sendMessage(msg);
 }
 
+bool RemoteModelServer::sendRowsPermuted()
+{
+    if (!isConnected())
+        return true;
+
+    const auto proxy = qobject_cast<QSortFilterProxyModel *>(m_model.data());
+    QVector<Protocol::ModelIndex> parents;
+    QVector<QVector<qint32> > moves;
+    QVector<QVector<qint32> > permutations;
+    for (const auto &pending : qAsConst(m_pendingPermutations)) {
+        const int rowCount = m_model->rowCount(pending.parent);
+        QVector<qint32> newRows;
+        if (proxy) {
+            if (pending.sourceRows.size() != rowCount)
+                return false;
+            const QModelIndex sourceParent = proxy->mapToSource(pending.parent);
+            QVector<int> oldRows(proxy->sourceModel()->rowCount(sourceParent), -1);
+            for (int row = 0; row < rowCount; ++row) {
+                const int sourceRow = pending.sourceRows.at(row);
+                if (sourceRow < 0 || sourceRow >= oldRows.size())
+                    return false;
+                oldRows[sourceRow] = row;
+            }
+            newRows.fill(-1, rowCount);
+            for (int row = 0; row < rowCount; ++row) {
+                const int oldRow = oldRows.value(proxy->mapToSource(proxy->index(row, 0, pending.parent)).row(), -1);
+                if (oldRow < 0 || newRows.at(oldRow) >= 0)
+                    return false;
+                newRows[oldRow] = row;
+            }
+        } else {
+            if (pending.rows.size() != rowCount)
+                return false;
+            newRows.reserve(rowCount);
+            for (const auto &index : pending.rows) {
+                if (!index.isValid())
+                    return false;
+                newRows.push_back(index.row());
+            }
+        }
+
+        // runs of rows that moved by the same offset, as (old row, new row, count)
+        QVector<qint32> runs;
+        for (int row = 0; row < rowCount;) {
+            if (newRows.at(row) == row) {
+                ++row;
+                continue;
+            }
+            int end = row + 1;
+            while (end < rowCount && newRows.at(end) == newRows.at(row) + end - row)
+                ++end;
+            runs << row << newRows.at(row) << end - row;
+            row = end;
+        }
+        if (runs.isEmpty())
+            continue;
+
+        parents.push_back(Protocol::fromQModelIndex(pending.parent));
+        if (runs.size() < rowCount) {
+            moves.push_back(runs);
+            permutations.push_back(QVector<qint32>());
+        } else {
+            moves.push_back(QVector<qint32>());
+            permutations.push_back(newRows);
+        }
+    }
+
+    if (parents.isEmpty())
+        return true;
+    Message msg(m_myAddress, Protocol::ModelRowsPermuted);
+    msg << parents << moves << permutations;
+    sendMessage(msg);
+    return true;
+}
+
 void RemoteModelServer::modelReset()
 {
     if (!isConnected())
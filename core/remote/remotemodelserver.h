@@ -32,8 +32,10 @@
 #include <common/protocol.h>
 
 #include <QObject>
+#include <QPersistentModelIndex>
 #include <QPointer>
 #include <QRegExp>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QBuffer;
@@ -65,6 +67,8 @@ public:
     QAbstractItemModel *model() const;
     /** Set the source model for this model server instance. */
     void setModel(QAbstractItemModel *model);
+    /** Returns @c true while a client is monitoring this model. */
+    bool isMonitored() const;
 
 public slots:
     void newRequest(const GammaRay::Message &msg);
@@ -85,6 +89,13 @@ private:
     void sendLayoutChanged(
         const QVector<Protocol::ModelIndex> &parents = QVector<Protocol::ModelIndex>(),
         quint32 hint = 0);
+    /** Returns @c true if no top-level row of the model has children. */
+    bool isFlat() const;
+    /** Sends the rows that moved since layoutAboutToBeChanged, as runs of rows moved by the same
+     *  offset, or as the full permutation if most rows moved.
+     *  Returns @c false if that isn't possible, and a full layout change needs to be sent instead.
+     */
+    bool sendRowsPermuted();
     bool canSerialize(const QVariant &value) const;
 
     // proxy model settings
@@ -118,6 +129,8 @@ private slots:
     void columnsMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
                       const QModelIndex &destinationParent, int destinationColumn);
     void columnsRemoved(const QModelIndex &parent, int start, int end);
+    void layoutAboutToBeChanged(const QList<QPersistentModelIndex> &parents,
+                                QAbstractItemModel::LayoutChangeHint hint);
     void layoutChanged(const QList<QPersistentModelIndex> &parents,
                        QAbstractItemModel::LayoutChangeHint hint);
 
@@ -135,6 +148,16 @@ private:
     // the serialized index (move to sub-tree of source parent for example)
     // as operations can occur nested, we need to have a stack for this
     QList<Protocol::ModelIndex> m_preOpIndexes;
+    // rows of parents that are being sorted, to transfer the resulting permutation
+    // rather than invalidating the entire client-side cache
+    struct PendingPermutation {
+        QPersistentModelIndex parent;
+        // source row of each row, if the model is a sort proxy
+        QVector<int> sourceRows;
+        // otherwise, the rows themselves
+        QVector<QPersistentModelIndex> rows;
+    };
+    QVector<PendingPermutation> m_pendingPermutations;
     Protocol::ObjectAddress m_myAddress;
     bool m_monitored;
 };
@@ -35,3 +35,14 @@ bool SignalSpyCallbackSet::isNull() const
     return signalBeginCallback == nullptr && signalEndCallback == nullptr && slotBeginCallback == nullptr
            && slotEndCallback == nullptr;
 }
+
+void SignalSpyCallbackSet::subscribe(const QByteArray &className,
+                                     const QVector<QByteArray> &methodSignatures)
+{
+    subscriptions.push_back({ className, methodSignatures });
+}
+
+bool SignalSpyCallbackSet::hasSubscriptions() const
+{
+    return !subscriptions.isEmpty();
+}
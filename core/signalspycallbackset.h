@@ -31,7 +31,8 @@
 
 #include "gammaray_core_export.h"
 
-#include <qglobal.h>
+#include <QByteArray>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QObject;
@@ -54,6 +55,29 @@ struct GAMMARAY_CORE_EXPORT SignalSpyCallbackSet
     EndCallback signalEndCallback = nullptr;
     BeginCallback slotBeginCallback = nullptr;
     EndCallback slotEndCallback = nullptr;
+
+    /** Interest in methods of a class and all classes derived from it.
+     *  @since 2.12
+     */
+    struct Subscription
+    {
+        QByteArray className;
+        /** Normalized method signatures, empty for all methods. */
+        QVector<QByteArray> methodSignatures;
+    };
+
+    /** Restricts the callbacks to instances of @p className (or any class derived from it),
+     *  and if @p methodSignatures is not empty to those methods only.
+     *  Without any subscription the callbacks are invoked for all objects.
+     *  Emissions nobody subscribed to are then skipped by the probe with a single lookup,
+     *  instead of every callback having to filter them out itself.
+     *  @since 2.12
+     */
+    void subscribe(const QByteArray &className,
+                   const QVector<QByteArray> &methodSignatures = QVector<QByteArray>());
+    bool hasSubscriptions() const;
+
+    QVector<Subscription> subscriptions;
 };
 }
 
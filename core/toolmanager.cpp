@@ -41,6 +41,9 @@
 #include "tools/resourcebrowser/resourcebrowser.h"
 #include "tools/messagehandler/messagehandler.h"
 #include "tools/metaobjectbrowser/metaobjectbrowser.h"
+#include "tools/overheadmonitor/overheadmonitor.h"
+#include "tools/eventloopmonitor/eventloopmonitor.h"
+#include "tools/connectiontraffic/connectiontraffic.h"
 
 #include <compat/qasconst.h>
 
@@ -64,6 +67,9 @@ ToolManager::ToolManager(QObject *parent)
     addToolFactory(new MetaTypeBrowserFactory(this));
     addToolFactory(new MessageHandlerFactory(this));
     addToolFactory(new ProblemReporterFactory(this));
+    addToolFactory(new OverheadMonitorFactory(this));
+    addToolFactory(new EventLoopMonitorFactory(this));
+    addToolFactory(new ConnectionTrafficFactory(this));
 
     Q_FOREACH (ToolFactory *factory, m_toolPluginManager->plugins())
         addToolFactory(factory);
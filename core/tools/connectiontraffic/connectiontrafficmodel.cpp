@@ -0,0 +1,203 @@
+/*
+  connectiontrafficmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectiontrafficmodel.h"
+
+#include <common/modelevent.h>
+
+#include <QTimer>
+
+using namespace GammaRay;
+
+namespace {
+enum Columns {
+    SignalColumn,
+    SlotColumn,
+    SenderThreadColumn,
+    ReceiverThreadColumn,
+    DeliveriesColumn,
+    TotalWaitColumn,
+    MedianWaitColumn,
+    P99WaitColumn,
+    MaxWaitColumn,
+    TotalEmitCostColumn,
+    MedianEmitCostColumn,
+    ColumnCount
+};
+}
+
+static double toMSecs(qint64 nsecs)
+{
+    return qRound(nsecs / 10000.0) / 100.0;
+}
+
+static double toUSecs(qint64 nsecs)
+{
+    return qRound(nsecs / 10.0) / 100.0;
+}
+
+ConnectionTrafficModel::ConnectionTrafficModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &ConnectionTrafficModel::refresh);
+}
+
+ConnectionTrafficModel::~ConnectionTrafficModel()
+{
+    ConnectionTrafficRecorder::setEnabled(false);
+}
+
+int ConnectionTrafficModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int ConnectionTrafficModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_edges.size();
+}
+
+QVariant ConnectionTrafficModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const auto &edge = m_edges.at(index.row());
+    switch (index.column()) {
+    case SignalColumn:
+        if (edge.signal.isEmpty())
+            return tr("<invokeMethod>");
+        return QString(edge.senderClass + QLatin1String("::") + QString::fromLatin1(edge.signal));
+    case SlotColumn:
+        if (edge.slot.isEmpty())
+            return tr("%1 <functor>").arg(edge.receiverClass);
+        return QString(edge.receiverClass + QLatin1String("::") + QString::fromLatin1(edge.slot));
+    case SenderThreadColumn:
+        return edge.senderThread;
+    case ReceiverThreadColumn:
+        return edge.receiverThread;
+    case DeliveriesColumn:
+        return edge.deliveries;
+    case TotalWaitColumn:
+        return toMSecs(edge.queueWait.total);
+    case MedianWaitColumn:
+        return toUSecs(edge.queueWait.percentile(50));
+    case P99WaitColumn:
+        return toUSecs(edge.queueWait.percentile(99));
+    case MaxWaitColumn:
+        return toMSecs(edge.queueWait.max);
+    case TotalEmitCostColumn:
+        return toMSecs(edge.emitCost.total);
+    case MedianEmitCostColumn:
+        return toUSecs(edge.emitCost.percentile(50));
+    }
+    return QVariant();
+}
+
+QVariant ConnectionTrafficModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (role == Qt::DisplayRole) {
+        switch (section) {
+        case SignalColumn:
+            return tr("Signal");
+        case SlotColumn:
+            return tr("Slot");
+        case SenderThreadColumn:
+            return tr("Sender Thread");
+        case ReceiverThreadColumn:
+            return tr("Receiver Thread");
+        case DeliveriesColumn:
+            return tr("Deliveries");
+        case TotalWaitColumn:
+            return tr("Wait Total [ms]");
+        case MedianWaitColumn:
+            return tr("Wait Median [µs]");
+        case P99WaitColumn:
+            return tr("Wait 99% [µs]");
+        case MaxWaitColumn:
+            return tr("Wait Max [ms]");
+        case TotalEmitCostColumn:
+            return tr("Emit Total [ms]");
+        case MedianEmitCostColumn:
+            return tr("Emit Median [µs]");
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (section) {
+        case TotalWaitColumn:
+        case MedianWaitColumn:
+        case P99WaitColumn:
+        case MaxWaitColumn:
+            return tr("Time from the signal emission to the delivery of the queued call. "
+                      "Percentiles are rounded up to the next power of two nanoseconds.");
+        case TotalEmitCostColumn:
+        case MedianEmitCostColumn:
+            return tr("Time spent in the emission outside of directly connected slots, "
+                      "mostly copying the arguments for the queued calls. "
+                      "It is shared evenly among the queued connections of an emission.");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void ConnectionTrafficModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool used = static_cast<ModelEvent *>(event)->used();
+        ConnectionTrafficRecorder::setEnabled(used);
+        if (used) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    }
+    QAbstractTableModel::customEvent(event);
+}
+
+void ConnectionTrafficModel::refresh()
+{
+    // edges are only ever appended
+    const auto edges = ConnectionTrafficRecorder::edges();
+    const auto oldSize = m_edges.size();
+    if (edges.size() > oldSize) {
+        beginInsertRows(QModelIndex(), oldSize, edges.size() - 1);
+        m_edges = edges;
+        endInsertRows();
+    } else {
+        m_edges = edges;
+    }
+    if (oldSize > 0)
+        emit dataChanged(index(0, DeliveriesColumn), index(oldSize - 1, ColumnCount - 1));
+}
@@ -0,0 +1,66 @@
+/*
+  connectiontrafficmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICMODEL_H
+#define GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICMODEL_H
+
+#include "connectiontrafficrecorder.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Queued connection edges and their traffic, recording is enabled while this model is in use. */
+class ConnectionTrafficModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit ConnectionTrafficModel(QObject *parent = nullptr);
+    ~ConnectionTrafficModel() override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    void customEvent(QEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QVector<ConnectionTrafficRecorder::Edge> m_edges;
+    QTimer *m_refreshTimer;
+};
+}
+
+#endif // GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICMODEL_H
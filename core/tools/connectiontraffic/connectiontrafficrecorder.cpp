@@ -0,0 +1,553 @@
+/*
+  connectiontrafficrecorder.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectiontrafficrecorder.h"
+
+#include <core/probe.h>
+#include <core/signalspycallbackset.h>
+#include <core/util.h>
+#include <common/commonutils.h>
+
+#include <compat/qasconst.h>
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaMethod>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
+#include <QSet>
+#include <QThread>
+#include <QThreadStorage>
+
+#include <QInternal>
+#include <QtCore/private/qobject_p.h>
+#include <QtCore/private/qmetaobject_p.h>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+namespace {
+// beyond that the deliveries are lagging behind too much to be matched to their emissions
+const int MaxPendingEmissions = 1024;
+// emissions whose end callback we missed are dropped once the stack gets that deep
+const int MaxEmissionDepth = 64;
+const int MaxEdges = 2000;
+
+// classes are identified by their static meta object, QML creates dynamic ones per instance,
+// methods by their signature, as the same index means different things in different QML types
+struct EdgeKey
+{
+    const QMetaObject *senderClass;
+    QByteArray signal;
+    const QMetaObject *receiverClass;
+    QByteArray slot;
+    const QThread *senderThread;
+    const QThread *receiverThread;
+
+    bool operator==(const EdgeKey &other) const
+    {
+        return senderClass == other.senderClass && signal == other.signal
+               && receiverClass == other.receiverClass && slot == other.slot
+               && senderThread == other.senderThread && receiverThread == other.receiverThread;
+    }
+};
+
+uint qHash(const EdgeKey &key, uint seed = 0)
+{
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.senderClass));
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.signal));
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.receiverClass));
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.slot));
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.senderThread));
+    seed = CommonUtils::hashCombine(seed, ::qHash(key.receiverThread));
+    return seed;
+}
+
+// a queued connection between two objects, learned from its deliveries,
+// its emissions wait here until delivered
+struct Route
+{
+    const QObject *receiver;
+    int slotIndex;
+    int edge;
+    const QThread *receiverThread; // as of the last delivery
+    const QThread *emissionThread; // of the last emission
+    bool queued; // explicitly queued, posts an event even within the receiver thread
+    bool posted; // by the last emission
+    QQueue<qint64> pendingEmissions;
+};
+
+struct Sender
+{
+    QHash<int, QVector<Route> > routes; // keyed by signal index
+};
+
+struct EdgeStatistics
+{
+    quint64 deliveries = 0;
+    ConnectionTrafficRecorder::Histogram queueWait;
+    ConnectionTrafficRecorder::Histogram emitCost;
+};
+
+// Routes are spread over independently locked shards by sender address, so emissions of
+// different senders don't contend. They can't be kept per thread, signals can be emitted
+// from any thread, not just the one the sender lives in.
+const int SenderShardCount = 64;
+
+struct SenderShard
+{
+    QMutex mutex;
+    QHash<const QObject *, Sender> senders;
+    QHash<int, EdgeStatistics> statistics; // keyed by edge
+};
+
+struct Registry
+{
+    QMutex mutex; // for edges and new routes, neither emissions nor known routes need it
+    SenderShard shards[SenderShardCount];
+    QSet<const QObject *> receivers;
+    QHash<QPair<const QObject *, int>, int> invocationEdges; // deliveries without sender, by receiver and slot
+    QHash<EdgeKey, int> edgeIndexes;
+    QVector<ConnectionTrafficRecorder::Edge> edges;
+};
+
+struct Emission
+{
+    const QObject *sender;
+    int methodIndex;
+    int signalIndex;
+    int generation;
+    qint64 start;
+    qint64 slotStart;
+    qint64 slotTime;
+    int slotDepth;
+};
+}
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+static QThreadStorage<QVector<Emission> > s_emissions;
+static QAtomicInt s_enabled;
+static QAtomicInt s_generation; // bumped whenever in-flight measurements become invalid
+static QAtomicInt s_routeCount;
+
+static const QElapsedTimer &monotonicClock()
+{
+    static const QElapsedTimer timer = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer;
+}
+
+static QString threadName(const QThread *thread)
+{
+    if (!thread)
+        return QString();
+    if (QCoreApplication::instance() && QCoreApplication::instance()->thread() == thread)
+        return QObject::tr("Main thread");
+    if (!thread->objectName().isEmpty())
+        return thread->objectName();
+    return QStringLiteral("%1 (0x%2)").arg(QString::fromLatin1(thread->metaObject()->className()),
+                                           QString::number(quintptr(thread), 16));
+}
+
+static QByteArray slotSignature(const QObject *receiver, int slotIndex)
+{
+    if (slotIndex < 0)
+        return QByteArray();
+    return receiver->metaObject()->method(slotIndex).methodSignature();
+}
+
+static SenderShard &senderShard(const QObject *sender)
+{
+    // the low bits are the same for all objects due to alignment
+    return s_registry()->shards[(quintptr(sender) >> 4) % SenderShardCount];
+}
+
+static void removeRoutes(Sender &sender)
+{
+    for (const auto &routes : qAsConst(sender.routes))
+        s_routeCount.fetchAndSubRelaxed(routes.size());
+    sender.routes.clear();
+}
+
+// registry mutex must be locked
+static int edgeIndex(const EdgeKey &key, const QString &senderThreadName)
+{
+    auto registry = s_registry();
+    const auto it = registry->edgeIndexes.constFind(key);
+    if (it != registry->edgeIndexes.constEnd())
+        return it.value();
+    if (registry->edges.size() >= MaxEdges)
+        return -1;
+
+    ConnectionTrafficRecorder::Edge edge;
+    if (key.senderClass)
+        edge.senderClass = QString::fromLatin1(key.senderClass->className());
+    edge.signal = key.signal;
+    edge.senderThread = senderThreadName;
+    edge.receiverClass = QString::fromLatin1(key.receiverClass->className());
+    edge.slot = key.slot;
+    edge.receiverThread = threadName(key.receiverThread);
+
+    registry->edges.push_back(edge);
+    registry->edgeIndexes.insert(key, registry->edges.size() - 1);
+    return registry->edges.size() - 1;
+}
+
+// shard mutex must be locked, called from the emitting thread right before Qt posts the events
+static void enqueueEmission(QVector<Route> &routes, qint64 now)
+{
+    const auto currentThread = QThread::currentThread();
+    for (auto &route : routes) {
+        // the same decision QMetaObject::activate makes, with what the deliveries told us
+        // about the connection type
+        route.emissionThread = currentThread;
+        route.posted = route.queued || route.receiverThread != currentThread;
+        if (!route.posted)
+            continue;
+        if (route.pendingEmissions.size() >= MaxPendingEmissions)
+            route.pendingEmissions.clear();
+        route.pendingEmissions.enqueue(now);
+    }
+}
+
+static void signalBegin(QObject *caller, int methodIndex, void **argv)
+{
+    Q_UNUSED(argv);
+    if (!s_enabled.loadAcquire() || !s_routeCount.loadAcquire())
+        return;
+
+    const auto now = monotonicClock().nsecsElapsed();
+    int signalIndex;
+    {
+        auto &shard = senderShard(caller);
+        QMutexLocker lock(&shard.mutex);
+        const auto sender = shard.senders.find(caller);
+        if (sender == shard.senders.end())
+            return;
+        signalIndex = QMetaObjectPrivate::signalIndex(caller->metaObject()->method(methodIndex));
+        const auto routes = sender->routes.find(signalIndex);
+        if (routes == sender->routes.end())
+            return;
+        if (!QObjectPrivate::get(caller)->isSignalConnected(signalIndex)) {
+            // all connections are gone, new ones are learned from their deliveries again
+            s_routeCount.fetchAndSubRelaxed(routes->size());
+            sender->routes.erase(routes);
+            return;
+        }
+        enqueueEmission(*routes, now);
+    }
+
+    auto &emissions = s_emissions.localData();
+    if (emissions.size() >= MaxEmissionDepth)
+        emissions.clear();
+    // our own bookkeeping above is not part of the emission cost
+    emissions.push_back({ caller, methodIndex, signalIndex, s_generation.loadAcquire(), monotonicClock().nsecsElapsed(), 0, 0, 0 });
+}
+
+static void signalEnd(QObject *caller, int methodIndex)
+{
+    // caller might be gone already, it must not be dereferenced here
+    if (!s_enabled.loadAcquire() || !s_emissions.hasLocalData())
+        return;
+
+    const auto now = monotonicClock().nsecsElapsed();
+    auto &emissions = s_emissions.localData();
+    int i = emissions.size() - 1;
+    while (i >= 0 && (emissions.at(i).sender != caller || emissions.at(i).methodIndex != methodIndex))
+        --i;
+    if (i < 0)
+        return; // not an emission with queued connections
+    const auto emission = emissions.at(i);
+    emissions.resize(i);
+    if (emission.generation != s_generation.loadAcquire() || emission.slotDepth != 0)
+        return;
+
+    auto &shard = senderShard(caller);
+    QMutexLocker lock(&shard.mutex);
+    const auto sender = shard.senders.constFind(caller);
+    if (sender == shard.senders.constEnd())
+        return;
+    const auto routes = sender->routes.constFind(emission.signalIndex);
+    if (routes == sender->routes.constEnd())
+        return;
+    // every posted event gets its own copy of the arguments
+    const auto posted = std::count_if(routes->begin(), routes->end(), [](const Route &route) {
+            return route.posted;
+        });
+    if (!posted)
+        return;
+    const auto share = (now - emission.start - emission.slotTime) / posted;
+    for (const auto &route : *routes) {
+        if (route.posted)
+            shard.statistics[route.edge].emitCost.add(share);
+    }
+}
+
+static void slotBegin(QObject *caller, int methodIndex, void **argv)
+{
+    Q_UNUSED(caller);
+    Q_UNUSED(methodIndex);
+    Q_UNUSED(argv);
+    if (!s_enabled.loadAcquire() || !s_emissions.hasLocalData())
+        return;
+    auto &emissions = s_emissions.localData();
+    if (emissions.isEmpty())
+        return;
+    auto &emission = emissions.last();
+    if (emission.slotDepth++ == 0)
+        emission.slotStart = monotonicClock().nsecsElapsed();
+}
+
+static void slotEnd(QObject *caller, int methodIndex)
+{
+    Q_UNUSED(caller);
+    Q_UNUSED(methodIndex);
+    if (!s_enabled.loadAcquire() || !s_emissions.hasLocalData())
+        return;
+    auto &emissions = s_emissions.localData();
+    if (emissions.isEmpty() || emissions.last().slotDepth == 0)
+        return;
+    auto &emission = emissions.last();
+    if (--emission.slotDepth == 0)
+        emission.slotTime += monotonicClock().nsecsElapsed() - emission.slotStart;
+}
+
+// shard mutex must be locked, returns false if the route is not known yet
+static bool recordDelivery(SenderShard &shard, const QObject *sender, int signalIndex,
+                           const QObject *receiver, int slotIndex, qint64 now)
+{
+    const auto senderIt = shard.senders.find(sender);
+    if (senderIt == shard.senders.end())
+        return false;
+    const auto routes = senderIt->routes.find(signalIndex);
+    if (routes == senderIt->routes.end())
+        return false;
+    const auto route = std::find_if(routes->begin(), routes->end(), [receiver, slotIndex](const Route &route) {
+            return route.receiver == receiver && route.slotIndex == slotIndex;
+        });
+    if (route == routes->end())
+        return false;
+
+    route->receiverThread = QThread::currentThread();
+    auto &statistics = shard.statistics[route->edge];
+    ++statistics.deliveries;
+    if (!route->pendingEmissions.isEmpty()) {
+        statistics.queueWait.add(now - route->pendingEmissions.dequeue());
+    } else if (route->emissionThread == route->receiverThread) {
+        // we assumed a direct call for that emission, but it posted an event
+        route->queued = true;
+    }
+    return true;
+}
+
+static bool eventNotifyCallback(void **data)
+{
+    if (!s_enabled.loadAcquire())
+        return false;
+
+    auto receiver = reinterpret_cast<QObject *>(data[0]);
+    auto event = reinterpret_cast<QEvent *>(data[1]);
+    if (!receiver || !event || event->type() != QEvent::MetaCall)
+        return false;
+    if (!Probe::instance() || Probe::instance()->filterObject(receiver))
+        return false;
+
+    const auto now = monotonicClock().nsecsElapsed();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const auto call = static_cast<QAbstractMetaCallEvent *>(event);
+    const auto slotCall = dynamic_cast<QMetaCallEvent *>(call);
+#else
+    const auto call = static_cast<QMetaCallEvent *>(event);
+    const auto slotCall = call;
+#endif
+    int slotIndex = slotCall ? slotCall->id() : -1;
+    if (slotIndex == int(ushort(-1)))
+        slotIndex = -1; // functor
+
+    const auto senderObject = call->sender();
+    const int signalId = call->signalId();
+    auto registry = s_registry();
+    if (!senderObject || signalId < 0) {
+        QMutexLocker lock(&registry->mutex);
+        const auto invocation = qMakePair<const QObject *, int>(receiver, slotIndex);
+        auto it = registry->invocationEdges.constFind(invocation);
+        if (it == registry->invocationEdges.constEnd()) {
+            const EdgeKey key = { nullptr, QByteArray(), Util::staticMetaObject(receiver), slotSignature(receiver, slotIndex),
+                                  nullptr, receiver->thread() };
+            it = registry->invocationEdges.insert(invocation, edgeIndex(key, QString()));
+            registry->receivers.insert(receiver);
+        }
+        if (it.value() >= 0)
+            ++registry->edges[it.value()].deliveries;
+        return false;
+    }
+
+    auto &shard = senderShard(senderObject);
+    {
+        QMutexLocker lock(&shard.mutex);
+        if (recordDelivery(shard, senderObject, signalId, receiver, slotIndex, now))
+            return false;
+    }
+
+    // the sender might be gone already, so only look at it while it is known to be valid
+    EdgeKey key = { nullptr, QByteArray(), Util::staticMetaObject(receiver), slotSignature(receiver, slotIndex),
+                    nullptr, receiver->thread() };
+    QString senderThreadName;
+    {
+        QMutexLocker objectLock(Probe::objectLock());
+        if (!Probe::instance() || !Probe::instance()->isValidObject(senderObject))
+            return false;
+        const auto metaObject = senderObject->metaObject();
+        key.senderClass = Util::staticMetaObject(senderObject);
+        key.signal = metaObject->method(Util::signalIndexToMethodIndex(metaObject, signalId)).methodSignature();
+        key.senderThread = senderObject->thread();
+        senderThreadName = threadName(key.senderThread);
+    }
+
+    // emissions are matched from now on, the ones already in the queue can't be
+    QMutexLocker lock(&registry->mutex);
+    const auto edge = edgeIndex(key, senderThreadName);
+    if (edge < 0)
+        return false;
+    registry->receivers.insert(receiver);
+
+    QMutexLocker shardLock(&shard.mutex);
+    // another delivery might have added the route meanwhile
+    if (recordDelivery(shard, senderObject, signalId, receiver, slotIndex, now))
+        return false;
+    const auto currentThread = QThread::currentThread();
+    shard.senders[senderObject].routes[signalId].push_back({ receiver, slotIndex, edge, currentThread, nullptr, false, false, QQueue<qint64>() });
+    s_routeCount.fetchAndAddRelaxed(1);
+    ++shard.statistics[edge].deliveries;
+    return false;
+}
+
+void ConnectionTrafficRecorder::registerCallbacks(Probe *probe)
+{
+    SignalSpyCallbackSet callbacks;
+    callbacks.signalBeginCallback = signalBegin;
+    callbacks.signalEndCallback = signalEnd;
+    callbacks.slotBeginCallback = slotBegin;
+    callbacks.slotEndCallback = slotEnd;
+    probe->registerSignalSpyCallbackSet(callbacks);
+}
+
+bool ConnectionTrafficRecorder::isEnabled()
+{
+    return s_enabled.loadAcquire();
+}
+
+void ConnectionTrafficRecorder::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled())
+        return;
+
+    if (enabled) {
+        s_generation.fetchAndAddRelease(1);
+        s_enabled.storeRelease(1);
+        QInternal::registerCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+    } else {
+        s_enabled.storeRelease(0);
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+        // emissions happening meanwhile are missing, the queues would be out of sync
+        auto registry = s_registry();
+        QMutexLocker lock(&registry->mutex);
+        for (auto &shard : registry->shards) {
+            QMutexLocker shardLock(&shard.mutex);
+            for (auto &sender : shard.senders)
+                removeRoutes(sender);
+            shard.senders.clear();
+        }
+        registry->receivers.clear();
+        registry->invocationEdges.clear();
+    }
+}
+
+QVector<ConnectionTrafficRecorder::Edge> ConnectionTrafficRecorder::edges()
+{
+    auto registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    auto edges = registry->edges;
+    for (auto &shard : registry->shards) {
+        QMutexLocker shardLock(&shard.mutex);
+        for (auto it = shard.statistics.constBegin(); it != shard.statistics.constEnd(); ++it) {
+            auto &edge = edges[it.key()];
+            edge.deliveries += it.value().deliveries;
+            edge.queueWait.merge(it.value().queueWait);
+            edge.emitCost.merge(it.value().emitCost);
+        }
+    }
+    return edges;
+}
+
+void ConnectionTrafficRecorder::objectDestroyed(QObject *obj)
+{
+    auto registry = s_registry();
+    QMutexLocker lock(&registry->mutex);
+    {
+        auto &shard = senderShard(obj);
+        QMutexLocker shardLock(&shard.mutex);
+        const auto sender = shard.senders.find(obj);
+        if (sender != shard.senders.end()) {
+            removeRoutes(*sender);
+            shard.senders.erase(sender);
+        }
+    }
+
+    if (!registry->receivers.remove(obj))
+        return;
+    for (auto it = registry->invocationEdges.begin(); it != registry->invocationEdges.end();) {
+        if (it.key().first == obj)
+            it = registry->invocationEdges.erase(it);
+        else
+            ++it;
+    }
+    for (auto &shard : registry->shards) {
+        QMutexLocker shardLock(&shard.mutex);
+        for (auto &sender : shard.senders) {
+            for (auto it = sender.routes.begin(); it != sender.routes.end();) {
+                auto &routes = it.value();
+                const auto oldSize = routes.size();
+                routes.erase(std::remove_if(routes.begin(), routes.end(), [obj](const Route &route) {
+                        return route.receiver == obj;
+                    }), routes.end());
+                s_routeCount.fetchAndSubRelaxed(oldSize - routes.size());
+                if (routes.isEmpty())
+                    it = sender.routes.erase(it);
+                else
+                    ++it;
+            }
+        }
+    }
+}
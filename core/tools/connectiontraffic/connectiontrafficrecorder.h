@@ -0,0 +1,94 @@
+/*
+  connectiontrafficrecorder.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICRECORDER_H
+#define GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICRECORDER_H
+
+#include <core/tools/eventloopmonitor/eventlooprecorder.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+class Probe;
+
+/**
+ * Traffic over queued connections, recorded from the signal spy callbacks and the
+ * event notification hook.
+ *
+ * Deliveries are aggregated per edge, that is per sender class and signal, receiver class
+ * and slot, and sender and receiver thread. Queued connections between two objects are learned
+ * from the QMetaCallEvents delivered for them. From then on, the times of the emissions that
+ * post an event for such a connection are kept in a FIFO, so the time an emission waited for its
+ * delivery can be measured. Whether an emission posts an event is derived from the receiver
+ * thread seen in the deliveries, like QMetaObject::activate() does for auto connections.
+ * The time spent in an emission outside of directly connected slots is dominated by copying
+ * the arguments into the posted events, it is shared among the queued connections of the emission.
+ *
+ * Recording is disabled by default, all methods are thread-safe.
+ */
+class ConnectionTrafficRecorder
+{
+public:
+    using Histogram = EventLoopRecorder::Histogram;
+
+    struct Edge
+    {
+        QString senderClass;
+        QByteArray signal; // empty for QMetaObject::invokeMethod
+        QString receiverClass;
+        QByteArray slot; // empty for functors
+        QString senderThread;
+        QString receiverThread;
+        quint64 deliveries = 0;
+        Histogram queueWait;
+        Histogram emitCost;
+    };
+
+    /// Installs the signal spy callbacks, needed once per probe.
+    static void registerCallbacks(Probe *probe);
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    /// All edges, in the order they were first seen. Edges are never removed.
+    static QVector<Edge> edges();
+
+    /// Forgets the queued connections of @p obj, it must not be dereferenced.
+    static void objectDestroyed(QObject *obj);
+
+private:
+    ConnectionTrafficRecorder() = delete;
+};
+}
+
+#endif // GAMMARAY_CONNECTIONTRAFFIC_CONNECTIONTRAFFICRECORDER_H
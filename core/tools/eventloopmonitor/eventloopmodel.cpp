@@ -0,0 +1,207 @@
+/*
+  eventloopmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopmodel.h"
+
+#include <common/modelevent.h>
+
+#include <QTimer>
+
+using namespace GammaRay;
+
+namespace {
+enum Columns {
+    ThreadColumn,
+    EventsColumn,
+    BusyTimeColumn,
+    MedianTimeColumn,
+    P99TimeColumn,
+    MaxTimeColumn,
+    MedianLatencyColumn,
+    P99LatencyColumn,
+    MaxLatencyColumn,
+    StallsColumn,
+    ColumnCount
+};
+}
+
+static double toMSecs(qint64 nsecs)
+{
+    return qRound(nsecs / 10000.0) / 100.0;
+}
+
+static double toUSecs(qint64 nsecs)
+{
+    return qRound(nsecs / 10.0) / 100.0;
+}
+
+EventLoopModel::EventLoopModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_refreshTimer(new QTimer(this))
+    , m_heartbeatTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &EventLoopModel::refresh);
+    m_heartbeatTimer->setInterval(250);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &EventLoopRecorder::postHeartbeats);
+}
+
+EventLoopModel::~EventLoopModel()
+{
+    EventLoopRecorder::setEnabled(false);
+}
+
+int EventLoopModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int EventLoopModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_threads.size();
+}
+
+QVariant EventLoopModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const auto &thread = m_threads.at(index.row());
+    switch (index.column()) {
+    case ThreadColumn:
+        return thread.name;
+    case EventsColumn:
+        return thread.handlerTime.count;
+    case BusyTimeColumn:
+        return toMSecs(thread.handlerTime.total);
+    case MedianTimeColumn:
+        return toUSecs(thread.handlerTime.percentile(50));
+    case P99TimeColumn:
+        return toUSecs(thread.handlerTime.percentile(99));
+    case MaxTimeColumn:
+        return toMSecs(thread.handlerTime.max);
+    case MedianLatencyColumn:
+        return toMSecs(thread.dispatchLatency.percentile(50));
+    case P99LatencyColumn:
+        return toMSecs(thread.dispatchLatency.percentile(99));
+    case MaxLatencyColumn:
+        return toMSecs(thread.dispatchLatency.max);
+    case StallsColumn:
+        return thread.stalls;
+    }
+    return QVariant();
+}
+
+QVariant EventLoopModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (role == Qt::DisplayRole) {
+        switch (section) {
+        case ThreadColumn:
+            return tr("Thread");
+        case EventsColumn:
+            return tr("Events");
+        case BusyTimeColumn:
+            return tr("Busy [ms]");
+        case MedianTimeColumn:
+            return tr("Median [µs]");
+        case P99TimeColumn:
+            return tr("99% [µs]");
+        case MaxTimeColumn:
+            return tr("Max [ms]");
+        case MedianLatencyColumn:
+            return tr("Latency Median [ms]");
+        case P99LatencyColumn:
+            return tr("Latency 99% [ms]");
+        case MaxLatencyColumn:
+            return tr("Latency Max [ms]");
+        case StallsColumn:
+            return tr("Stalls");
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (section) {
+        case BusyTimeColumn:
+        case MedianTimeColumn:
+        case P99TimeColumn:
+        case MaxTimeColumn:
+            return tr("Time from an event delivery to the next one, or to the event loop going idle. "
+                      "Percentiles are rounded up to the next power of two nanoseconds.");
+        case MedianLatencyColumn:
+        case P99LatencyColumn:
+        case MaxLatencyColumn:
+            return tr("Time a posted event waits in the event queue of the thread.");
+        case StallsColumn:
+            return tr("Number of event deliveries taking longer than %1 ms.").arg(EventLoopRecorder::stallThreshold());
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void EventLoopModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool used = static_cast<ModelEvent *>(event)->used();
+        // statistics cover the time the view is open, not some earlier session
+        if (used)
+            EventLoopRecorder::reset();
+        EventLoopRecorder::setEnabled(used);
+        if (used) {
+            refresh();
+            m_refreshTimer->start();
+            m_heartbeatTimer->start();
+        } else {
+            m_refreshTimer->stop();
+            m_heartbeatTimer->stop();
+        }
+    }
+    QAbstractTableModel::customEvent(event);
+}
+
+void EventLoopModel::refresh()
+{
+    const auto threads = EventLoopRecorder::threadStatistics();
+
+    bool sameThreads = threads.size() == m_threads.size();
+    for (int i = 0; sameThreads && i < threads.size(); ++i)
+        sameThreads = threads.at(i).id == m_threads.at(i).id;
+
+    if (!sameThreads) {
+        beginResetModel();
+        m_threads = threads;
+        endResetModel();
+        return;
+    }
+
+    m_threads = threads;
+    if (!m_threads.isEmpty())
+        emit dataChanged(index(0, EventsColumn), index(m_threads.size() - 1, StallsColumn));
+}
@@ -0,0 +1,67 @@
+/*
+  eventloopmodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMODEL_H
+#define GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMODEL_H
+
+#include "eventlooprecorder.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Per-thread event loop statistics, recording is enabled while this model is in use. */
+class EventLoopModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit EventLoopModel(QObject *parent = nullptr);
+    ~EventLoopModel() override;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    void customEvent(QEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QVector<EventLoopRecorder::ThreadStatistics> m_threads;
+    QTimer *m_refreshTimer;
+    QTimer *m_heartbeatTimer;
+};
+}
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPMODEL_H
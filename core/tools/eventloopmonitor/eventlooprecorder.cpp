@@ -0,0 +1,438 @@
+/*
+  eventlooprecorder.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventlooprecorder.h"
+
+#include <core/execution.h>
+
+#include <compat/qasconst.h>
+
+#include <QAbstractEventDispatcher>
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMutex>
+#include <QHash>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadStorage>
+
+#include <QInternal>
+
+#include <private/qobject_p.h>
+#include <private/qthread_p.h>
+
+using namespace GammaRay;
+
+namespace {
+// the most recent stalls are kept, older ones are dropped
+const int MaxStalls = 200;
+// bound for the cache of dynamic meta objects, those are often created per instance
+const int MaxCachedMetaObjects = 4096;
+
+struct ThreadState
+{
+    // set on creation
+    quintptr id = 0;
+    QString name;
+
+    // only accessed by the recorded thread itself
+    qint64 segmentStart = -1;
+    int segmentGeneration = 0;
+    int segmentDepth = 0;
+    const QObject *segmentReceiver = nullptr;
+    const QMetaObject *segmentClass = nullptr;
+    int segmentEventType = 0;
+    QHash<const QMetaObject *, bool> readOnlyMetaObjects;
+
+    // guarded by the registry mutex
+    QAbstractEventDispatcher *dispatcher = nullptr;
+    QMetaObject::Connection blockHook;
+
+    QAtomicInt blockHookInstalled;
+    QAtomicInt heartbeatPending;
+
+    QMutex mutex; // guards statistics
+    EventLoopRecorder::ThreadStatistics statistics;
+};
+using ThreadStatePtr = QSharedPointer<ThreadState>;
+
+struct Registry
+{
+    QMutex mutex;
+    QVector<ThreadStatePtr> threads;
+    QVector<EventLoopRecorder::Stall> stalls;
+    quint64 nextStallSerial = 0;
+};
+
+// owned by the thread local storage, unregisters the thread once it finishes
+struct ThreadStateHolder
+{
+    ~ThreadStateHolder();
+    ThreadStatePtr state;
+};
+
+class HeartbeatEvent : public QEvent
+{
+public:
+    HeartbeatEvent(QEvent::Type type, qint64 postedAt, int generation)
+        : QEvent(type)
+        , postedAt(postedAt)
+        , generation(generation)
+    {
+    }
+
+    const qint64 postedAt;
+    const int generation;
+};
+}
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+static QThreadStorage<ThreadStateHolder *> s_threadStates;
+static QAtomicInt s_enabled;
+static QAtomicInt s_generation; // bumped whenever in-flight measurements become invalid
+static QAtomicInt s_stallThreshold(50);
+
+ThreadStateHolder::~ThreadStateHolder()
+{
+    if (s_registry.isDestroyed())
+        return;
+    QMutexLocker lock(&s_registry()->mutex);
+    QObject::disconnect(state->blockHook);
+    state->dispatcher = nullptr;
+    s_registry()->threads.removeOne(state);
+}
+
+// the notify hook has no counterpart at the end of a delivery, so nesting is derived from
+// the levels Qt tracks for deferred deletion, counting running event loops and active
+// deliveries (the latter in loopLevel or scopeLevel, depending on the Qt version)
+template<typename T>
+static auto scopeLevel(const T *data, int) -> decltype(data->scopeLevel)
+{
+    return data->scopeLevel;
+}
+
+template<typename T>
+static int scopeLevel(const T *, long)
+{
+    return 0;
+}
+
+static int deliveryDepth()
+{
+    const auto data = QThreadData::current();
+    return data->loopLevel + scopeLevel(data, 0);
+}
+
+static const QElapsedTimer &monotonicClock()
+{
+    static const QElapsedTimer timer = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer;
+}
+
+static QEvent::Type heartbeatEventType()
+{
+    static const auto type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
+
+void EventLoopRecorder::Histogram::add(qint64 nsecs)
+{
+    const auto value = quint64(qMax<qint64>(nsecs, 0));
+    int bucket = 0;
+    for (auto v = value >> 1; v && bucket < BucketCount - 1; v >>= 1)
+        ++bucket;
+    ++buckets[bucket];
+    ++count;
+    total += value;
+    max = qMax(max, value);
+}
+
+void EventLoopRecorder::Histogram::merge(const Histogram &other)
+{
+    for (int bucket = 0; bucket < BucketCount; ++bucket)
+        buckets[bucket] += other.buckets[bucket];
+    count += other.count;
+    total += other.total;
+    max = qMax(max, other.max);
+}
+
+qint64 EventLoopRecorder::Histogram::percentile(int percent) const
+{
+    if (!count)
+        return 0;
+
+    const auto rank = (count * percent + 99) / 100;
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return qint64(qMin((quint64(2) << bucket) - 1, max));
+    }
+    return qint64(max);
+}
+
+static const ThreadStatePtr &currentThreadState()
+{
+    if (s_threadStates.hasLocalData())
+        return s_threadStates.localData()->state;
+
+    auto holder = new ThreadStateHolder;
+    holder->state.reset(new ThreadState);
+    const auto thread = QThread::currentThread();
+    auto &state = holder->state;
+    state->id = quintptr(thread);
+    state->name = thread->objectName();
+    if (state->name.isEmpty()) {
+        if (QCoreApplication::instance() && QCoreApplication::instance()->thread() == thread)
+            state->name = QObject::tr("Main thread");
+        else
+            state->name = QStringLiteral("%1 (0x%2)").arg(QString::fromLatin1(thread->metaObject()->className()),
+                                                          QString::number(quintptr(thread), 16));
+    }
+    state->statistics.id = state->id;
+    state->statistics.name = state->name;
+    s_threadStates.setLocalData(holder);
+
+    QMutexLocker lock(&s_registry()->mutex);
+    s_registry()->threads.push_back(state);
+    return state;
+}
+
+static void closeSegment(ThreadState *state, qint64 now)
+{
+    if (state->segmentStart < 0)
+        return;
+
+    const auto duration = now - state->segmentStart;
+    state->segmentStart = -1;
+    if (state->segmentGeneration != s_generation.loadAcquire())
+        return;
+
+    const bool stalled = duration >= qint64(s_stallThreshold.loadAcquire()) * 1000000;
+    {
+        QMutexLocker lock(&state->mutex);
+        state->statistics.handlerTime.add(duration);
+        if (stalled)
+            ++state->statistics.stalls;
+    }
+    if (!stalled)
+        return;
+
+    // the receiver might be gone by now, so don't touch it beyond its address
+    EventLoopRecorder::Stall stall;
+    stall.time = QTime::currentTime();
+    stall.thread = state->name;
+    stall.receiver = QStringLiteral("%1 (0x%2)").arg(QString::fromLatin1(state->segmentClass->className()),
+                                                     QString::number(quintptr(state->segmentReceiver), 16));
+    stall.eventType = state->segmentEventType;
+    stall.duration = duration;
+
+    QMutexLocker lock(&s_registry()->mutex);
+    auto registry = s_registry();
+    stall.serial = registry->nextStallSerial++;
+    if (registry->stalls.size() >= MaxStalls)
+        registry->stalls.removeFirst();
+    registry->stalls.push_back(stall);
+}
+
+// same as Util::staticMetaObject(), but remembers which meta objects are static,
+// finding that out is too expensive to do for every event
+static const QMetaObject *staticMetaObject(ThreadState *state, const QObject *object)
+{
+    auto metaObject = object->metaObject();
+    if (!QObjectPrivate::get(const_cast<QObject *>(object))->metaObject)
+        return metaObject;
+
+    if (state->readOnlyMetaObjects.size() > MaxCachedMetaObjects)
+        state->readOnlyMetaObjects.clear();
+    for (; metaObject; metaObject = metaObject->superClass()) {
+        auto it = state->readOnlyMetaObjects.constFind(metaObject);
+        if (it == state->readOnlyMetaObjects.constEnd())
+            it = state->readOnlyMetaObjects.insert(metaObject, Execution::isReadOnlyData(metaObject));
+        if (it.value())
+            return metaObject;
+    }
+    return &QObject::staticMetaObject;
+}
+
+static void installBlockHook(const ThreadStatePtr &state)
+{
+    QMutexLocker lock(&s_registry()->mutex);
+    // re-check under the lock, disabling removes all hooks
+    if (!s_enabled.loadAcquire())
+        return;
+
+    state->blockHookInstalled.storeRelease(1);
+    auto dispatcher = QAbstractEventDispatcher::instance();
+    if (!dispatcher)
+        return;
+    state->dispatcher = dispatcher;
+    state->blockHook = QObject::connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, [state]() {
+        if (s_enabled.loadAcquire())
+            closeSegment(state.data(), monotonicClock().nsecsElapsed());
+    });
+}
+
+static bool eventNotifyCallback(void **data)
+{
+    if (!s_enabled.loadAcquire())
+        return false;
+
+    auto receiver = reinterpret_cast<QObject *>(data[0]);
+    auto event = reinterpret_cast<QEvent *>(data[1]);
+    if (!receiver || !event)
+        return false;
+
+    const auto now = monotonicClock().nsecsElapsed();
+    const auto generation = s_generation.loadAcquire();
+    const auto &state = currentThreadState();
+    if (!state->blockHookInstalled.loadAcquire())
+        installBlockHook(state);
+
+    // events sent from within the handler of the open segment are part of it, the
+    // stall belongs to the outermost delivery
+    const auto depth = deliveryDepth();
+    const bool nested = state->segmentStart >= 0 && depth > state->segmentDepth;
+    if (!nested)
+        closeSegment(state.data(), now);
+
+    if (event->type() == heartbeatEventType()) {
+        const auto heartbeat = static_cast<HeartbeatEvent *>(event);
+        state->heartbeatPending.storeRelease(0);
+        if (heartbeat->generation == generation) {
+            QMutexLocker lock(&state->mutex);
+            state->statistics.dispatchLatency.add(now - heartbeat->postedAt);
+        }
+        return true; // not meant for the receiver
+    }
+    if (nested)
+        return false;
+
+    state->segmentStart = now;
+    state->segmentGeneration = generation;
+    state->segmentDepth = depth;
+    state->segmentReceiver = receiver;
+    // dynamic meta objects die with their instance, which might happen before the segment ends
+    state->segmentClass = staticMetaObject(state.data(), receiver);
+    state->segmentEventType = event->type();
+    return false;
+}
+
+bool EventLoopRecorder::isEnabled()
+{
+    return s_enabled.loadAcquire();
+}
+
+void EventLoopRecorder::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled())
+        return;
+
+    if (enabled) {
+        s_generation.fetchAndAddRelease(1);
+        {
+            QMutexLocker lock(&s_registry()->mutex);
+            for (const auto &state : qAsConst(s_registry()->threads))
+                state->heartbeatPending.storeRelease(0);
+        }
+        s_enabled.storeRelease(1);
+        QInternal::registerCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+    } else {
+        s_enabled.storeRelease(0);
+        QInternal::unregisterCallback(QInternal::EventNotifyCallback, eventNotifyCallback);
+        // nothing of ours stays connected while disabled, the hooks are reinstalled on the next event
+        QMutexLocker lock(&s_registry()->mutex);
+        for (const auto &state : qAsConst(s_registry()->threads)) {
+            QObject::disconnect(state->blockHook);
+            state->blockHookInstalled.storeRelease(0);
+        }
+    }
+}
+
+void EventLoopRecorder::reset()
+{
+    s_generation.fetchAndAddRelease(1);
+
+    QMutexLocker lock(&s_registry()->mutex);
+    for (const auto &state : qAsConst(s_registry()->threads)) {
+        QMutexLocker stateLock(&state->mutex);
+        state->statistics = ThreadStatistics();
+        state->statistics.id = state->id;
+        state->statistics.name = state->name;
+    }
+    s_registry()->stalls.clear();
+}
+
+int EventLoopRecorder::stallThreshold()
+{
+    return s_stallThreshold.loadAcquire();
+}
+
+void EventLoopRecorder::setStallThreshold(int msecs)
+{
+    s_stallThreshold.storeRelease(qMax(1, msecs));
+}
+
+QVector<EventLoopRecorder::ThreadStatistics> EventLoopRecorder::threadStatistics()
+{
+    QVector<ThreadStatistics> result;
+    QMutexLocker lock(&s_registry()->mutex);
+    result.reserve(s_registry()->threads.size());
+    for (const auto &state : qAsConst(s_registry()->threads)) {
+        QMutexLocker stateLock(&state->mutex);
+        result.push_back(state->statistics);
+    }
+    return result;
+}
+
+QVector<EventLoopRecorder::Stall> EventLoopRecorder::stalls()
+{
+    QMutexLocker lock(&s_registry()->mutex);
+    return s_registry()->stalls;
+}
+
+void EventLoopRecorder::postHeartbeats()
+{
+    if (!isEnabled())
+        return;
+
+    const auto now = monotonicClock().nsecsElapsed();
+    const auto generation = s_generation.loadAcquire();
+    QMutexLocker lock(&s_registry()->mutex);
+    for (const auto &state : qAsConst(s_registry()->threads)) {
+        // don't pile up markers on a thread that is stuck anyway
+        if (!state->dispatcher || !state->heartbeatPending.testAndSetAcquire(0, 1))
+            continue;
+        QCoreApplication::postEvent(state->dispatcher, new HeartbeatEvent(heartbeatEventType(), now, generation));
+    }
+}
@@ -0,0 +1,106 @@
+/*
+  eventlooprecorder.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPRECORDER_H
+#define GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPRECORDER_H
+
+#include <QString>
+#include <QTime>
+#include <QVector>
+
+namespace GammaRay {
+/**
+ * Per-thread event loop timing, recorded from the event notification hook.
+ *
+ * The time from one event delivery to the next one, or to the event loop going to sleep,
+ * is attributed to the receiver of the earlier event. Segments longer than the stall
+ * threshold are kept as stalls. Dispatch latency is measured by posting a marker event
+ * to every known thread and timing its delivery.
+ *
+ * Recording is disabled by default, all methods are thread-safe.
+ */
+class EventLoopRecorder
+{
+public:
+    /// Power of two buckets of nanosecond durations, cheap enough to update for every event.
+    struct Histogram
+    {
+        enum { BucketCount = 40 };
+
+        void add(qint64 nsecs);
+        /// Adds the values recorded by @p other.
+        void merge(const Histogram &other);
+        /// Upper bound of the bucket containing the given percentile, in nanoseconds.
+        qint64 percentile(int percent) const;
+
+        quint64 buckets[BucketCount] = {};
+        quint64 count = 0;
+        quint64 total = 0;
+        quint64 max = 0;
+    };
+
+    struct ThreadStatistics
+    {
+        quintptr id = 0;
+        QString name;
+        Histogram handlerTime;
+        Histogram dispatchLatency;
+        quint64 stalls = 0;
+    };
+
+    struct Stall
+    {
+        quint64 serial = 0;
+        QTime time;
+        QString thread;
+        QString receiver;
+        int eventType = 0;
+        qint64 duration = 0; // nanoseconds
+    };
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+    /// Discards all statistics and stalls recorded so far.
+    static void reset();
+
+    static int stallThreshold();
+    /// Sets the minimum duration in milliseconds of an event loop segment recorded as stall.
+    static void setStallThreshold(int msecs);
+
+    static QVector<ThreadStatistics> threadStatistics();
+    /// The most recent stalls, oldest first.
+    static QVector<Stall> stalls();
+
+    /// Posts a latency marker event to every thread that has an event loop and no marker pending.
+    static void postHeartbeats();
+
+private:
+    EventLoopRecorder() = delete;
+};
+}
+
+#endif // GAMMARAY_EVENTLOOPMONITOR_EVENTLOOPRECORDER_H
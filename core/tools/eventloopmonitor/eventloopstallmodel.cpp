@@ -0,0 +1,154 @@
+/*
+  eventloopstallmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopstallmodel.h"
+
+#include <common/modelevent.h>
+
+#include <QEvent>
+#include <QMetaEnum>
+#include <QTimer>
+
+using namespace GammaRay;
+
+namespace {
+enum Columns {
+    TimeColumn,
+    ThreadColumn,
+    ReceiverColumn,
+    EventColumn,
+    DurationColumn,
+    ColumnCount
+};
+}
+
+static QString eventTypeName(int type)
+{
+    const auto name = QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+    if (name)
+        return QString::fromLatin1(name);
+    return QString::number(type);
+}
+
+EventLoopStallModel::EventLoopStallModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &EventLoopStallModel::refresh);
+}
+
+EventLoopStallModel::~EventLoopStallModel() = default;
+
+int EventLoopStallModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int EventLoopStallModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_stalls.size();
+}
+
+QVariant EventLoopStallModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const auto &stall = m_stalls.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TimeColumn:
+            return stall.time.toString(QStringLiteral("hh:mm:ss.zzz"));
+        case ThreadColumn:
+            return stall.thread;
+        case ReceiverColumn:
+            return stall.receiver;
+        case EventColumn:
+            return eventTypeName(stall.eventType);
+        case DurationColumn:
+            return qRound(stall.duration / 10000.0) / 100.0;
+        }
+    }
+    return QVariant();
+}
+
+QVariant EventLoopStallModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case TimeColumn:
+            return tr("Time");
+        case ThreadColumn:
+            return tr("Thread");
+        case ReceiverColumn:
+            return tr("Receiver");
+        case EventColumn:
+            return tr("Event");
+        case DurationColumn:
+            return tr("Duration [ms]");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void EventLoopStallModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        if (static_cast<ModelEvent *>(event)->used()) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    }
+    QAbstractTableModel::customEvent(event);
+}
+
+void EventLoopStallModel::refresh()
+{
+    const auto stalls = EventLoopRecorder::stalls();
+    if (!stalls.isEmpty() && !m_stalls.isEmpty() && stalls.first().serial == m_stalls.first().serial) {
+        // nothing dropped at the front, just append what is new
+        if (stalls.size() > m_stalls.size()) {
+            beginInsertRows(QModelIndex(), m_stalls.size(), stalls.size() - 1);
+            m_stalls = stalls;
+            endInsertRows();
+        }
+        return;
+    }
+
+    if (stalls.isEmpty() && m_stalls.isEmpty())
+        return;
+
+    beginResetModel();
+    m_stalls = stalls;
+    endResetModel();
+}
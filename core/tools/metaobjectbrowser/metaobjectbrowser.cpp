@@ -119,15 +119,13 @@ void MetaObjectBrowser::metaObjectSelected(const QMetaObject *mo)
     if (!mo)
         return;
     mo = Probe::instance()->metaObjectRegistry()->canonicalMetaObject(mo);
-    const auto indexes = m_model->match(m_model->index(0, 0), QMetaObjectModel::MetaObjectRole,
-                                        QVariant::fromValue(mo),
-                                        Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexes.isEmpty()) {
+    const auto index = m_model->mapFromSource(m_motm->indexForMetaObject(mo));
+    if (!index.isValid()) {
         metaObjectSelected(mo->superClass());
         return;
     }
     ObjectBroker::selectionModel(m_model)->select(
-        indexes.first(), QItemSelectionModel::Rows | QItemSelectionModel::ClearAndSelect);
+        index, QItemSelectionModel::Rows | QItemSelectionModel::ClearAndSelect);
 }
 
 QVector<QByteArray> MetaObjectBrowserFactory::selectableTypes() const
@@ -41,15 +41,15 @@
 #include "outboundconnectionsmodel.h"
 #include "objectdataprovider.h"
 
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/objectmodel.h>
 #include <core/bindingaggregator.h>
+#include <core/objectsearchproxymodel.h>
 #include <core/problemcollector.h>
 #include <core/util.h>
 #include <remote/serverproxymodel.h>
 
-#include <3rdparty/kde/krecursivefilterproxymodel.h>
-
 #include <QCoreApplication>
 #include <QItemSelectionModel>
 #include <QMetaMethod>
@@ -67,7 +67,7 @@ ObjectInspector::ObjectInspector(Probe *probe, QObject *parent)
     m_propertyController = new PropertyController(QStringLiteral(
                                                       "com.kdab.GammaRay.ObjectInspector"), this);
 
-    auto proxy = new ServerProxyModel<KRecursiveFilterProxyModel>(this);
+    auto proxy = new ServerProxyModel<ObjectSearchProxyModel>(this);
     proxy->setSourceModel(probe->objectTreeModel());
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.ObjectInspectorTree"), proxy);
 
@@ -114,16 +114,10 @@ void ObjectInspector::modelIndexSelected(const QModelIndex &index)
 
 void ObjectInspector::objectSelected(QObject *object)
 {
-    const QAbstractItemModel *model = m_selectionModel->model();
-    const QModelIndexList indexList
-        = model->match(model->index(0, 0),
-                       ObjectModel::ObjectRole,
-                       QVariant::fromValue<QObject *>(object), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const QModelIndex index = ModelUtils::indexForObject(m_selectionModel->model(), object);
+    if (!index.isValid())
         return;
 
-    const QModelIndex index = indexList.first();
     m_selectionModel->select(
         index,
         QItemSelectionModel::Select | QItemSelectionModel::Clear
@@ -0,0 +1,227 @@
+/*
+  overheadmodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "overheadmodel.h"
+
+#include <common/modelevent.h>
+
+#include <QMetaObject>
+#include <QTimer>
+
+using namespace GammaRay;
+
+namespace {
+enum Columns {
+    NameColumn,
+    CallsColumn,
+    TotalTimeColumn,
+    ExclusiveTimeColumn,
+    AverageTimeColumn,
+    MaxTimeColumn,
+    ShareColumn,
+    ColumnCount
+};
+}
+
+static QString hookName(int hook)
+{
+    switch (hook) {
+    case ProbeOverhead::ObjectAdded:
+        return OverheadModel::tr("Object creation");
+    case ProbeOverhead::ObjectRemoved:
+        return OverheadModel::tr("Object destruction");
+    case ProbeOverhead::SignalBegin:
+        return OverheadModel::tr("Signal emission begin");
+    case ProbeOverhead::SignalEnd:
+        return OverheadModel::tr("Signal emission end");
+    case ProbeOverhead::SlotBegin:
+        return OverheadModel::tr("Slot invocation begin");
+    case ProbeOverhead::SlotEnd:
+        return OverheadModel::tr("Slot invocation end");
+    case ProbeOverhead::EventFilter:
+        return OverheadModel::tr("Event filter");
+    case ProbeOverhead::RemoteModelRequest:
+        return OverheadModel::tr("Remote model requests");
+    }
+    return QString();
+}
+
+OverheadModel::OverheadModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_hookStatistics(ProbeOverhead::HookCount)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &OverheadModel::refresh);
+}
+
+OverheadModel::~OverheadModel()
+{
+    ProbeOverhead::setEnabled(false);
+}
+
+int OverheadModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+int OverheadModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_hookStatistics.size();
+    if (parent.column() == 0 && parent.internalId() == 0 && parent.row() == ProbeOverhead::EventFilter)
+        return m_eventFilterStatistics.size();
+    return 0;
+}
+
+QModelIndex OverheadModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    // top-level rows have id 0, event filter rows have the id of their parent row + 1
+    return createIndex(row, column, parent.isValid() ? quintptr(parent.row() + 1) : 0);
+}
+
+QModelIndex OverheadModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0)
+        return QModelIndex();
+    return createIndex(int(child.internalId()) - 1, 0, quintptr(0));
+}
+
+QVariant OverheadModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (index.internalId() == 0) {
+        if (role == Qt::DisplayRole && index.column() == NameColumn)
+            return hookName(index.row());
+        if (role == Qt::ToolTipRole && index.column() == ShareColumn)
+            return tr("Share of the exclusive time of all hooks.");
+        quint64 referenceTime = 0;
+        for (const auto &stats : m_hookStatistics)
+            referenceTime += stats.exclusiveTime;
+        return role == Qt::DisplayRole ? statisticsData(m_hookStatistics.at(index.row()), index.column(), referenceTime) : QVariant();
+    }
+
+    const auto &filter = m_eventFilterStatistics.at(index.row());
+    if (role == Qt::DisplayRole && index.column() == NameColumn)
+        return QString::fromLatin1(filter.first->className());
+    if (role == Qt::ToolTipRole && index.column() == NameColumn)
+        return tr("Time spent in the global event filter of %1, the share is relative to all global event filters.")
+               .arg(QString::fromLatin1(filter.first->className()));
+    quint64 referenceTime = 0;
+    for (const auto &other : m_eventFilterStatistics)
+        referenceTime += other.second.exclusiveTime;
+    return role == Qt::DisplayRole ? statisticsData(filter.second, index.column(), referenceTime) : QVariant();
+}
+
+QVariant OverheadModel::statisticsData(const ProbeOverhead::Statistics &stats, int column, quint64 referenceTime) const
+{
+    switch (column) {
+    case CallsColumn:
+        return stats.calls;
+    case TotalTimeColumn:
+        return qRound(stats.totalTime / 10000.0) / 100.0; // ms
+    case ExclusiveTimeColumn:
+        return qRound(stats.exclusiveTime / 10000.0) / 100.0; // ms
+    case AverageTimeColumn:
+        return stats.calls ? qRound(stats.totalTime / (stats.calls * 10.0)) / 100.0 : 0.0; // µs
+    case MaxTimeColumn:
+        return qRound(stats.maxTime / 10.0) / 100.0; // µs
+    case ShareColumn:
+        return referenceTime ? qRound(stats.exclusiveTime * 10000.0 / referenceTime) / 100.0 : 0.0; // %
+    }
+    return QVariant();
+}
+
+QVariant OverheadModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case NameColumn:
+            return tr("Hook");
+        case CallsColumn:
+            return tr("Calls");
+        case TotalTimeColumn:
+            return tr("Total [ms]");
+        case ExclusiveTimeColumn:
+            return tr("Exclusive [ms]");
+        case AverageTimeColumn:
+            return tr("Average [µs]");
+        case MaxTimeColumn:
+            return tr("Max [µs]");
+        case ShareColumn:
+            return tr("Share [%]");
+        }
+    }
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+void OverheadModel::customEvent(QEvent *event)
+{
+    if (event->type() == ModelEvent::eventType()) {
+        const bool used = static_cast<ModelEvent *>(event)->used();
+        ProbeOverhead::setEnabled(used);
+        if (used) {
+            refresh();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    }
+    QAbstractItemModel::customEvent(event);
+}
+
+void OverheadModel::refresh()
+{
+    for (int i = 0; i < ProbeOverhead::HookCount; ++i)
+        m_hookStatistics[i] = ProbeOverhead::statistics(static_cast<ProbeOverhead::Hook>(i));
+
+    // event filter types are only ever appended, unless the statistics got reset
+    const auto eventFilterStatistics = ProbeOverhead::eventFilterStatistics();
+    const auto filterParent = index(ProbeOverhead::EventFilter, 0);
+    if (eventFilterStatistics.size() > m_eventFilterStatistics.size()) {
+        beginInsertRows(filterParent, m_eventFilterStatistics.size(), eventFilterStatistics.size() - 1);
+        m_eventFilterStatistics = eventFilterStatistics;
+        endInsertRows();
+    } else if (eventFilterStatistics.size() < m_eventFilterStatistics.size()) {
+        beginResetModel();
+        m_eventFilterStatistics = eventFilterStatistics;
+        endResetModel();
+    } else {
+        m_eventFilterStatistics = eventFilterStatistics;
+    }
+
+    emit dataChanged(index(0, CallsColumn), index(rowCount() - 1, ShareColumn));
+    if (!m_eventFilterStatistics.isEmpty())
+        emit dataChanged(index(0, CallsColumn, filterParent),
+                         index(m_eventFilterStatistics.size() - 1, ShareColumn, filterParent));
+}
@@ -34,22 +34,90 @@
 
 #include <core/remote/serverproxymodel.h>
 
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QDirIterator>
+#include <QImageReader>
 #include <QItemSelectionModel>
+#include <QThread>
+#include <QTimer>
 #include <QUrl>
 
 using namespace GammaRay;
 
+// amount of data sent per event loop pass for downloads
+static const qint64 DownloadChunkSize = 256 * 1024;
+
+// larger files are truncated for the text preview, and not previewed at all
+// if they are images, as that would mean sending them in one piece
+static const qint64 MaxPreviewSize = 4 * 1024 * 1024;
+
+namespace GammaRay {
+// computes the content hashes of all resource files off the main thread
+class ResourceHashThread : public QThread
+{
+public:
+    explicit ResourceHashThread(QObject *parent)
+        : QThread(parent)
+    {
+    }
+
+    QHash<QString, QByteArray> hashes;
+
+protected:
+    void run() override
+    {
+        QDirIterator it(QStringLiteral(":/"), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext() && !isInterruptionRequested()) {
+            const QString path = it.next();
+            if (path.startsWith(QLatin1String(":/gammaray/")))
+                continue;
+            QFile f(path);
+            if (!f.open(QFile::ReadOnly))
+                continue;
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            if (hash.addData(&f))
+                hashes.insert(path, hash.result());
+        }
+    }
+};
+}
+
 ResourceBrowser::ResourceBrowser(Probe *probe, QObject *parent)
     : ResourceBrowserInterface(parent)
+    , m_downloadTimer(new QTimer(this))
+    , m_filterModel(nullptr)
+    , m_hashThread(new ResourceHashThread(this))
 {
+    m_downloadTimer->setInterval(0);
+    connect(m_downloadTimer, &QTimer::timeout, this, &ResourceBrowser::transferNextChunk);
+
     auto *resourceModel = new ResourceModel(this);
     auto proxy = new ServerProxyModel<ResourceFilterModel>(this);
     proxy->setSourceModel(resourceModel);
+    m_filterModel = proxy;
+    proxy->addProxyRole(Qt::ToolTipRole);
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.ResourceModel"), proxy);
     QItemSelectionModel *selectionModel = ObjectBroker::selectionModel(proxy);
     connect(selectionModel, &QItemSelectionModel::currentChanged,
             this, [this](const QModelIndex &index) { currentChanged(index); });
+
+    // duplicate detection is a single pass over the hashes once they are all known,
+    // so they are all computed once the first tool tip asks for one
+    connect(m_hashThread, &QThread::finished, this, &ResourceBrowser::hashingFinished);
+    connect(proxy, &ResourceFilterModel::contentHashesNeeded, this, [this]() {
+        if (!m_hashThread->isRunning() && !m_hashThread->isFinished())
+            m_hashThread->start(QThread::LowPriority);
+    });
+}
+
+ResourceBrowser::~ResourceBrowser()
+{
+    m_hashThread->requestInterruption();
+    m_hashThread->wait();
+
+    for (const auto &download : qAsConst(m_downloads))
+        delete download.file;
 }
 
 void ResourceBrowser::downloadResource(const QString &sourceFilePath, const QString &targetFilePath)
@@ -57,27 +125,67 @@ void ResourceBrowser::downloadResource(const QString &sourceFilePath, const QStr
     const QFileInfo fi(sourceFilePath);
 
     if (fi.isFile()) {
-        QFile f(fi.absoluteFilePath());
-        if (f.open(QFile::ReadOnly))
-            emit resourceDownloaded(targetFilePath, f.readAll());
-        else
+        auto f = new QFile(fi.absoluteFilePath());
+        if (!f->open(QFile::ReadOnly)) {
             qWarning() << "Failed to open" << fi.absoluteFilePath();
+            delete f;
+            return;
+        }
+        cancelDownload(targetFilePath);
+        m_downloads.push_back({ targetFilePath, f });
+        m_downloadTimer->start();
     }
 }
 
+void ResourceBrowser::cancelDownload(const QString &targetFilePath)
+{
+    for (auto it = m_downloads.begin(); it != m_downloads.end(); ++it) {
+        if (it->targetFilePath == targetFilePath) {
+            delete it->file;
+            m_downloads.erase(it);
+            break;
+        }
+    }
+    if (m_downloads.isEmpty())
+        m_downloadTimer->stop();
+}
+
+void ResourceBrowser::transferNextChunk()
+{
+    if (m_downloads.isEmpty()) {
+        m_downloadTimer->stop();
+        return;
+    }
+
+    // round-robin over all pending downloads, one chunk per event loop pass
+    auto download = m_downloads.takeFirst();
+    const qint64 offset = download.file->pos();
+    const QByteArray chunk = download.file->read(DownloadChunkSize);
+    const bool finished = download.file->atEnd() || chunk.isEmpty();
+    if (finished) {
+        delete download.file;
+        if (m_downloads.isEmpty())
+            m_downloadTimer->stop();
+    } else {
+        m_downloads.push_back(download);
+    }
+    emit resourceDownloaded(download.targetFilePath, chunk, offset, finished);
+}
+
+void ResourceBrowser::hashingFinished()
+{
+    m_filterModel->setContentHashes(m_hashThread->hashes);
+}
+
 void ResourceBrowser::selectResource(const QString &sourceFilePath, int line, int column)
 {
     const bool locked = blockSignals(true);
     const QItemSelectionModel::SelectionFlags selectionFlags = QItemSelectionModel::ClearAndSelect
                                                                |QItemSelectionModel::Rows
                                                                | QItemSelectionModel::Current;
-    const Qt::MatchFlags matchFlags = Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap;
-    auto model = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ResourceModel"));
-    auto selectionModel = ObjectBroker::selectionModel(model);
+    auto selectionModel = ObjectBroker::selectionModel(m_filterModel);
     const QString filePath = QLatin1Char(':') + QUrl(sourceFilePath).path();
-    const QModelIndex index = model->match(model->index(0,
-                                                        0), ResourceModel::FilePathRole, filePath, 1,
-                                           matchFlags).value(0);
+    const QModelIndex index = m_filterModel->indexForFilePath(filePath);
     selectionModel->setCurrentIndex(index, selectionFlags);
     blockSignals(locked);
     currentChanged(index, line, column);
@@ -96,7 +204,11 @@ void ResourceBrowser::currentChanged(const QModelIndex &current, int line, int c
 
     QFile f(fi.absoluteFilePath());
     if (f.open(QFile::ReadOnly)) {
-        emit resourceSelected(f.readAll(), line, column);
+        if (f.size() > MaxPreviewSize && !QImageReader::imageFormat(&f).isEmpty()) {
+            emit resourceDeselected();
+            return;
+        }
+        emit resourceSelected(f.read(MaxPreviewSize), line, column);
     } else {
         qWarning() << "Failed to open" << fi.absoluteFilePath();
         emit resourceDeselected();
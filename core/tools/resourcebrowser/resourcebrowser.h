@@ -32,26 +32,47 @@
 #include "toolfactory.h"
 #include <common/tools/resourcebrowser/resourcebrowserinterface.h>
 
+#include <QVector>
+
 QT_BEGIN_NAMESPACE
+class QFile;
 class QModelIndex;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class ResourceFilterModel;
+class ResourceHashThread;
+
 class ResourceBrowser : public ResourceBrowserInterface
 {
     Q_OBJECT
     Q_INTERFACES(GammaRay::ResourceBrowserInterface)
 public:
     explicit ResourceBrowser(Probe *probe, QObject *parent = nullptr);
+    ~ResourceBrowser() override;
 
 public slots:
     void downloadResource(const QString &sourceFilePath,
                           const QString &targetFilePath) override;
     void selectResource(const QString &sourceFilePath, int line = -1,
                         int column = -1) override;
+    void cancelDownload(const QString &targetFilePath) override;
 
 private slots:
     void currentChanged(const QModelIndex &current, int line = -1, int column = -1);
+    void transferNextChunk();
+    void hashingFinished();
+
+private:
+    struct Download {
+        QString targetFilePath;
+        QFile *file;
+    };
+    QVector<Download> m_downloads;
+    QTimer *m_downloadTimer;
+    ResourceFilterModel *m_filterModel;
+    ResourceHashThread *m_hashThread;
 };
 
 class ResourceBrowserFactory : public QObject, public StandardToolFactory<QObject, ResourceBrowser>
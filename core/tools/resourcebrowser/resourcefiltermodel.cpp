@@ -31,6 +31,7 @@
 #include "qt/resourcemodel.h"
 
 #include <QDebug>
+#include <QFileInfo>
 
 using namespace GammaRay;
 
@@ -47,3 +48,73 @@ bool ResourceFilterModel::filterAcceptsRow(int source_row, const QModelIndex &so
         return false;
     return KRecursiveFilterProxyModel::filterAcceptsRow(source_row, source_parent);
 }
+
+QVariant ResourceFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::ToolTipRole || index.column() != 0)
+        return KRecursiveFilterProxyModel::data(index, role);
+
+    const QString path = index.data(ResourceModel::FilePathRole).toString();
+    if (!QFileInfo(path).isFile())
+        return KRecursiveFilterProxyModel::data(index, role);
+    if (!m_hashesAvailable) {
+        if (m_pendingToolTipDirs.isEmpty())
+            emit const_cast<ResourceFilterModel *>(this)->contentHashesNeeded();
+        m_pendingToolTipDirs.insert(index.parent().data(ResourceModel::FilePathRole).toString());
+        return KRecursiveFilterProxyModel::data(index, role);
+    }
+
+    const QByteArray hash = m_contentHashes.value(path);
+    if (hash.isEmpty())
+        return KRecursiveFilterProxyModel::data(index, role);
+
+    QString toolTip = tr("SHA-1: %1").arg(QString::fromLatin1(hash.toHex()));
+    QStringList duplicates = m_filesByHash.value(hash);
+    duplicates.removeOne(path);
+    if (!duplicates.isEmpty()) {
+        duplicates.sort();
+        toolTip += QLatin1Char('\n') + tr("Identical content: %1").arg(duplicates.join(QStringLiteral(", ")));
+    }
+    return toolTip;
+}
+
+void ResourceFilterModel::setContentHashes(const QHash<QString, QByteArray> &hashes)
+{
+    m_contentHashes = hashes;
+    m_filesByHash.clear();
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it)
+        m_filesByHash[it.value()].push_back(it.key());
+    m_hashesAvailable = true;
+
+    // one change per directory, rather than per row that asked for a tool tip
+    const auto pendingDirs = std::move(m_pendingToolTipDirs);
+    m_pendingToolTipDirs.clear();
+    for (const auto &dir : pendingDirs) {
+        const QModelIndex parent = dir.isEmpty() ? QModelIndex() : indexForFilePath(dir);
+        const int rowCount = this->rowCount(parent);
+        if ((parent.isValid() || dir.isEmpty()) && rowCount > 0)
+            emit dataChanged(index(0, 0, parent), index(rowCount - 1, 0, parent), { Qt::ToolTipRole });
+    }
+}
+
+QModelIndex ResourceFilterModel::indexForFilePath(const QString &filePath) const
+{
+    QModelIndex parent;
+    while (true) {
+        QModelIndex next;
+        for (int row = 0; row < rowCount(parent); ++row) {
+            const QModelIndex index = this->index(row, 0, parent);
+            const QString path = index.data(ResourceModel::FilePathRole).toString();
+            if (path == filePath)
+                return index;
+            if (filePath.size() > path.size() && filePath.startsWith(path)
+                && (path.endsWith(QLatin1Char('/')) || filePath.at(path.size()) == QLatin1Char('/'))) {
+                next = index;
+                break;
+            }
+        }
+        if (!next.isValid())
+            return QModelIndex();
+        parent = next;
+    }
+}
@@ -31,6 +31,10 @@
 
 #include <3rdparty/kde/krecursivefilterproxymodel.h>
 
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
 namespace GammaRay {
 class ResourceFilterModel : public KRecursiveFilterProxyModel
 {
@@ -38,6 +42,24 @@ class ResourceFilterModel : public KRecursiveFilterProxyModel
 public:
     explicit ResourceFilterModel(QObject *parent = nullptr);
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /** Content hashes of all resource files, keyed by file path. */
+    void setContentHashes(const QHash<QString, QByteArray> &hashes);
+
+    /** Finds the index of @p filePath, only populating the directories along the path. */
+    QModelIndex indexForFilePath(const QString &filePath) const;
+
+signals:
+    /** Emitted when the first tool tip is requested, the hashes are computed from then on. */
+    void contentHashesNeeded();
+
+private:
+    QHash<QString, QByteArray> m_contentHashes;
+    QHash<QByteArray, QStringList> m_filesByHash;
+    bool m_hashesAvailable = false;
+    // directories with tool tips requested before the hashes were available
+    mutable QSet<QString> m_pendingToolTipDirs;
 };
 }
 
@@ -35,6 +35,7 @@
 #include "varianthandler.h"
 #include "objectdataprovider.h"
 #include "enumutil.h"
+#include "execution.h"
 
 #include <compat/qasconst.h>
 
@@ -261,6 +262,16 @@ void Util::drawTransparencyPattern(QPainter *painter, const QRect &rect, int squ
     painter->fillRect(rect, bgBrush);
 }
 
+const QMetaObject *Util::staticMetaObject(const QObject *object)
+{
+    auto metaObject = object->metaObject();
+    if (!QObjectPrivate::get(const_cast<QObject *>(object))->metaObject)
+        return metaObject;
+    while (metaObject && !Execution::isReadOnlyData(metaObject))
+        metaObject = metaObject->superClass();
+    return metaObject ? metaObject : &QObject::staticMetaObject;
+}
+
 int Util::signalIndexToMethodIndex(const QMetaObject *metaObject, int signalIndex)
 {
     return QMetaObjectPrivate::signal(metaObject, signalIndex).methodIndex();
@@ -164,6 +164,15 @@ GAMMARAY_CORE_EXPORT void drawTransparencyPattern(QPainter *painter, const QRect
  */
 GAMMARAY_CORE_EXPORT int signalIndexToMethodIndex(const QMetaObject *metaObject, int signalIndex);
 
+/*!
+ * Returns the meta object of the most derived class of @p object that is
+ * compiled into a binary, skipping dynamic meta objects such as those QML
+ * creates per type or instance. Unlike QObject::metaObject() the result stays
+ * valid after @p object has been destroyed.
+ * @since 2.11
+ */
+GAMMARAY_CORE_EXPORT const QMetaObject *staticMetaObject(const QObject *object);
+
 /*!
  * Checks if the given pointer should be considered a nullptr.
  * One would assume this to be trivial, but there are some interesting hacks
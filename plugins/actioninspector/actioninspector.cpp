@@ -31,6 +31,7 @@
 #include <core/metaobjectrepository.h>
 #include <core/remote/serverproxymodel.h>
 
+#include <common/modelutils.h>
 #include <common/objectmodel.h>
 #include <common/objectbroker.h>
 #include <common/objectid.h>
@@ -89,16 +90,10 @@ void GammaRay::ActionInspector::objectSelected(QObject *obj)
     if (!action)
         return;
 
-    const QAbstractItemModel *model = m_selectionModel->model();
-
-    const auto indexList = model->match(model->index(0, 0),
-                       ActionModel::ObjectIdRole,
-                       QVariant::fromValue(ObjectId(action)), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const QModelIndex index = ModelUtils::indexForObject(m_selectionModel->model(), action);
+    if (!index.isValid())
         return;
 
-    const QModelIndex index = indexList.first();
     m_selectionModel->select(index,
                              QItemSelectionModel::Select
                              |QItemSelectionModel::Clear
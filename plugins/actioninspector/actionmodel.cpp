@@ -127,6 +127,15 @@ int ActionModel::rowCount(const QModelIndex &parent) const
     return m_actions.size();
 }
 
+QModelIndex ActionModel::indexForObject(QObject *object) const
+{
+    const auto action = qobject_cast<QAction *>(object);
+    const auto it = std::lower_bound(m_actions.constBegin(), m_actions.constEnd(), action);
+    if (!action || it == m_actions.constEnd() || *it != action)
+        return QModelIndex();
+    return index(std::distance(m_actions.constBegin(), it), 0);
+}
+
 QVariant ActionModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid())
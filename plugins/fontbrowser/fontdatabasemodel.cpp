@@ -83,6 +83,7 @@ QVariant FontDatabaseModel::data(const QModelIndex &index, int role) const
     const auto &style = styleIndex == -1 ? QString() : m_styles.at(familyIndex).at(styleIndex);
     const auto &family = m_families.at(familyIndex);
     const auto isSortRole = role == FontBrowserInterface::SortRole;
+    const auto &attrs = attributes(familyIndex, styleIndex);
 
     if (role == Qt::DisplayRole || isSortRole) {
         auto toSortVariant = [isSortRole] (bool state) {
@@ -92,19 +93,19 @@ QVariant FontDatabaseModel::data(const QModelIndex &index, int role) const
         case Label:
             return styleIndex == -1 ? family : style;
         case Weight:
-            return QFontDatabase().weight(family, style);
+            return attrs.weight;
         case SmoothSizes:
-            return smoothSizeString(family, style);
+            return attrs.smoothSizes;
         case Bold:
-            return toSortVariant(QFontDatabase().bold(family, style));
+            return toSortVariant(attrs.flags & Attributes::Bold);
         case Italic:
-            return toSortVariant(QFontDatabase().italic(family, style));
+            return toSortVariant(attrs.flags & Attributes::Italic);
         case Scalable:
-            return toSortVariant(QFontDatabase().isScalable(family, style));
+            return toSortVariant(attrs.flags & Attributes::Scalable);
         case BitmapScalable:
-            return toSortVariant(QFontDatabase().isBitmapScalable(family, style));
+            return toSortVariant(attrs.flags & Attributes::BitmapScalable);
         case SmoothlyScalable:
-            return toSortVariant(QFontDatabase().isSmoothlyScalable(family, style));
+            return toSortVariant(attrs.flags & Attributes::SmoothlyScalable);
         case NUM_COLUMNS:
             return {};
         }
@@ -114,15 +115,15 @@ QVariant FontDatabaseModel::data(const QModelIndex &index, int role) const
         };
         switch (static_cast<Columns>(index.column())) {
         case Bold:
-            return checkState(QFontDatabase().bold(family, style));
+            return checkState(attrs.flags & Attributes::Bold);
         case Italic:
-            return checkState(QFontDatabase().italic(family, style));
+            return checkState(attrs.flags & Attributes::Italic);
         case Scalable:
-            return checkState(QFontDatabase().isScalable(family, style));
+            return checkState(attrs.flags & Attributes::Scalable);
         case BitmapScalable:
-            return checkState(QFontDatabase().isBitmapScalable(family, style));
+            return checkState(attrs.flags & Attributes::BitmapScalable);
         case SmoothlyScalable:
-            return checkState(QFontDatabase().isSmoothlyScalable(family, style));
+            return checkState(attrs.flags & Attributes::SmoothlyScalable);
         case Weight:
         case Label:
         case SmoothSizes:
@@ -131,7 +132,7 @@ QVariant FontDatabaseModel::data(const QModelIndex &index, int role) const
         }
     } else if (role == Qt::ToolTipRole) {
         if (index.column() == SmoothSizes)
-            return smoothSizeString(family, style);
+            return attrs.smoothSizes;
     } else if (role == FontBrowserInterface::FontRole) {
         if (styleIndex == -1) {
             return QFont(family);
@@ -216,15 +217,39 @@ QMap<int, QVariant> FontDatabaseModel::itemData(const QModelIndex &index) const
     return ret;
 }
 
-QString FontDatabaseModel::smoothSizeString(const QString &family, const QString &style) const
+const FontDatabaseModel::Attributes &FontDatabaseModel::attributes(int familyIndex, int styleIndex) const
 {
-    QFontDatabase database;
-    const auto smoothSizes = database.smoothSizes(family, style);
-    QStringList sizes;
-    sizes.reserve(smoothSizes.size());
-    for (auto points : smoothSizes)
-        sizes.push_back(QString::number(points));
-    return sizes.join(QStringLiteral(" "));
+    auto &familyAttributes = m_attributes[familyIndex];
+    if (familyAttributes.isEmpty()) {
+        // gather the entire family at once, that's what views ask for anyway
+        QFontDatabase database;
+        const auto &family = m_families.at(familyIndex);
+        const auto &styles = m_styles.at(familyIndex);
+        familyAttributes.resize(styles.size() + 1);
+        for (int i = 0; i <= styles.size(); ++i) {
+            const auto style = i == 0 ? QString() : styles.at(i - 1);
+            auto &attrs = familyAttributes[i];
+            attrs.weight = database.weight(family, style);
+            if (database.bold(family, style))
+                attrs.flags |= Attributes::Bold;
+            if (database.italic(family, style))
+                attrs.flags |= Attributes::Italic;
+            if (database.isScalable(family, style))
+                attrs.flags |= Attributes::Scalable;
+            if (database.isBitmapScalable(family, style))
+                attrs.flags |= Attributes::BitmapScalable;
+            if (database.isSmoothlyScalable(family, style))
+                attrs.flags |= Attributes::SmoothlyScalable;
+
+            const auto smoothSizes = database.smoothSizes(family, style);
+            QStringList sizes;
+            sizes.reserve(smoothSizes.size());
+            for (auto points : smoothSizes)
+                sizes.push_back(QString::number(points));
+            attrs.smoothSizes = sizes.join(QStringLiteral(" "));
+        }
+    }
+    return familyAttributes.at(styleIndex + 1);
 }
 
 void FontDatabaseModel::ensureModelPopulated() const
@@ -241,6 +266,7 @@ void FontDatabaseModel::populateModel()
     const auto families = database.families();
     m_families.reserve(families.size());
     m_styles.resize(families.size());
+    m_attributes.resize(families.size());
     for (int i = 0; i < families.size(); ++i) {
         const auto &family = families.at(i);
         m_families.push_back(family);
@@ -70,10 +70,26 @@ private:
     void ensureModelPopulated() const;
     void populateModel();
 
-    QString smoothSizeString(const QString &family, const QString &style) const;
+    /** Everything we show about a font family or style, queried from QFontDatabase only once. */
+    struct Attributes
+    {
+        enum Flag {
+            Bold = 1,
+            Italic = 2,
+            Scalable = 4,
+            BitmapScalable = 8,
+            SmoothlyScalable = 16
+        };
+        QString smoothSizes;
+        int weight = -1;
+        int flags = 0;
+    };
+    const Attributes &attributes(int familyIndex, int styleIndex) const;
 
     QVector<QString> m_families;
     QVector<QVector<QString> > m_styles;
+    // per family, the family itself at index 0 followed by its styles, filled lazily
+    mutable QVector<QVector<Attributes> > m_attributes;
 };
 }
 
@@ -29,8 +29,7 @@
 #include "fontmodel.h"
 
 #include <QFontMetrics>
-#include <QPixmap>
-#include <QPainter>
+#include <QThread>
 
 using namespace GammaRay;
 
@@ -40,7 +39,21 @@ FontModel::FontModel(QObject *parent)
     , m_bold(false)
     , m_italic(false)
     , m_underline(false)
+    , m_renderThread(new QThread(this))
+    , m_renderer(new FontPreviewRenderer)
+    , m_previews(4 * 1024 * 1024) // in pixels
+    , m_renderInFlight(false)
 {
+    m_renderer->moveToThread(m_renderThread);
+    connect(m_renderer, &FontPreviewRenderer::rendered, this, &FontModel::previewRendered);
+    m_renderThread->start(QThread::LowPriority);
+}
+
+FontModel::~FontModel()
+{
+    m_renderThread->quit();
+    m_renderThread->wait();
+    delete m_renderer;
 }
 
 QVector<QFont> FontModel::currentFonts() const
@@ -56,6 +69,9 @@ void FontModel::updateFonts(const QVector<QFont> &fonts)
         endRemoveRows();
     }
 
+    m_renderQueue.clear();
+    m_queuedPreviews.clear();
+
     if (fonts.isEmpty())
         return;
 
@@ -116,20 +132,18 @@ QVariant FontModel::data(const QModelIndex &index, int role) const
         if (role == Qt::DisplayRole)
             return m_fonts.at(index.row()).styleName();
     } else if (index.column() == 2) {
-        if (role == Qt::DecorationRole || role == Qt::SizeHintRole) {
-            const QFont &font = m_fonts.at(index.row());
+        const QFont &font = m_fonts.at(index.row());
+        if (role == Qt::SizeHintRole) {
             QFontMetrics metrics(font);
-            const QString text = m_text.isEmpty() ? tr("<no text>") : m_text;
-            const QRect rect = metrics.boundingRect(text.left(100));
-            if (role == Qt::SizeHintRole)
-                return rect.size();
-            QPixmap pixmap(rect.size());
-            pixmap.fill(m_background);
-            QPainter painter(&pixmap);
-            painter.setPen(m_foreground);
-            painter.setFont(font);
-            painter.drawText(0, -rect.y(), text);
-            return pixmap;
+            return metrics.boundingRect(previewText()).size();
+        }
+        if (role == Qt::DecorationRole) {
+            const QString text = previewText();
+            const QString key = FontPreviewRenderer::cacheKey(font, text, m_foreground, m_background);
+            if (const QImage *preview = m_previews.object(key))
+                return *preview;
+            requestPreview(key, font, text);
+            return QVariant();
         }
     }
 
@@ -199,8 +213,52 @@ void FontModel::setColors(const QColor &foreground, const QColor &background)
     fontDataChanged();
 }
 
+QString FontModel::previewText() const
+{
+    return (m_text.isEmpty() ? tr("<no text>") : m_text).left(100);
+}
+
+void FontModel::requestPreview(const QString &key, const QFont &font, const QString &text) const
+{
+    if (m_queuedPreviews.contains(key))
+        return;
+    m_queuedPreviews.insert(key);
+    m_renderQueue.push_back({ key, font, text, m_foreground, m_background });
+    processRenderQueue();
+}
+
+void FontModel::processRenderQueue() const
+{
+    if (m_renderInFlight || m_renderQueue.isEmpty())
+        return;
+    m_renderInFlight = true;
+    QMetaObject::invokeMethod(m_renderer, "render", Qt::QueuedConnection,
+                              Q_ARG(GammaRay::FontPreviewRenderer::Request, m_renderQueue.takeFirst()));
+}
+
+void FontModel::previewRendered(const QString &key, const QImage &image)
+{
+    m_renderInFlight = false;
+    m_queuedPreviews.remove(key);
+    m_previews.insert(key, new QImage(image), qMax(1, image.width() * image.height()));
+
+    const QString text = previewText();
+    for (int row = 0; row < m_fonts.size(); ++row) {
+        if (FontPreviewRenderer::cacheKey(m_fonts.at(row), text, m_foreground, m_background) == key) {
+            const QModelIndex idx = index(row, 2);
+            emit dataChanged(idx, idx);
+        }
+    }
+
+    processRenderQueue();
+}
+
 void FontModel::fontDataChanged()
 {
+    // whatever is still queued is outdated now, visible rows will ask again
+    m_renderQueue.clear();
+    m_queuedPreviews.clear();
+
     if (m_fonts.isEmpty())
         return;
 
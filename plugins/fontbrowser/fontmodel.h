@@ -29,17 +29,27 @@
 #ifndef GAMMARAY_FONTBROWSER_FONTMODEL_H
 #define GAMMARAY_FONTBROWSER_FONTMODEL_H
 
+#include "fontpreviewrenderer.h"
+
 #include <QAbstractTableModel>
+#include <QCache>
 #include <QFont>
 #include <QColor>
+#include <QImage>
+#include <QSet>
 #include <QVector>
 
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 class FontModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
     explicit FontModel(QObject *parent);
+    ~FontModel() override;
 
     void updateFonts(const QVector<QFont> &fonts);
     QVector<QFont> currentFonts() const;
@@ -60,8 +70,14 @@ public slots:
     void setPointSize(int size);
     void setColors(const QColor &foreground, const QColor &background);
 
+private slots:
+    void previewRendered(const QString &key, const QImage &image);
+
 private:
     void fontDataChanged();
+    QString previewText() const;
+    void requestPreview(const QString &key, const QFont &font, const QString &text) const;
+    void processRenderQueue() const;
 
     QVector<QFont> m_fonts;
     QString m_text;
@@ -71,6 +87,14 @@ private:
     bool m_underline;
     QColor m_foreground;
     QColor m_background;
+
+    // previews are rendered one at a time in a worker thread, and only when asked for
+    QThread *m_renderThread;
+    FontPreviewRenderer *m_renderer;
+    mutable QCache<QString, QImage> m_previews;
+    mutable QVector<FontPreviewRenderer::Request> m_renderQueue;
+    mutable QSet<QString> m_queuedPreviews;
+    mutable bool m_renderInFlight;
 };
 }
 
@@ -0,0 +1,66 @@
+/*
+  fontpreviewrenderer.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "fontpreviewrenderer.h"
+
+#include <QFontMetrics>
+#include <QPainter>
+
+using namespace GammaRay;
+
+FontPreviewRenderer::FontPreviewRenderer(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<Request>();
+}
+
+QString FontPreviewRenderer::cacheKey(const QFont &font, const QString &text,
+                                      const QColor &foreground, const QColor &background)
+{
+    return font.toString() + QLatin1Char('\x1f') + QString::number(foreground.rgba(), 16)
+           + QLatin1Char('\x1f') + QString::number(background.rgba(), 16)
+           + QLatin1Char('\x1f') + text;
+}
+
+void FontPreviewRenderer::render(const Request &request)
+{
+    const QFontMetrics metrics(request.font);
+    const QRect rect = metrics.boundingRect(request.text);
+
+    // QPixmap is not available outside of the GUI thread, and the previews
+    // are opaque anyway, so there's no need for an alpha channel
+    QImage image(rect.size(), QImage::Format_RGB32);
+    image.fill(request.background);
+    if (!image.isNull()) {
+        QPainter painter(&image);
+        painter.setPen(request.foreground);
+        painter.setFont(request.font);
+        painter.drawText(0, -rect.y(), request.text);
+    }
+    emit rendered(request.key, image);
+}
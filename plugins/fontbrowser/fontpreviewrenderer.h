@@ -0,0 +1,69 @@
+/*
+  fontpreviewrenderer.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef GAMMARAY_FONTBROWSER_FONTPREVIEWRENDERER_H
+#define GAMMARAY_FONTBROWSER_FONTPREVIEWRENDERER_H
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QObject>
+#include <QString>
+
+namespace GammaRay {
+/** Renders font previews, meant to live in a worker thread. */
+class FontPreviewRenderer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Request
+    {
+        QString key;
+        QFont font;
+        QString text;
+        QColor foreground;
+        QColor background;
+    };
+
+    explicit FontPreviewRenderer(QObject *parent = nullptr);
+
+    /** Identifies the preview of @p text in @p font with the given colors. */
+    static QString cacheKey(const QFont &font, const QString &text,
+                            const QColor &foreground, const QColor &background);
+
+public slots:
+    void render(const GammaRay::FontPreviewRenderer::Request &request);
+
+signals:
+    void rendered(const QString &key, const QImage &image);
+};
+}
+
+Q_DECLARE_METATYPE(GammaRay::FontPreviewRenderer::Request)
+
+#endif // GAMMARAY_FONTBROWSER_FONTPREVIEWRENDERER_H
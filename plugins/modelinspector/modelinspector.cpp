@@ -34,6 +34,7 @@
 #include "selectionmodelmodel.h"
 
 #include <core/remote/serverproxymodel.h>
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 
 #include <3rdparty/kde/krecursivefilterproxymodel.h>
@@ -114,14 +115,10 @@ void ModelInspector::objectSelected(QObject *object)
         if (model == m_modelContentProxyModel->sourceModel())
             return;
 
-        const auto indexList = m_modelModel->match(m_modelModel->index(0, 0),
-                                  ObjectModel::ObjectRole,
-                                  QVariant::fromValue<QObject*>(model), 1,
-                                  Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-        if (indexList.isEmpty())
+        const auto index = ModelUtils::indexForObject(m_modelModel, model);
+        if (!index.isValid())
             return;
 
-        const auto index = indexList.first();
         m_modelSelectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
     }
     if (auto selModel = qobject_cast<QItemSelectionModel*>(object)) {
@@ -129,14 +126,10 @@ void ModelInspector::objectSelected(QObject *object)
             return;
         objectSelected(const_cast<QAbstractItemModel*>(selModel->model()));
 
-        const auto indexList = m_selectionModelsModel->match(m_selectionModelsModel->index(0, 0),
-                                  ObjectModel::ObjectRole,
-                                  QVariant::fromValue<QObject*>(selModel), 1,
-                                  Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-        if (indexList.isEmpty())
+        const auto index = ModelUtils::indexForObject(m_selectionModelsModel, selModel);
+        if (!index.isValid())
             return;
 
-        const auto index = indexList.first();
         m_selectionModelsSelectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
     }
 }
@@ -163,6 +163,15 @@ int SelectionModelModel::rowCount(const QModelIndex &parent) const
     return m_currentSelectionModels.size();
 }
 
+QModelIndex SelectionModelModel::indexForObject(QObject *object) const
+{
+    const auto model = qobject_cast<QItemSelectionModel *>(object);
+    const auto it = std::lower_bound(m_currentSelectionModels.constBegin(), m_currentSelectionModels.constEnd(), model);
+    if (!model || it == m_currentSelectionModels.constEnd() || *it != model)
+        return QModelIndex();
+    return index(std::distance(m_currentSelectionModels.constBegin(), it), 0);
+}
+
 QVariant SelectionModelModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid())
@@ -55,6 +55,8 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
 public slots:
     void objectCreated(QObject *obj);
     void objectDestroyed(QObject *obj);
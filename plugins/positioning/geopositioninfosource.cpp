@@ -28,16 +28,32 @@
 
 #include "geopositioninfosource.h"
 #include "positioninginterface.h"
+#include "positiontracereplay.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <algorithm>
 
 using namespace GammaRay;
 
 GeoPositionInfoSource::GeoPositionInfoSource(QObject* parent) :
     QGeoPositionInfoSource(parent),
     m_source(nullptr),
-    m_interface(nullptr)
+    m_interface(nullptr),
+    m_replay(new PositionTraceReplay(this)),
+    m_replayStatisticsTimer(new QTimer(this)),
+    m_replayedPositions(0),
+    m_replayTotalLatency(0),
+    m_replayMaximumLatency(0)
 {
+    connect(m_replay, &PositionTraceReplay::positionUpdated, this, &GeoPositionInfoSource::replayPositionUpdated);
+    connect(m_replay, &PositionTraceReplay::finished, this, &GeoPositionInfoSource::replayFinished);
+
+    // replays can be high-frequency, don't sync each update to the client
+    m_replayStatisticsTimer->setInterval(250);
+    connect(m_replayStatisticsTimer, &QTimer::timeout, this, &GeoPositionInfoSource::updateReplayStatistics);
 }
 
 GeoPositionInfoSource::~GeoPositionInfoSource() = default;
@@ -60,6 +76,9 @@ QGeoPositionInfoSource::Error GeoPositionInfoSource::error() const
 
 QGeoPositionInfo GeoPositionInfoSource::lastKnownPosition(bool fromSatellitePositioningMethodsOnly) const
 {
+    if (m_replay->isActive())
+        return m_replay->lastPosition();
+
     if (m_source && !overrideEnabled())
         return m_source->lastKnownPosition(fromSatellitePositioningMethodsOnly);
 
@@ -127,6 +146,8 @@ void GeoPositionInfoSource::setInterface(PositioningInterface* iface)
     m_interface->setPositioningOverrideAvailable(true);
     connect(m_interface, &PositioningInterface::positioningOverrideEnabledChanged, this, &GeoPositionInfoSource::overrideChanged);
     connect(m_interface, &PositioningInterface::positionInfoOverrideChanged, this, &GeoPositionInfoSource::positionInfoOverrideChanged);
+    connect(m_interface, &PositioningInterface::traceReplayActiveChanged, this, &GeoPositionInfoSource::traceReplayActiveChanged);
+    connect(m_interface, &PositioningInterface::traceReplaySpeedChanged, this, &GeoPositionInfoSource::traceReplaySpeedChanged);
     if (overrideEnabled())
         emit positionUpdated(lastKnownPosition());
     setupSourceUpdate();
@@ -139,6 +160,8 @@ bool GeoPositionInfoSource::overrideEnabled() const
 
 void GeoPositionInfoSource::overrideChanged()
 {
+    if (m_replay->isActive())
+        return; // the replay takes precedence
     if (!overrideEnabled())
         connectSource();
     else
@@ -148,8 +171,71 @@ void GeoPositionInfoSource::overrideChanged()
 
 void GeoPositionInfoSource::positionInfoOverrideChanged()
 {
+    if (overrideEnabled() && !m_replay->isActive())
+        emit positionUpdated(lastKnownPosition());
+}
+
+void GeoPositionInfoSource::traceReplayActiveChanged()
+{
+    if (m_interface->traceReplayActive() == m_replay->isActive())
+        return;
+
+    if (!m_interface->traceReplayActive()) {
+        m_replay->stop();
+        replayFinished();
+        return;
+    }
+
+    m_replayedPositions = 0;
+    m_replayTotalLatency = 0;
+    m_replayMaximumLatency = 0;
+    m_replay->setSpeed(m_interface->traceReplaySpeed());
+    if (!m_replay->start(m_interface->traceFile())) {
+        m_interface->setTraceReplayActive(false);
+        return;
+    }
+    disconnectSource();
+    updateReplayStatistics();
+    m_replayStatisticsTimer->start();
+}
+
+void GeoPositionInfoSource::traceReplaySpeedChanged()
+{
+    m_replay->setSpeed(m_interface->traceReplaySpeed());
+}
+
+void GeoPositionInfoSource::replayPositionUpdated(const QGeoPositionInfo &info)
+{
+    // directly connected receivers process the update right here, so this is the
+    // application's processing latency for it
+    QElapsedTimer timer;
+    timer.start();
+    emit positionUpdated(info);
+    const auto latency = timer.nsecsElapsed();
+
+    ++m_replayedPositions;
+    m_replayTotalLatency += latency;
+    m_replayMaximumLatency = std::max(m_replayMaximumLatency, latency);
+}
+
+void GeoPositionInfoSource::replayFinished()
+{
+    m_replayStatisticsTimer->stop();
+    updateReplayStatistics();
+    m_interface->setTraceReplayActive(false);
+
     if (overrideEnabled())
         emit positionUpdated(lastKnownPosition());
+    else
+        connectSource();
+}
+
+void GeoPositionInfoSource::updateReplayStatistics()
+{
+    const qint64 average = m_replayedPositions ? m_replayTotalLatency / m_replayedPositions : 0;
+    m_interface->setTraceReplayStatistics(m_replayedPositions, average / 1000, m_replayMaximumLatency / 1000);
+    if (m_replay->lastPosition().coordinate().isValid())
+        m_interface->setPositionInfo(m_replay->lastPosition());
 }
 
 void GeoPositionInfoSource::connectSource()
@@ -176,5 +262,8 @@ void GeoPositionInfoSource::setupSourceUpdate()
 {
     if (!m_source || !m_interface)
         return;
-    connect(m_source, &QGeoPositionInfoSource::positionUpdated, m_interface, &PositioningInterface::setPositionInfo);
+    connect(m_source, &QGeoPositionInfoSource::positionUpdated, m_interface, [this](const QGeoPositionInfo &info) {
+        if (!m_replay->isActive())
+            m_interface->setPositionInfo(info);
+    });
 }
@@ -31,9 +31,14 @@
 
 #include <QGeoPositionInfoSource>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace GammaRay {
 
 class PositioningInterface;
+class PositionTraceReplay;
 
 class GeoPositionInfoSource : public QGeoPositionInfoSource
 {
@@ -67,10 +72,21 @@ private:
 private slots:
     void overrideChanged();
     void positionInfoOverrideChanged();
+    void traceReplayActiveChanged();
+    void traceReplaySpeedChanged();
+    void replayPositionUpdated(const QGeoPositionInfo &info);
+    void replayFinished();
+    void updateReplayStatistics();
 
 private:
     QGeoPositionInfoSource *m_source;
     PositioningInterface *m_interface;
+
+    PositionTraceReplay *m_replay;
+    QTimer *m_replayStatisticsTimer;
+    int m_replayedPositions;
+    qint64 m_replayTotalLatency; // ns
+    qint64 m_replayMaximumLatency; // ns
 };
 
 }
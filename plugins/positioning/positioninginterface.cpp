@@ -36,6 +36,11 @@ PositioningInterface::PositioningInterface(QObject* parent)
     : QObject(parent)
     , m_positioningOverrideAvailable(false)
     , m_positioningOverrideEnabled(false)
+    , m_traceReplaySpeed(1.0)
+    , m_traceReplayActive(false)
+    , m_traceReplayedPositions(0)
+    , m_traceAverageLatency(0)
+    , m_traceMaximumLatency(0)
 {
     ObjectBroker::registerObject<PositioningInterface*>(this);
 }
@@ -91,3 +96,92 @@ void PositioningInterface::setPositionInfoOverride(const QGeoPositionInfo& info)
     m_postionInfoOverride = info;
     emit positionInfoOverrideChanged();
 }
+
+QString PositioningInterface::traceFile() const
+{
+    return m_traceFile;
+}
+
+void PositioningInterface::setTraceFile(const QString &fileName)
+{
+    if (m_traceFile == fileName)
+        return;
+    m_traceFile = fileName;
+    emit traceFileChanged();
+}
+
+double PositioningInterface::traceReplaySpeed() const
+{
+    return m_traceReplaySpeed;
+}
+
+void PositioningInterface::setTraceReplaySpeed(double speed)
+{
+    if (qFuzzyCompare(m_traceReplaySpeed, speed))
+        return;
+    m_traceReplaySpeed = speed;
+    emit traceReplaySpeedChanged();
+}
+
+bool PositioningInterface::traceReplayActive() const
+{
+    return m_traceReplayActive;
+}
+
+void PositioningInterface::setTraceReplayActive(bool active)
+{
+    if (m_traceReplayActive == active)
+        return;
+    m_traceReplayActive = active;
+    emit traceReplayActiveChanged();
+}
+
+int PositioningInterface::traceReplayedPositions() const
+{
+    return m_traceReplayedPositions;
+}
+
+void PositioningInterface::setTraceReplayedPositions(int count)
+{
+    if (m_traceReplayedPositions == count)
+        return;
+    m_traceReplayedPositions = count;
+    emit traceReplayStatisticsChanged();
+}
+
+qint64 PositioningInterface::traceAverageLatency() const
+{
+    return m_traceAverageLatency;
+}
+
+void PositioningInterface::setTraceAverageLatency(qint64 latency)
+{
+    if (m_traceAverageLatency == latency)
+        return;
+    m_traceAverageLatency = latency;
+    emit traceReplayStatisticsChanged();
+}
+
+qint64 PositioningInterface::traceMaximumLatency() const
+{
+    return m_traceMaximumLatency;
+}
+
+void PositioningInterface::setTraceMaximumLatency(qint64 latency)
+{
+    if (m_traceMaximumLatency == latency)
+        return;
+    m_traceMaximumLatency = latency;
+    emit traceReplayStatisticsChanged();
+}
+
+void PositioningInterface::setTraceReplayStatistics(int replayedPositions, qint64 averageLatency, qint64 maximumLatency)
+{
+    if (m_traceReplayedPositions == replayedPositions && m_traceAverageLatency == averageLatency
+        && m_traceMaximumLatency == maximumLatency)
+        return;
+    m_traceReplayedPositions = replayedPositions;
+    m_traceAverageLatency = averageLatency;
+    m_traceMaximumLatency = maximumLatency;
+    emit traceReplayStatisticsChanged();
+}
@@ -41,6 +41,12 @@ class PositioningInterface : public QObject
     Q_PROPERTY(bool positioningOverrideAvailable READ positioningOverrideAvailable WRITE setPositioningOverrideAvailable NOTIFY positioningOverrideAvailableChanged)
     Q_PROPERTY(bool positioningOverrideEnabled READ positioningOverrideEnabled WRITE setPositioningOverrideEnabled NOTIFY positioningOverrideEnabledChanged)
     Q_PROPERTY(QGeoPositionInfo positionInfoOverride READ positionInfoOverride WRITE setPositionInfoOverride NOTIFY positionInfoOverrideChanged)
+    Q_PROPERTY(QString traceFile READ traceFile WRITE setTraceFile NOTIFY traceFileChanged)
+    Q_PROPERTY(double traceReplaySpeed READ traceReplaySpeed WRITE setTraceReplaySpeed NOTIFY traceReplaySpeedChanged)
+    Q_PROPERTY(bool traceReplayActive READ traceReplayActive WRITE setTraceReplayActive NOTIFY traceReplayActiveChanged)
+    Q_PROPERTY(int traceReplayedPositions READ traceReplayedPositions WRITE setTraceReplayedPositions NOTIFY traceReplayStatisticsChanged)
+    Q_PROPERTY(qint64 traceAverageLatency READ traceAverageLatency WRITE setTraceAverageLatency NOTIFY traceReplayStatisticsChanged)
+    Q_PROPERTY(qint64 traceMaximumLatency READ traceMaximumLatency WRITE setTraceMaximumLatency NOTIFY traceReplayStatisticsChanged)
 public:
     explicit PositioningInterface(QObject* parent = nullptr);
 
@@ -59,6 +65,29 @@ public:
     QGeoPositionInfo positionInfoOverride() const;
     void setPositionInfoOverride(const QGeoPositionInfo &info);
 
+    /** NMEA or GPX trace file on the target to replay instead of the source positions. */
+    QString traceFile() const;
+    void setTraceFile(const QString &fileName);
+
+    /** Speed multiplier for the trace replay. */
+    double traceReplaySpeed() const;
+    void setTraceReplaySpeed(double speed);
+
+    bool traceReplayActive() const;
+    void setTraceReplayActive(bool active);
+
+    /** Number of positions replayed from the trace so far. */
+    int traceReplayedPositions() const;
+    void setTraceReplayedPositions(int count);
+
+    /** Time the application took to process a replayed position update, in microseconds. */
+    qint64 traceAverageLatency() const;
+    void setTraceAverageLatency(qint64 latency);
+    qint64 traceMaximumLatency() const;
+    void setTraceMaximumLatency(qint64 latency);
+    /** Updates all replay statistics at once, with a single change notification. */
+    void setTraceReplayStatistics(int replayedPositions, qint64 averageLatency, qint64 maximumLatency);
+
 public slots:
     void setPositionInfo(const QGeoPositionInfo &info);
 
@@ -67,12 +96,22 @@ signals:
     void positioningOverrideAvailableChanged();
     void positioningOverrideEnabledChanged();
     void positionInfoOverrideChanged();
+    void traceFileChanged();
+    void traceReplaySpeedChanged();
+    void traceReplayActiveChanged();
+    void traceReplayStatisticsChanged();
 
 private:
     QGeoPositionInfo m_postionInfo;
     QGeoPositionInfo m_postionInfoOverride;
     bool m_positioningOverrideAvailable;
     bool m_positioningOverrideEnabled;
+    QString m_traceFile;
+    double m_traceReplaySpeed;
+    bool m_traceReplayActive;
+    int m_traceReplayedPositions;
+    qint64 m_traceAverageLatency;
+    qint64 m_traceMaximumLatency;
 };
 
 }
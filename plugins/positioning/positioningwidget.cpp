@@ -38,6 +38,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QNmeaPositionInfoSource>
 #include <QQuickWidget>
@@ -127,8 +128,13 @@ PositioningWidget::PositioningWidget(QWidget* parent):
     addAction(ui->actionCenterOn);
     connect(ui->actionLoadNMEA, &QAction::triggered, this, &PositioningWidget::loadNmeaFile);
     addAction(ui->actionLoadNMEA);
+    connect(ui->actionReplayTrace, &QAction::triggered, this, &PositioningWidget::replayTrace);
+    addAction(ui->actionReplayTrace);
+    connect(m_interface, &PositioningInterface::traceReplayActiveChanged, this, &PositioningWidget::updateReplayStatus);
+    connect(m_interface, &PositioningInterface::traceReplayStatisticsChanged, this, &PositioningWidget::updateReplayStatus);
 
     new PropertyBinder(m_interface, "positioningOverrideAvailable", ui->overrideBox, "enabled");
+    new PropertyBinder(m_interface, "positioningOverrideAvailable", ui->actionReplayTrace, "enabled");
     new PropertyBinder(m_interface, "positioningOverrideEnabled", ui->overrideBox, "checked");
     new PropertyBinder(m_interface, "positioningOverrideEnabled", m_mapController, "overrideEnabled");
 
@@ -203,6 +209,43 @@ void PositioningWidget::nmeaError()
     qDebug() << m_replaySource->error();
 }
 
+void PositioningWidget::replayTrace(bool start)
+{
+    if (!start) {
+        m_interface->setTraceReplayActive(false);
+        return;
+    }
+
+    bool ok = false;
+    const auto fileName = QInputDialog::getText(this, tr("Replay Trace"),
+                                                tr("NMEA or GPX file on the target:"),
+                                                QLineEdit::Normal, m_interface->traceFile(), &ok);
+    if (!ok || fileName.isEmpty()) {
+        ui->actionReplayTrace->setChecked(false);
+        return;
+    }
+    const auto speed = QInputDialog::getDouble(this, tr("Replay Trace"), tr("Speed multiplier:"),
+                                               m_interface->traceReplaySpeed(), 0.01, 1000.0, 2, &ok);
+    if (!ok) {
+        ui->actionReplayTrace->setChecked(false);
+        return;
+    }
+
+    m_interface->setTraceFile(fileName);
+    m_interface->setTraceReplaySpeed(speed);
+    m_interface->setTraceReplayActive(true);
+}
+
+void PositioningWidget::updateReplayStatus()
+{
+    ui->actionReplayTrace->setChecked(m_interface->traceReplayActive());
+    ui->replayStatusLabel->setVisible(m_interface->traceReplayActive() || m_interface->traceReplayedPositions() > 0);
+    ui->replayStatusLabel->setText(tr("Replayed %1 positions, processing latency: %2 µs average, %3 µs maximum.")
+                                   .arg(m_interface->traceReplayedPositions())
+                                   .arg(m_interface->traceAverageLatency())
+                                   .arg(m_interface->traceMaximumLatency()));
+}
+
 void PositioningWidget::updateWidgetState()
 {
     const auto e = ui->overrideBox->isEnabled() && ui->overrideBox->isChecked();
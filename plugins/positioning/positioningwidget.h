@@ -61,6 +61,8 @@ private slots:
     void replayPosition();
     void loadNmeaFile();
     void nmeaError();
+    void replayTrace(bool start);
+    void updateReplayStatus();
     void updateWidgetState();
 
 private:
@@ -0,0 +1,326 @@
+/*
+  positiontracereplay.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "positiontracereplay.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QTimer>
+
+using namespace GammaRay;
+
+static const double KnotsToMetersPerSecond = 0.514444;
+
+static bool parseNmeaCoordinate(const QByteArray &value, const QByteArray &hemisphere, double *degrees)
+{
+    // (d)ddmm.mmmm
+    bool ok = false;
+    const double v = value.toDouble(&ok);
+    if (!ok)
+        return false;
+    const int deg = static_cast<int>(v / 100);
+    *degrees = deg + (v - deg * 100) / 60.0;
+    if (hemisphere == "S" || hemisphere == "W")
+        *degrees = -*degrees;
+    return true;
+}
+
+static QTime parseNmeaTime(const QByteArray &value)
+{
+    // hhmmss(.sss)
+    if (value.size() < 6)
+        return {};
+    const double seconds = value.mid(4).toDouble();
+    return QTime(value.mid(0, 2).toInt(), value.mid(2, 2).toInt(), static_cast<int>(seconds),
+                 qRound((seconds - static_cast<int>(seconds)) * 1000));
+}
+
+static bool hasValidNmeaChecksum(const QByteArray &sentence)
+{
+    const int star = sentence.indexOf('*');
+    if (star < 0)
+        return true; // checksum is optional
+    quint8 checksum = 0;
+    for (int i = 1; i < star; ++i)
+        checksum ^= static_cast<quint8>(sentence.at(i));
+    bool ok = false;
+    return sentence.mid(star + 1, 2).toUInt(&ok, 16) == checksum && ok;
+}
+
+/* Parses RMC and GGA sentences, the only ones carrying position data we are interested in. */
+static bool parseNmeaSentence(const QByteArray &sentence, QGeoPositionInfo *info, QTime *time, QDate *date)
+{
+    if (sentence.size() < 7 || sentence.at(0) != '$' || !hasValidNmeaChecksum(sentence))
+        return false;
+
+    const int star = sentence.indexOf('*');
+    const auto fields = sentence.left(star < 0 ? sentence.size() : star).split(',');
+    const auto type = sentence.mid(3, 3);
+    double latitude = 0.0;
+    double longitude = 0.0;
+
+    if (type == "RMC") {
+        if (fields.size() < 10 || fields.at(2) != "A")
+            return false;
+        if (!parseNmeaCoordinate(fields.at(3), fields.at(4), &latitude)
+            || !parseNmeaCoordinate(fields.at(5), fields.at(6), &longitude))
+            return false;
+        *time = parseNmeaTime(fields.at(1));
+        const auto &d = fields.at(9);
+        if (d.size() == 6)
+            *date = QDate(2000 + d.mid(4, 2).toInt(), d.mid(2, 2).toInt(), d.mid(0, 2).toInt());
+        info->setCoordinate(QGeoCoordinate(latitude, longitude));
+        bool ok = false;
+        const double speed = fields.at(7).toDouble(&ok);
+        if (ok)
+            info->setAttribute(QGeoPositionInfo::GroundSpeed, speed * KnotsToMetersPerSecond);
+        const double course = fields.at(8).toDouble(&ok);
+        if (ok)
+            info->setAttribute(QGeoPositionInfo::Direction, course);
+        return time->isValid();
+    }
+
+    if (type == "GGA") {
+        if (fields.size() < 10 || fields.at(6).toInt() <= 0)
+            return false;
+        if (!parseNmeaCoordinate(fields.at(2), fields.at(3), &latitude)
+            || !parseNmeaCoordinate(fields.at(4), fields.at(5), &longitude))
+            return false;
+        *time = parseNmeaTime(fields.at(1));
+        bool ok = false;
+        const double altitude = fields.at(9).toDouble(&ok);
+        info->setCoordinate(ok ? QGeoCoordinate(latitude, longitude, altitude) : QGeoCoordinate(latitude, longitude));
+        return time->isValid();
+    }
+
+    return false;
+}
+
+static void mergeNmeaPosition(QGeoPositionInfo *fix, const QGeoPositionInfo &sentence)
+{
+    auto coord = sentence.coordinate();
+    if (coord.type() != QGeoCoordinate::Coordinate3D && fix->coordinate().type() == QGeoCoordinate::Coordinate3D)
+        coord.setAltitude(fix->coordinate().altitude());
+    fix->setCoordinate(coord);
+    for (auto attr : { QGeoPositionInfo::Direction, QGeoPositionInfo::GroundSpeed }) {
+        if (sentence.hasAttribute(attr))
+            fix->setAttribute(attr, sentence.attribute(attr));
+    }
+}
+
+PositionTraceReplay::PositionTraceReplay(QObject *parent)
+    : QObject(parent)
+    , m_format(Nmea)
+    , m_timer(new QTimer(this))
+    , m_speed(1.0)
+    , m_anchorElapsed(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &PositionTraceReplay::emitNextPosition);
+}
+
+PositionTraceReplay::~PositionTraceReplay() = default;
+
+bool PositionTraceReplay::start(const QString &fileName)
+{
+    stop();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadOnly)) {
+        qWarning() << "Failed to open position trace" << fileName << m_file.errorString();
+        return false;
+    }
+    m_format = QFileInfo(fileName).suffix().compare(QLatin1String("gpx"), Qt::CaseInsensitive) == 0 ? Gpx : Nmea;
+    if (m_format == Gpx)
+        m_xml.setDevice(&m_file);
+
+    if (!readNextPosition(&m_nextPosition)) {
+        qWarning() << "No position found in trace" << fileName;
+        stop();
+        return false;
+    }
+
+    m_lastPosition = QGeoPositionInfo();
+    m_anchorTimestamp = QDateTime();
+    m_clock.start();
+    m_timer->start(0);
+    return true;
+}
+
+void PositionTraceReplay::stop()
+{
+    m_timer->stop();
+    m_xml.clear();
+    m_file.close();
+    m_pendingNmea = QGeoPositionInfo();
+    m_pendingNmeaTime = QTime();
+    m_nmeaDate = QDate();
+}
+
+bool PositionTraceReplay::isActive() const
+{
+    return m_file.isOpen();
+}
+
+void PositionTraceReplay::setSpeed(double speed)
+{
+    if (speed <= 0.0 || qFuzzyCompare(speed, m_speed))
+        return;
+    m_speed = speed;
+
+    if (!isActive() || !m_lastPosition.isValid())
+        return;
+    // continue from the last emitted position with the new speed
+    m_anchorTimestamp = m_lastPosition.timestamp();
+    m_anchorElapsed = m_clock.elapsed();
+    scheduleNextPosition();
+}
+
+QGeoPositionInfo PositionTraceReplay::lastPosition() const
+{
+    return m_lastPosition;
+}
+
+void PositionTraceReplay::emitNextPosition()
+{
+    m_lastPosition = m_nextPosition;
+    emit positionUpdated(m_lastPosition);
+
+    // a receiver might have stopped us
+    if (!isActive())
+        return;
+
+    if (!readNextPosition(&m_nextPosition)) {
+        stop();
+        emit finished();
+        return;
+    }
+    scheduleNextPosition();
+}
+
+void PositionTraceReplay::scheduleNextPosition()
+{
+    const auto last = m_lastPosition.timestamp();
+    const auto next = m_nextPosition.timestamp();
+    if (!last.isValid() || !next.isValid() || next < last) {
+        // no usable timing information, assume the common 1Hz and start over from there
+        const int interval = qRound(1000 / m_speed);
+        m_anchorTimestamp = next;
+        m_anchorElapsed = m_clock.elapsed() + interval;
+        m_timer->start(interval);
+        return;
+    }
+
+    if (!m_anchorTimestamp.isValid()) {
+        m_anchorTimestamp = last;
+        m_anchorElapsed = m_clock.elapsed();
+    }
+    const qint64 due = m_anchorElapsed + qRound64(m_anchorTimestamp.msecsTo(next) / m_speed);
+    m_timer->start(static_cast<int>(qMax<qint64>(0, due - m_clock.elapsed())));
+}
+
+bool PositionTraceReplay::readNextPosition(QGeoPositionInfo *info)
+{
+    *info = QGeoPositionInfo();
+    if (m_format == Gpx)
+        return readNextGpxPosition(info);
+    return readNextNmeaPosition(info);
+}
+
+bool PositionTraceReplay::readNextNmeaPosition(QGeoPositionInfo *info)
+{
+    const auto finishPending = [this, info]() {
+        m_pendingNmea.setTimestamp(QDateTime(m_nmeaDate.isValid() ? m_nmeaDate : QDate::currentDate(), m_pendingNmeaTime, Qt::UTC));
+        *info = m_pendingNmea;
+        m_pendingNmea = QGeoPositionInfo();
+        m_pendingNmeaTime = QTime();
+    };
+
+    while (!m_file.atEnd()) {
+        const auto line = m_file.readLine().trimmed();
+        QGeoPositionInfo sentence;
+        QTime time;
+        QDate date;
+        if (!parseNmeaSentence(line, &sentence, &time, &date))
+            continue;
+
+        if (m_pendingNmeaTime.isValid() && time != m_pendingNmeaTime) {
+            finishPending();
+            m_pendingNmea = sentence;
+            m_pendingNmeaTime = time;
+            if (date.isValid())
+                m_nmeaDate = date;
+            return true;
+        }
+
+        mergeNmeaPosition(&m_pendingNmea, sentence);
+        m_pendingNmeaTime = time;
+        if (date.isValid())
+            m_nmeaDate = date;
+    }
+
+    if (!m_pendingNmeaTime.isValid())
+        return false;
+    finishPending();
+    return true;
+}
+
+bool PositionTraceReplay::readNextGpxPosition(QGeoPositionInfo *info)
+{
+    while (!m_xml.atEnd()) {
+        m_xml.readNext();
+        if (!m_xml.isStartElement())
+            continue;
+        if (m_xml.name() != QLatin1String("trkpt") && m_xml.name() != QLatin1String("rtept")
+            && m_xml.name() != QLatin1String("wpt"))
+            continue;
+
+        const auto attrs = m_xml.attributes();
+        QGeoCoordinate coord(attrs.value(QLatin1String("lat")).toDouble(),
+                             attrs.value(QLatin1String("lon")).toDouble());
+        while (m_xml.readNextStartElement()) {
+            if (m_xml.name() == QLatin1String("ele"))
+                coord.setAltitude(m_xml.readElementText().toDouble());
+            else if (m_xml.name() == QLatin1String("time"))
+                info->setTimestamp(QDateTime::fromString(m_xml.readElementText(), Qt::ISODate));
+            else if (m_xml.name() == QLatin1String("speed")) // GPX 1.0 only
+                info->setAttribute(QGeoPositionInfo::GroundSpeed, m_xml.readElementText().toDouble());
+            else if (m_xml.name() == QLatin1String("course")) // GPX 1.0 only
+                info->setAttribute(QGeoPositionInfo::Direction, m_xml.readElementText().toDouble());
+            else
+                m_xml.skipCurrentElement();
+        }
+        info->setCoordinate(coord);
+        return true;
+    }
+
+    if (m_xml.hasError())
+        qWarning() << "Failed to parse GPX trace:" << m_xml.errorString();
+    return false;
+}
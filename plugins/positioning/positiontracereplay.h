@@ -0,0 +1,105 @@
+/*
+  positiontracereplay.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef GAMMARAY_POSITIONTRACEREPLAY_H
+#define GAMMARAY_POSITIONTRACEREPLAY_H
+
+#include <QDate>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGeoPositionInfo>
+#include <QObject>
+#include <QTime>
+#include <QXmlStreamReader>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+
+/** Replays a recorded NMEA or GPX position trace at a configurable speed.
+ *  The file is read incrementally, only the next fix is kept in memory.
+ */
+class PositionTraceReplay : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PositionTraceReplay(QObject *parent = nullptr);
+    ~PositionTraceReplay() override;
+
+    /** Starts replaying @p fileName, GPX files are recognized by their suffix. */
+    bool start(const QString &fileName);
+    void stop();
+    bool isActive() const;
+
+    /** Replay speed multiplier, 1.0 means the timing of the recording. */
+    void setSpeed(double speed);
+
+    QGeoPositionInfo lastPosition() const;
+
+signals:
+    void positionUpdated(const QGeoPositionInfo &info);
+    void finished();
+
+private slots:
+    void emitNextPosition();
+
+private:
+    bool readNextPosition(QGeoPositionInfo *info);
+    bool readNextNmeaPosition(QGeoPositionInfo *info);
+    bool readNextGpxPosition(QGeoPositionInfo *info);
+    void scheduleNextPosition();
+
+    enum Format {
+        Nmea,
+        Gpx
+    };
+
+    QFile m_file;
+    Format m_format;
+    QXmlStreamReader m_xml;
+
+    // NMEA sentences of the same fix are merged until the time changes
+    QGeoPositionInfo m_pendingNmea;
+    QTime m_pendingNmeaTime;
+    QDate m_nmeaDate;
+
+    QGeoPositionInfo m_nextPosition;
+    QGeoPositionInfo m_lastPosition;
+    QTimer *m_timer;
+    double m_speed;
+    // wall clock anchor, so timer inaccuracies don't accumulate over long traces
+    QElapsedTimer m_clock;
+    QDateTime m_anchorTimestamp;
+    qint64 m_anchorElapsed;
+};
+
+}
+
+#endif // GAMMARAY_POSITIONTRACEREPLAY_H
@@ -41,6 +41,7 @@
 #include <core/varianthandler.h>
 
 #include <common/modelevent.h>
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 
 #include <3rdparty/kde/krecursivefilterproxymodel.h>
@@ -194,15 +195,10 @@ void Qt3DInspector::selectEntity(Qt3DCore::QEntity *entity)
     const auto model = m_entitySelectionModel->model();
     Model::used(model);
 
-    const auto indexList = model->match(model->index(0,
-                                                     0), ObjectModel::ObjectRole,
-                                        QVariant::fromValue<Qt3DCore::QEntity *>(
-                                            entity), 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const auto index = ModelUtils::indexForObject(model, entity);
+    if (!index.isValid())
         return;
 
-    const auto index = indexList.first();
     m_entitySelectionModel->select(index,
                                    QItemSelectionModel::Select | QItemSelectionModel::Clear | QItemSelectionModel::Rows
                                    | QItemSelectionModel::Current);
@@ -230,15 +226,10 @@ void Qt3DInspector::selectFrameGraphNode(Qt3DRender::QFrameGraphNode *node)
     const auto model = m_frameGraphSelectionModel->model();
     Model::used(model);
 
-    const auto indexList = model->match(model->index(0,
-                                                     0), ObjectModel::ObjectRole,
-                                        QVariant::fromValue<Qt3DRender::QFrameGraphNode *>(
-                                            node), 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const auto index = ModelUtils::indexForObject(model, node);
+    if (!index.isValid())
         return;
 
-    const auto index = indexList.first();
     m_frameGraphSelectionModel->select(index,
                                        QItemSelectionModel::Select |
                                        QItemSelectionModel::Clear |
@@ -136,6 +136,11 @@ bool FrameGraphModel::setData(const QModelIndex &index, const QVariant &value, i
     return true;
 }
 
+QModelIndex FrameGraphModel::indexForObject(QObject *object) const
+{
+    return indexForNode(qobject_cast<Qt3DRender::QFrameGraphNode *>(object));
+}
+
 QModelIndex FrameGraphModel::indexForNode(Qt3DRender::QFrameGraphNode *node) const
 {
     if (!node)
@@ -59,6 +59,8 @@ public:
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
 public slots:
     void objectCreated(QObject *obj);
     void objectDestroyed(QObject *obj);
@@ -40,18 +40,244 @@
 #include <Qt3DCore/QEntity>
 
 #include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QVector3D>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 using namespace GammaRay;
 
+// small enough to keep the connection responsive in between
+static const int BufferChunkSize = 256 * 1024;
+// cluster indexes need to fit into 21 bits for deduplicating triangles
+static const uint MaxPreviewVertexCount = 1 << 21;
+// how many vertices or triangles are processed between checks for a newer request
+static const uint InterruptionCheckInterval = 1 << 16;
+
+static uint indexSize(Qt3DRender::QAttribute::VertexBaseType type)
+{
+    switch (type) {
+    case Qt3DRender::QAttribute::UnsignedByte:
+        return sizeof(quint8);
+    case Qt3DRender::QAttribute::UnsignedShort:
+        return sizeof(quint16);
+    case Qt3DRender::QAttribute::UnsignedInt:
+        return sizeof(quint32);
+    default:
+        return 0;
+    }
+}
+
+/* Simplifies the triangles of @p geometry by vertex clustering: vertices are merged per cell
+ * of a regular grid over the bounding box, and triangles collapsing in the process are dropped.
+ * Runs in a worker thread, the result is incomplete if its interruption has been requested.
+ */
+static Qt3DGeometryData createPreview(const Qt3DGeometryData &geometry, const QVector<QByteArray> &buffers,
+                                      uint maxVertexCount)
+{
+    Qt3DGeometryData preview;
+    preview.serial = geometry.serial;
+
+    const Qt3DGeometryAttributeData *posAttr = nullptr;
+    const Qt3DGeometryAttributeData *indexAttr = nullptr;
+    for (const auto &attr : geometry.attributes) {
+        if (attr.name == Qt3DRender::QAttribute::defaultPositionAttributeName())
+            posAttr = &attr;
+        else if (attr.attributeType == Qt3DRender::QAttribute::IndexAttribute)
+            indexAttr = &attr;
+    }
+    if (!posAttr || posAttr->vertexBaseType != Qt3DRender::QAttribute::Float || posAttr->vertexSize < 3 || posAttr->count == 0)
+        return preview;
+
+    const auto &posData = buffers.at(posAttr->bufferIndex);
+    const auto posStride = std::max<quint64>(posAttr->byteStride, sizeof(float) * posAttr->vertexSize);
+    if (posAttr->byteOffset + (posAttr->count - 1) * posStride + 3 * sizeof(float) > quint64(posData.size()))
+        return preview;
+    const auto position = [&posData, posAttr, posStride](uint i) {
+        float v[3];
+        memcpy(v, posData.constData() + posAttr->byteOffset + i * posStride, sizeof(v));
+        return QVector3D(v[0], v[1], v[2]);
+    };
+
+    uint indexCount = posAttr->count;
+    const char *indexData = nullptr;
+    quint64 indexStride = 0;
+    if (indexAttr) {
+        const auto &data = buffers.at(indexAttr->bufferIndex);
+        const auto size = indexSize(indexAttr->vertexBaseType);
+        indexStride = std::max<quint64>(indexAttr->byteStride, size);
+        if (!size || indexAttr->count == 0
+            || indexAttr->byteOffset + (indexAttr->count - 1) * indexStride + size > quint64(data.size()))
+            return preview;
+        indexCount = indexAttr->count;
+        indexData = data.constData() + indexAttr->byteOffset;
+    }
+    const auto vertexIndex = [indexAttr, indexData, indexStride](uint i) -> uint {
+        if (!indexData)
+            return i;
+        const auto c = indexData + i * indexStride;
+        switch (indexAttr->vertexBaseType) {
+        case Qt3DRender::QAttribute::UnsignedByte:
+            return *reinterpret_cast<const quint8 *>(c);
+        case Qt3DRender::QAttribute::UnsignedShort: {
+            quint16 v;
+            memcpy(&v, c, sizeof(v));
+            return v;
+        }
+        default: {
+            quint32 v;
+            memcpy(&v, c, sizeof(v));
+            return v;
+        }
+        }
+    };
+
+    const auto interrupted = [](uint i) {
+        return i % InterruptionCheckInterval == 0 && QThread::currentThread()->isInterruptionRequested();
+    };
+
+    QVector3D min = position(0);
+    QVector3D max = min;
+    for (uint i = 1; i < posAttr->count; ++i) {
+        if (interrupted(i))
+            return preview;
+        const auto v = position(i);
+        min = QVector3D(std::min(min.x(), v.x()), std::min(min.y(), v.y()), std::min(min.z(), v.z()));
+        max = QVector3D(std::max(max.x(), v.x()), std::max(max.y(), v.y()), std::max(max.z(), v.z()));
+    }
+
+    const int cells = std::max(2, int(std::cbrt(double(std::min(maxVertexCount, MaxPreviewVertexCount)))));
+    auto cellSize = (max - min) / cells;
+    for (int i = 0; i < 3; ++i) {
+        if (cellSize[i] <= 0.0f)
+            cellSize[i] = 1.0f;
+    }
+    const auto cellIndex = [cells](float v) {
+        return qBound(0, int(v), cells - 1);
+    };
+
+    QHash<quint32, quint32> cellClusters;
+    QVector<quint32> vertexClusters(posAttr->count);
+    QVector<QVector3D> clusterSums;
+    QVector<uint> clusterSizes;
+    for (uint i = 0; i < posAttr->count; ++i) {
+        if (interrupted(i))
+            return preview;
+        const auto v = position(i);
+        const auto p = (v - min) / cellSize;
+        const quint32 cell = (quint32(cellIndex(p.x())) * cells + cellIndex(p.y())) * cells + cellIndex(p.z());
+        auto it = cellClusters.find(cell);
+        if (it == cellClusters.end()) {
+            it = cellClusters.insert(cell, clusterSums.size());
+            clusterSums.push_back(QVector3D());
+            clusterSizes.push_back(0);
+        }
+        clusterSums[it.value()] += v;
+        ++clusterSizes[it.value()];
+        vertexClusters[i] = it.value();
+    }
+
+    QByteArray indexes;
+    QSet<quint64> triangles;
+    for (uint i = 0; i + 2 < indexCount; i += 3) {
+        if (interrupted(i / 3))
+            return preview;
+        quint32 t[3];
+        bool valid = true;
+        for (int j = 0; j < 3; ++j) {
+            const auto idx = vertexIndex(i + j);
+            valid = valid && idx < posAttr->count;
+            t[j] = valid ? vertexClusters.at(idx) : 0;
+        }
+        if (!valid || t[0] == t[1] || t[1] == t[2] || t[0] == t[2])
+            continue;
+        // the same triangle with a different winding is still a duplicate
+        quint32 s[3] = { t[0], t[1], t[2] };
+        std::sort(s, s + 3);
+        const auto key = (quint64(s[0]) << 42) | (quint64(s[1]) << 21) | quint64(s[2]);
+        if (triangles.contains(key))
+            continue;
+        triangles.insert(key);
+        indexes.append(reinterpret_cast<const char *>(t), sizeof(t));
+    }
+
+    QByteArray positions;
+    positions.resize(clusterSums.size() * 3 * sizeof(float));
+    auto f = reinterpret_cast<float *>(positions.data());
+    for (int i = 0; i < clusterSums.size(); ++i) {
+        const auto v = clusterSums.at(i) / clusterSizes.at(i);
+        *f++ = v.x();
+        *f++ = v.y();
+        *f++ = v.z();
+    }
+
+    Qt3DGeometryBufferData posBuffer;
+    posBuffer.data = positions;
+    posBuffer.size = positions.size();
+    preview.buffers.push_back(posBuffer);
+    Qt3DGeometryBufferData indexBuffer;
+    indexBuffer.type = Qt3DRender::QBuffer::IndexBuffer;
+    indexBuffer.data = indexes;
+    indexBuffer.size = indexes.size();
+    preview.buffers.push_back(indexBuffer);
+
+    Qt3DGeometryAttributeData previewPosAttr;
+    previewPosAttr.name = Qt3DRender::QAttribute::defaultPositionAttributeName();
+    previewPosAttr.count = clusterSums.size();
+    previewPosAttr.vertexBaseType = Qt3DRender::QAttribute::Float;
+    previewPosAttr.vertexSize = 3;
+    previewPosAttr.bufferIndex = 0;
+    preview.attributes.push_back(previewPosAttr);
+    Qt3DGeometryAttributeData previewIndexAttr;
+    previewIndexAttr.attributeType = Qt3DRender::QAttribute::IndexAttribute;
+    previewIndexAttr.count = indexes.size() / sizeof(quint32);
+    previewIndexAttr.vertexBaseType = Qt3DRender::QAttribute::UnsignedInt;
+    previewIndexAttr.vertexSize = 1;
+    previewIndexAttr.bufferIndex = 1;
+    preview.attributes.push_back(previewIndexAttr);
+    return preview;
+}
+
+namespace GammaRay {
+// computes a preview off the thread owning the geometry, large meshes take a while
+class Qt3DGeometryPreviewThread : public QThread
+{
+public:
+    explicit Qt3DGeometryPreviewThread(QObject *parent)
+        : QThread(parent)
+    {
+    }
+
+    Qt3DGeometryData geometry;
+    QVector<QByteArray> buffers;
+    uint maxVertexCount = 0;
+    Qt3DGeometryData preview;
+
+protected:
+    void run() override
+    {
+        preview = createPreview(geometry, buffers, maxVertexCount);
+    }
+};
+}
+
 Qt3DGeometryExtension::Qt3DGeometryExtension(GammaRay::PropertyController *controller)
     : Qt3DGeometryExtensionInterface(controller->objectBaseName() + ".qt3dGeometry", controller)
     , PropertyControllerExtension(controller->objectBaseName() + ".qt3dGeometry")
     , m_geometry(nullptr)
+    , m_previewThread(new Qt3DGeometryPreviewThread(this))
 {
+    connect(m_previewThread, &QThread::finished, this, &Qt3DGeometryExtension::previewFinished);
 }
 
 Qt3DGeometryExtension::~Qt3DGeometryExtension()
 {
+    m_previewThread->requestInterruption();
+    m_previewThread->wait();
 }
 
 bool Qt3DGeometryExtension::setQObject(QObject *object)
@@ -87,6 +313,11 @@ bool Qt3DGeometryExtension::setQObject(QObject *object)
 void Qt3DGeometryExtension::updateGeometryData()
 {
     Qt3DGeometryData data;
+    data.serial = ++m_serial;
+    m_bufferData.clear();
+    // a preview in progress or requested is outdated now
+    m_previewRequested = false;
+    m_previewThread->requestInterruption();
     if (!m_geometry || !m_geometry->geometry()) {
         setGeometryData(data);
         return;
@@ -115,17 +346,62 @@ void Qt3DGeometryExtension::updateGeometryData()
             buffer.name = Util::displayString(attr->buffer());
             buffer.type = attr->buffer()->type();
             auto generator = attr->buffer()->dataGenerator();
-            if (generator)
-                buffer.data = (*generator.data())();
-            else
-                buffer.data = attr->buffer()->data();
+            // the content is only sent on request, implicit sharing keeps this cheap
+            const auto bufferData = generator ? (*generator.data())() : attr->buffer()->data();
+            buffer.size = bufferData.size();
 
             attrData.bufferIndex = data.buffers.size();
             bufferMap.insert(attr->buffer(), attrData.bufferIndex);
             data.buffers.push_back(buffer);
+            m_bufferData.push_back(bufferData);
         }
         data.attributes.push_back(attrData);
     }
 
     setGeometryData(data);
 }
+
+void Qt3DGeometryExtension::requestPreview(quint32 serial, uint maxVertexCount)
+{
+    if (serial != m_serial)
+        return;
+
+    m_previewVertexCount = maxVertexCount;
+    m_previewRequested = true;
+    // restarted once the outdated run has finished
+    if (m_previewThread->isRunning())
+        m_previewThread->requestInterruption();
+    else
+        startPreview();
+}
+
+void Qt3DGeometryExtension::startPreview()
+{
+    m_previewRequested = false;
+    m_previewThread->geometry = geometryData();
+    m_previewThread->buffers = m_bufferData;
+    m_previewThread->maxVertexCount = m_previewVertexCount;
+    m_previewThread->preview = Qt3DGeometryData();
+    m_previewThread->start(QThread::LowPriority);
+}
+
+void Qt3DGeometryExtension::previewFinished()
+{
+    if (m_previewRequested) {
+        startPreview();
+        return;
+    }
+    if (m_previewThread->isInterruptionRequested() || m_previewThread->preview.serial != m_serial)
+        return;
+    emit previewAvailable(m_previewThread->preview);
+}
+
+void Qt3DGeometryExtension::requestBufferData(quint32 serial, uint bufferIndex, uint offset)
+{
+    if (serial != m_serial || bufferIndex >= uint(m_bufferData.size()))
+        return;
+    const auto &data = m_bufferData.at(bufferIndex);
+    if (offset >= uint(data.size()))
+        return;
+    emit bufferDataAvailable(serial, bufferIndex, offset, data.mid(int(offset), BufferChunkSize));
+}
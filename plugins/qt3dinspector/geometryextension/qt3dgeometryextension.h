@@ -40,6 +40,8 @@ class QGeometryRenderer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+class Qt3DGeometryPreviewThread;
+
 class Qt3DGeometryExtension : public Qt3DGeometryExtensionInterface,
     public PropertyControllerExtension
 {
@@ -51,10 +53,25 @@ public:
 
     bool setQObject(QObject *object) override;
 
+public slots:
+    void requestPreview(quint32 serial, uint maxVertexCount) override;
+    void requestBufferData(quint32 serial, uint bufferIndex, uint offset) override;
+
+private slots:
+    void previewFinished();
+
 private:
     void updateGeometryData();
+    void startPreview();
 
     Qt3DRender::QGeometryRenderer *m_geometry;
+    // snapshot of the buffer contents of the current geometry, handed out in chunks
+    QVector<QByteArray> m_bufferData;
+    quint32 m_serial = 0;
+
+    Qt3DGeometryPreviewThread *m_previewThread;
+    uint m_previewVertexCount = 0;
+    bool m_previewRequested = false;
 };
 }
 
@@ -28,9 +28,23 @@
 
 #include "qt3dgeometryextensionclient.h"
 
+#include <common/endpoint.h>
+
 using namespace GammaRay;
 
 Qt3DGeometryExtensionClient::Qt3DGeometryExtensionClient(const QString &name, QObject *parent)
     : Qt3DGeometryExtensionInterface(name, parent)
 {
 }
+
+void Qt3DGeometryExtensionClient::requestPreview(quint32 serial, uint maxVertexCount)
+{
+    Endpoint::instance()->invokeObject(objectName(), "requestPreview",
+                                       QVariantList() << serial << maxVertexCount);
+}
+
+void Qt3DGeometryExtensionClient::requestBufferData(quint32 serial, uint bufferIndex, uint offset)
+{
+    Endpoint::instance()->invokeObject(objectName(), "requestBufferData",
+                                       QVariantList() << serial << bufferIndex << offset);
+}
@@ -38,6 +38,10 @@ class Qt3DGeometryExtensionClient : public Qt3DGeometryExtensionInterface
     Q_INTERFACES(GammaRay::Qt3DGeometryExtensionInterface)
 public:
     explicit Qt3DGeometryExtensionClient(const QString &name, QObject *parent);
+
+public slots:
+    void requestPreview(quint32 serial, uint maxVertexCount) override;
+    void requestBufferData(quint32 serial, uint bufferIndex, uint offset) override;
 };
 }
 
@@ -72,39 +72,39 @@ bool Qt3DGeometryAttributeData::operator==(const Qt3DGeometryAttributeData &rhs)
 QT_BEGIN_NAMESPACE
 static QDataStream &operator<<(QDataStream &out, const Qt3DGeometryBufferData &data)
 {
-    out << data.name << data.data << data.type;
+    out << data.name << data.data << data.type << data.size;
     return out;
 }
 
 static QDataStream &operator>>(QDataStream &in, Qt3DGeometryBufferData &data)
 {
-    in >> data.name >> data.data >> data.type;
+    in >> data.name >> data.data >> data.type >> data.size;
     return in;
 }
 QT_END_NAMESPACE
 
 bool Qt3DGeometryBufferData::operator==(const Qt3DGeometryBufferData &rhs) const
 {
-    return name == rhs.name && data == rhs.data;
+    return name == rhs.name && data == rhs.data && size == rhs.size;
 }
 
 QT_BEGIN_NAMESPACE
 static QDataStream &operator<<(QDataStream &out, const Qt3DGeometryData &data)
 {
-    out << data.attributes << data.buffers;
+    out << data.attributes << data.buffers << data.serial;
     return out;
 }
 
 static QDataStream &operator>>(QDataStream &in, Qt3DGeometryData &data)
 {
-    in >> data.attributes >> data.buffers;
+    in >> data.attributes >> data.buffers >> data.serial;
     return in;
 }
 QT_END_NAMESPACE
 
 bool Qt3DGeometryData::operator==(const Qt3DGeometryData &rhs) const
 {
-    return attributes == rhs.attributes && buffers == rhs.buffers;
+    return attributes == rhs.attributes && buffers == rhs.buffers && serial == rhs.serial;
 }
 
 Qt3DGeometryExtensionInterface::Qt3DGeometryExtensionInterface(const QString &name, QObject *parent)
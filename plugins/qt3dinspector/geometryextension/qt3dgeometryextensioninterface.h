@@ -55,8 +55,9 @@ struct Qt3DGeometryBufferData
     bool operator==(const Qt3DGeometryBufferData &rhs) const;
 
     QString name;
-    QByteArray data;
+    QByteArray data; // transferred separately in chunks, see requestBufferData()
     Qt3DRender::QBuffer::BufferType type = Qt3DRender::QBuffer::VertexBuffer;
+    uint size = 0;
 };
 
 struct Qt3DGeometryData
@@ -65,6 +66,7 @@ struct Qt3DGeometryData
 
     QVector<Qt3DGeometryAttributeData> attributes;
     QVector<Qt3DGeometryBufferData> buffers;
+    quint32 serial = 0; // identifies the geometry chunks and previews belong to
 };
 
 class Qt3DGeometryExtensionInterface : public QObject
@@ -79,8 +81,22 @@ public:
     Qt3DGeometryData geometryData() const;
     void setGeometryData(const Qt3DGeometryData &data);
 
+public slots:
+    /** Requests a simplified version of geometry @p serial with about @p maxVertexCount vertices,
+     *  answered by previewAvailable() once computed, unless a newer request or geometry supersedes it.
+     *  The preview contains buffer data, and only triangles.
+     */
+    virtual void requestPreview(quint32 serial, uint maxVertexCount) = 0;
+    /** Requests the next chunk of buffer @p bufferIndex of geometry @p serial, starting at @p offset,
+     *  answered by bufferDataAvailable().
+     */
+    virtual void requestBufferData(quint32 serial, uint bufferIndex, uint offset) = 0;
+
 signals:
     void geometryDataChanged();
+    /// Empty if no preview can be created for this geometry.
+    void previewAvailable(const GammaRay::Qt3DGeometryData &preview);
+    void bufferDataAvailable(quint32 serial, uint bufferIndex, uint offset, const QByteArray &data);
 
 private:
     Qt3DGeometryData m_data;
@@ -78,6 +78,10 @@
 
 using namespace GammaRay;
 
+// geometry larger than this is first shown as a simplified preview while being transferred
+static const quint64 PreviewThreshold = 4 * 1024 * 1024;
+static const uint PreviewVertexCount = 32 * 1024;
+
 // ### keep in sync with wireframe.vert/wireframe.frag
 enum ShadingMode {
     ShadingModeFlat = 0,
@@ -122,6 +126,10 @@ Qt3DGeometryTab::Qt3DGeometryTab(PropertyWidget *parent)
     m_shadingModeCombo = new QComboBox(toolbar);
     m_shadingModeCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
     auto shadingModeAction = toolbar->addWidget(m_shadingModeCombo);
+    toolbar->addSeparator();
+    m_transferLabel = new QLabel(toolbar);
+    m_transferAction = toolbar->addWidget(m_transferLabel);
+    m_transferAction->setVisible(false);
 
     connect(ui->actionResetCam, &QAction::triggered, this, &Qt3DGeometryTab::resetCamera);
 
@@ -187,7 +195,12 @@ Qt3DGeometryTab::Qt3DGeometryTab(PropertyWidget *parent)
     m_interface = ObjectBroker::object<Qt3DGeometryExtensionInterface *>(
         parent->objectBaseName() + ".qt3dGeometry");
     connect(m_interface, &Qt3DGeometryExtensionInterface::geometryDataChanged, this,
-            &Qt3DGeometryTab::updateGeometry);
+            &Qt3DGeometryTab::startGeometryTransfer);
+    connect(m_interface, &Qt3DGeometryExtensionInterface::previewAvailable, this,
+            &Qt3DGeometryTab::previewReceived);
+    connect(m_interface, &Qt3DGeometryExtensionInterface::bufferDataAvailable, this,
+            &Qt3DGeometryTab::bufferDataReceived);
+    startGeometryTransfer();
 }
 
 Qt3DGeometryTab::~Qt3DGeometryTab() = default;
@@ -461,11 +474,79 @@ static void setupAttribute(Qt3DRender::QAttribute *attr, const Qt3DGeometryAttri
     attr->setDataSize(attrData.vertexSize);
 }
 
+void Qt3DGeometryTab::startGeometryTransfer()
+{
+    m_geometryData = m_interface->geometryData();
+    m_preview = Qt3DGeometryData();
+    ui->bufferBox->clear();
+    m_bufferModel->setGeometryData(Qt3DGeometryData());
+
+    quint64 totalSize = 0;
+    for (auto &buffer : m_geometryData.buffers) {
+        buffer.data.reserve(buffer.size);
+        totalSize += buffer.size;
+    }
+    if (totalSize >= PreviewThreshold)
+        m_interface->requestPreview(m_geometryData.serial, PreviewVertexCount);
+
+    m_transferBuffer = 0;
+    requestNextBufferChunk();
+}
+
+void Qt3DGeometryTab::previewReceived(const Qt3DGeometryData &preview)
+{
+    if (preview.serial != m_geometryData.serial || m_transferBuffer < 0 || preview.attributes.isEmpty())
+        return;
+    m_preview = preview;
+    updateGeometry();
+}
+
+void Qt3DGeometryTab::bufferDataReceived(quint32 serial, uint bufferIndex, uint offset, const QByteArray &data)
+{
+    if (serial != m_geometryData.serial || int(bufferIndex) != m_transferBuffer)
+        return;
+    auto &buffer = m_geometryData.buffers[m_transferBuffer];
+    if (offset != uint(buffer.data.size()))
+        return;
+    buffer.data.append(data);
+    requestNextBufferChunk();
+}
+
+void Qt3DGeometryTab::requestNextBufferChunk()
+{
+    const auto &buffers = m_geometryData.buffers;
+    while (m_transferBuffer < buffers.size() && uint(buffers.at(m_transferBuffer).data.size()) >= buffers.at(m_transferBuffer).size)
+        ++m_transferBuffer;
+
+    if (m_transferBuffer < buffers.size()) {
+        // one chunk at a time, so everything else on the connection gets through in between
+        quint64 totalSize = 0;
+        quint64 transferredSize = 0;
+        for (const auto &buffer : buffers) {
+            totalSize += buffer.size;
+            transferredSize += buffer.data.size();
+        }
+        m_transferLabel->setText(m_preview.attributes.isEmpty()
+                                 ? tr("Loading geometry: %1%").arg(transferredSize * 100 / totalSize)
+                                 : tr("Showing preview, loading geometry: %1%").arg(transferredSize * 100 / totalSize));
+        m_transferAction->setVisible(true);
+        m_interface->requestBufferData(m_geometryData.serial, m_transferBuffer, buffers.at(m_transferBuffer).data.size());
+        return;
+    }
+
+    m_transferBuffer = -1;
+    m_transferAction->setVisible(false);
+    m_preview = Qt3DGeometryData();
+    m_bufferModel->setGeometryData(m_geometryData);
+    for (const auto &bufferData : buffers)
+        ui->bufferBox->addItem(bufferData.name);
+    updateGeometry();
+}
+
 void Qt3DGeometryTab::updateGeometry()
 {
     ui->actionShowNormals->setEnabled(false);
     ui->actionShowTangents->setEnabled(false);
-    ui->bufferBox->clear();
     const auto prevShadingMode = m_shadingModeCombo->currentData();
     m_shadingModeCombo->clear();
     m_shadingModeCombo->addItem(tr("Flat"), ShadingModeFlat);
@@ -474,8 +555,7 @@ void Qt3DGeometryTab::updateGeometry()
     if (!m_geometryRenderer)
         return;
 
-    const auto geo = m_interface->geometryData();
-    m_bufferModel->setGeometryData(geo);
+    const auto &geo = m_transferBuffer < 0 ? m_geometryData : m_preview;
 
     auto geometry = new Qt3DRender::QGeometry();
     QVector<Qt3DRender::QBuffer *> buffers;
@@ -484,7 +564,6 @@ void Qt3DGeometryTab::updateGeometry()
         auto buffer = new Qt3DRender::QBuffer(bufferData.type, geometry);
         buffer->setData(bufferData.data);
         buffers.push_back(buffer);
-        ui->bufferBox->addItem(bufferData.name, QVariant::fromValue(buffer));
     }
 
     for (const auto &attrData : geo.attributes) {
@@ -625,7 +704,8 @@ bool Qt3DGeometryTab::isIndexBuffer(unsigned int bufferIndex) const
 void Qt3DGeometryTab::trianglePicked(Qt3DRender::QPickEvent* pick)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
-    if (pick->button() != Qt3DRender::QPickEvent::LeftButton)
+    // the preview has nothing in common with the buffers shown
+    if (pick->button() != Qt3DRender::QPickEvent::LeftButton || m_transferBuffer >= 0)
         return;
     const auto trianglePick = qobject_cast<Qt3DRender::QPickTriangleEvent*>(pick);
 
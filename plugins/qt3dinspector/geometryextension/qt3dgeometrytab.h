@@ -30,6 +30,7 @@
 #define GAMMARAY_QT3DGEOMETRYTAB_H
 
 #include "boundingvolume.h"
+#include "qt3dgeometryextensioninterface.h"
 
 #include <QWidget>
 
@@ -51,15 +52,15 @@ class QParameter;
 class QPickEvent;
 class QRenderPass;
 }
+class QAction;
 class QComboBox;
+class QLabel;
 class QSurfaceFormat;
 QT_END_NAMESPACE
 
 namespace GammaRay {
 class BufferModel;
 class PropertyWidget;
-class Qt3DGeometryExtensionInterface;
-struct Qt3DGeometryAttributeData;
 
 namespace Ui {
 class Qt3DGeometryTab;
@@ -80,6 +81,10 @@ private:
     Qt3DCore::QComponent *createMaterial(Qt3DCore::QNode *parent);
     Qt3DCore::QComponent *createES2WireframeMaterial(Qt3DCore::QNode *parent);
     Qt3DCore::QComponent *createSkyboxMaterial(Qt3DCore::QNode *parent);
+    void startGeometryTransfer();
+    void previewReceived(const GammaRay::Qt3DGeometryData &preview);
+    void bufferDataReceived(quint32 serial, uint bufferIndex, uint offset, const QByteArray &data);
+    void requestNextBufferChunk();
     void updateGeometry();
     void resetCamera();
     void computeBoundingVolume(const Qt3DGeometryAttributeData &vertexAttr,
@@ -90,7 +95,13 @@ private:
 
     std::unique_ptr<Ui::Qt3DGeometryTab> ui;
     QComboBox *m_shadingModeCombo;
+    QLabel *m_transferLabel;
+    QAction *m_transferAction;
     Qt3DGeometryExtensionInterface *m_interface;
+    // filled in chunk by chunk, the preview is shown until complete
+    Qt3DGeometryData m_geometryData;
+    Qt3DGeometryData m_preview;
+    int m_transferBuffer = -1; // -1 once the transfer is complete
 
     QWindow *m_surface;
     Qt3DCore::QAspectEngine *m_aspectEngine;
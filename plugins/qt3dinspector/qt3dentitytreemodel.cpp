@@ -149,6 +149,11 @@ bool Qt3DEntityTreeModel::setData(const QModelIndex &index, const QVariant &valu
     return true;
 }
 
+QModelIndex Qt3DEntityTreeModel::indexForObject(QObject *object) const
+{
+    return indexForEntity(qobject_cast<Qt3DCore::QEntity *>(object));
+}
+
 QModelIndex Qt3DEntityTreeModel::indexForEntity(Qt3DCore::QEntity *entity) const
 {
     if (!entity)
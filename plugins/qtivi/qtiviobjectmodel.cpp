@@ -321,9 +321,7 @@ void QtIviObjectModel::objectReparented(QObject *obj)
 
 void QtIviObjectModel::objectSelected(QObject *obj)
 {
-    const ObjectId id(obj);
-    const QModelIndex index = match(this->index(0, 0), ObjectModel::ObjectIdRole, QVariant::fromValue(id), 1,
-                                    Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap).value(0);
+    const QModelIndex index = indexOfCarrier(obj, 0);
     if (!index.isValid()) {
         return;
     }
@@ -531,9 +531,7 @@ void QtIviPropertyModel::objectReparented(QObject *obj)
 
 void QtIviPropertyModel::objectSelected(QObject *obj)
 {
-    const ObjectId id(obj);
-    const QModelIndex index = match(this->index(0, 0), ObjectModel::ObjectIdRole, QVariant::fromValue(id), 1,
-                                    Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap).value(0);
+    const QModelIndex index = indexOfCarrier(obj, 0);
     if (!index.isValid()) {
         return;
     }
@@ -45,6 +45,7 @@
 
 #include <common/endpoint.h>
 #include <common/modelevent.h>
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/probecontrollerinterface.h>
 #include <common/problem.h>
@@ -488,15 +489,10 @@ void QuickInspector::selectItem(QQuickItem *item)
     Model::used(model);
     Model::used(m_sgSelectionModel->model());
 
-    const QModelIndexList indexList
-        = model->match(model->index(0, 0),
-                       ObjectModel::ObjectRole,
-                       QVariant::fromValue<QQuickItem *>(item), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const QModelIndex index = ModelUtils::indexForObject(model, item);
+    if (!index.isValid())
         return;
 
-    const QModelIndex index = indexList.first();
     m_itemSelectionModel->select(index,
                                  QItemSelectionModel::Select
                                  |QItemSelectionModel::Clear
@@ -506,18 +502,15 @@ void QuickInspector::selectItem(QQuickItem *item)
 
 void QuickInspector::selectSGNode(QSGNode *node)
 {
-    const QAbstractItemModel *model = m_sgSelectionModel->model();
+    const auto model = qobject_cast<const QAbstractProxyModel *>(m_sgSelectionModel->model());
+    if (!model)
+        return;
     Model::used(model);
 
-    const QModelIndexList indexList = model->match(model->index(0, 0), ObjectModel::ObjectRole,
-                                                   QVariant::fromValue(
-                                                       node), 1,
-                                                   Qt::MatchExactly | Qt::MatchRecursive
-                                                   | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const QModelIndex index = model->mapFromSource(m_sgModel->indexForNode(node));
+    if (!index.isValid())
         return;
 
-    const QModelIndex index = indexList.first();
     m_sgSelectionModel->select(index,
                                QItemSelectionModel::Select
                                |QItemSelectionModel::Clear
@@ -177,6 +177,11 @@ void QuickItemModel::disconnectItem(QQuickItem *item)
     item->removeEventFilter(m_clickEventFilter);
 }
 
+QModelIndex QuickItemModel::indexForObject(QObject *object) const
+{
+    return indexForItem(qobject_cast<QQuickItem *>(object));
+}
+
 QModelIndex QuickItemModel::indexForItem(QQuickItem *item) const
 {
     if (!item)
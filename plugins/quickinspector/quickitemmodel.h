@@ -67,6 +67,8 @@ public:
     QModelIndex index(int row, int column, const QModelIndex &parent) const override;
     QMap< int, QVariant > itemData(const QModelIndex &index) const override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
 public slots:
     void objectAdded(QObject *obj);
     void objectRemoved(QObject *obj);
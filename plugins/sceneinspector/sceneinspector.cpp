@@ -50,6 +50,7 @@
 
 #include <kde/krecursivefilterproxymodel.h>
 
+#include <QAbstractProxyModel>
 #include <QGraphicsEffect>
 #include <QGraphicsItem>
 #include <QGraphicsLayout>
@@ -245,14 +246,13 @@ void SceneInspector::nonQObjectSelected(void *obj, const QString &typeName)
 
 void SceneInspector::sceneItemSelected(QGraphicsItem *item)
 {
-    const auto indexList = m_itemSelectionModel->model()->match(
-        m_itemSelectionModel->model()->index(0, 0),
-        SceneModel::SceneItemRole,
-        QVariant::fromValue<QGraphicsItem *>(item), 1,
-        Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    // the scene model knows where the item is, no need to search the whole tree for it
+    const auto proxy = qobject_cast<const QAbstractProxyModel *>(m_itemSelectionModel->model());
+    if (!proxy)
+        return;
+    const QModelIndex index = proxy->mapFromSource(m_sceneModel->indexForItem(item));
+    if (!index.isValid())
         return;
-    const QModelIndex index = indexList.first();
     m_itemSelectionModel->setCurrentIndex(index,
                                           QItemSelectionModel::ClearAndSelect
                                           | QItemSelectionModel::Rows);
@@ -31,10 +31,18 @@
 #include <common/objectmodel.h>
 #include <common/objectid.h>
 
+#include <core/probe.h>
+
+#include <compat/qasconst.h>
+
 #include <QApplication>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QPalette>
+#include <QSet>
+#include <QTimer>
+
+#include <algorithm>
 
 using namespace GammaRay;
 
@@ -47,7 +55,23 @@ using namespace GammaRay;
 SceneModel::SceneModel(QObject *parent)
     : QAbstractItemModel(parent)
     , m_scene(nullptr)
+    , m_updateTimer(new QTimer(this))
 {
+    // QGraphicsScene has no notifications for added or removed items, so the scene
+    // is diffed after it reported a change, at most every few hundred milliseconds
+    // to keep animations cheap. Destroyed QGraphicsObjects are dropped right away.
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(250);
+    connect(m_updateTimer, &QTimer::timeout, this, &SceneModel::updateItems);
+    if (Probe::isInitialized()) {
+        // hidden items don't cause a scene change, but QGraphicsObjects are known to the probe
+        connect(Probe::instance(), &Probe::objectCreated, this, [this](QObject *object) {
+            if (m_scene && qobject_cast<QGraphicsObject *>(object))
+                scheduleUpdate();
+        });
+        connect(Probe::instance(), &Probe::objectDestroyed, this, &SceneModel::objectDestroyed);
+    }
+
     QGV_ITEMTYPE(QGraphicsLineItem)
     QGV_ITEMTYPE(QGraphicsPixmapItem)
     QGV_ITEMTYPE(QGraphicsRectItem)
@@ -60,9 +84,19 @@ SceneModel::SceneModel(QObject *parent)
 
 void SceneModel::setScene(QGraphicsScene *scene)
 {
+    if (m_scene)
+        disconnect(m_scene, &QGraphicsScene::changed, this, nullptr);
+
     beginResetModel();
     m_scene = scene;
+    m_topLevelItems.clear();
+    m_items.clear();
+    m_graphicsObjects.clear();
     endResetModel();
+    updateItems();
+
+    if (m_scene)
+        connect(m_scene, &QGraphicsScene::changed, this, &SceneModel::scheduleUpdate);
 }
 
 QGraphicsScene *SceneModel::scene() const
@@ -75,28 +109,31 @@ QVariant SceneModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
     QGraphicsItem *item = static_cast<QGraphicsItem *>(index.internalPointer());
+    const auto it = m_items.constFind(item);
+    if (it == m_items.constEnd())
+        return QVariant();
+    const ItemInfo &info = it.value();
 
-    if (item && role == Qt::DisplayRole) {
-        QGraphicsObject *obj = item->toGraphicsObject();
+    if (role == Qt::DisplayRole) {
         if (index.column() == 0) {
-            if (obj && !obj->objectName().isEmpty())
-                return obj->objectName();
+            if (info.object && !info.object->objectName().isEmpty())
+                return info.object->objectName();
             return
                 QStringLiteral("0x%1").
                 arg(QString::number(reinterpret_cast<qlonglong>(item), 16));
         } else if (index.column() == 1) {
-            if (obj)
-                return obj->metaObject()->className();
-            return typeName(item->type());
+            if (info.object)
+                return info.object->metaObject()->className();
+            return typeName(info.type);
         }
     } else if (role == SceneItemRole) {
         return QVariant::fromValue(item);
-    } else if (item && role == Qt::ForegroundRole) {
-        if (!item->isVisible())
+    } else if (role == Qt::ForegroundRole) {
+        if (!info.visible)
             return qApp->palette().color(QPalette::Disabled, QPalette::Text);
-    } else if (item && role == ObjectModel::ObjectIdRole) {
+    } else if (role == ObjectModel::ObjectIdRole) {
         // TODO also handle the non-QObject case
-        return QVariant::fromValue(ObjectId(item->toGraphicsObject()));
+        return QVariant::fromValue(ObjectId(info.object));
     }
     return QVariant();
 }
@@ -109,55 +146,197 @@ int SceneModel::columnCount(const QModelIndex &parent) const
 
 int SceneModel::rowCount(const QModelIndex &parent) const
 {
-    if (!m_scene)
+    if (parent.column() > 0)
         return 0;
-    if (parent.isValid()) {
-        if (parent.column() != 0)
-            return 0;
-        QGraphicsItem *item = static_cast<QGraphicsItem *>(parent.internalPointer());
-        if (item)
-            return item->childItems().size();
-        else
-            return 0;
-    }
-    return topLevelItems().size();
+    return childItems(parent).size();
 }
 
 QModelIndex SceneModel::parent(const QModelIndex &child) const
 {
     if (!child.isValid())
         return {};
-    QGraphicsItem *item = static_cast<QGraphicsItem *>(child.internalPointer());
-    if (!item->parentItem())
-        return QModelIndex();
-    int row = 0;
-    if (item->parentItem()->parentItem())
-        row = item->parentItem()->parentItem()->childItems().indexOf(item->parentItem());
-    return createIndex(row, 0, item->parentItem());
+    return indexOf(m_items.value(static_cast<QGraphicsItem *>(child.internalPointer())).parent);
 }
 
 QModelIndex SceneModel::index(int row, int column, const QModelIndex &parent) const
 {
-    if (column < 0 || column >= columnCount())
+    if (column < 0 || column >= columnCount() || parent.column() > 0)
+        return {};
+    const auto &children = childItems(parent);
+    if (row < 0 || row >= children.size())
+        return {};
+    return createIndex(row, column, children.at(row));
+}
+
+QModelIndex SceneModel::indexForItem(QGraphicsItem *item)
+{
+    if (!item)
         return {};
-    if (!parent.isValid() && row >= 0 && row < topLevelItems().size())
-        return createIndex(row, column, topLevelItems().at(row));
-    QGraphicsItem *parentItem = static_cast<QGraphicsItem *>(parent.internalPointer());
-    if (!parentItem || row < 0 || row >= parentItem->childItems().size())
-        return QModelIndex();
-    return createIndex(row, column, parentItem->childItems().at(row));
+    // the item might have been added since the last update
+    if (!m_items.contains(item))
+        updateItems();
+    return indexOf(item);
 }
 
-QList<QGraphicsItem *> SceneModel::topLevelItems() const
+QModelIndex SceneModel::indexOf(QGraphicsItem *item) const
 {
-    QList<QGraphicsItem *> topLevel;
+    const auto it = m_items.constFind(item);
+    if (it == m_items.constEnd())
+        return {};
+    return createIndex(it.value().row, 0, item);
+}
+
+const QVector<QGraphicsItem *> &SceneModel::childItems(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_topLevelItems;
+    static const QVector<QGraphicsItem *> noChildren;
+    const auto it = m_items.constFind(static_cast<QGraphicsItem *>(parent.internalPointer()));
+    return it == m_items.constEnd() ? noChildren : it.value().children;
+}
+
+QVector<QGraphicsItem *> &SceneModel::childItems(QGraphicsItem *parent)
+{
+    if (!parent)
+        return m_topLevelItems;
+    Q_ASSERT(m_items.contains(parent));
+    return m_items[parent].children;
+}
+
+void SceneModel::scheduleUpdate()
+{
+    if (!m_updateTimer->isActive())
+        m_updateTimer->start();
+}
+
+void SceneModel::objectDestroyed(QObject *object)
+{
+    // the item is already removed from the scene at this point, but its address
+    // could be reused before the next diff
+    QGraphicsItem *item = m_graphicsObjects.value(object);
+    if (!item)
+        return;
+    removeRows(m_items.value(item).parent, QVector<int>() << m_items.value(item).row);
+}
+
+void SceneModel::removeRows(QGraphicsItem *parent, QVector<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    // remove consecutive rows at once, from the back so the rows stay valid
+    for (int last = rows.size() - 1; last >= 0;) {
+        int first = last;
+        while (first > 0 && rows.at(first - 1) == rows.at(first) - 1)
+            --first;
+        const int firstRow = rows.at(first);
+        const int count = last - first + 1;
+        beginRemoveRows(indexOf(parent), firstRow, firstRow + count - 1);
+        auto &children = childItems(parent);
+        for (int row = firstRow; row < firstRow + count; ++row)
+            forgetItem(children.at(row));
+        children.remove(firstRow, count);
+        for (int row = firstRow; row < children.size(); ++row)
+            m_items[children.at(row)].row = row;
+        endRemoveRows();
+        last = first - 1;
+    }
+}
+
+void SceneModel::forgetItem(QGraphicsItem *item)
+{
+    const ItemInfo info = m_items.take(item);
+    if (info.object)
+        m_graphicsObjects.remove(info.object);
+    for (QGraphicsItem *child : info.children)
+        forgetItem(child);
+}
+
+void SceneModel::insertRows(QGraphicsItem *parent, const QVector<QGraphicsItem *> &items,
+                            const ChildMap &newChildren)
+{
+    const int firstRow = childItems(parent).size();
+    beginInsertRows(indexOf(parent), firstRow, firstRow + items.size() - 1);
+    for (int i = 0; i < items.size(); ++i)
+        addItem(items.at(i), parent, firstRow + i, newChildren);
+    childItems(parent) += items;
+    endInsertRows();
+}
+
+void SceneModel::addItem(QGraphicsItem *item, QGraphicsItem *parent, int row,
+                         const ChildMap &newChildren)
+{
+    ItemInfo info;
+    info.parent = parent;
+    info.row = row;
+    info.type = item->type();
+    info.visible = item->isVisible();
+    info.object = item->toGraphicsObject();
+    info.children = newChildren.value(item);
+    if (info.object)
+        m_graphicsObjects.insert(info.object, item);
+    m_items.insert(item, info);
+    // all descendants of a new item are new as well
+    for (int i = 0; i < info.children.size(); ++i)
+        addItem(info.children.at(i), item, i, newChildren);
+}
+
+void SceneModel::updateItems()
+{
+    m_updateTimer->stop();
     if (!m_scene)
-        return topLevel;
-    Q_FOREACH(QGraphicsItem *item, m_scene->items()) {
-        if (!item->parentItem())
-            topLevel.push_back(item);
+        return;
+
+    const QList<QGraphicsItem *> items = m_scene->items();
+    QSet<QGraphicsItem *> sceneItems;
+    sceneItems.reserve(items.size());
+    for (QGraphicsItem *item : items)
+        sceneItems.insert(item);
+
+    // Items that left the scene might be deleted already, so only dereference those
+    // still in it. A different parent or type means the item moved, or its address
+    // was reused for a new one, either way it's removed and added again.
+    QSet<QGraphicsItem *> goneItems;
+    for (auto it = m_items.constBegin(); it != m_items.constEnd(); ++it) {
+        QGraphicsItem *item = it.key();
+        if (!sceneItems.contains(item) || item->parentItem() != it.value().parent
+            || item->type() != it.value().type)
+            goneItems.insert(item);
+    }
+
+    // removing an item removes its subtree, so only remove the topmost gone items
+    QHash<QGraphicsItem *, QVector<int>> removedRows;
+    for (QGraphicsItem *item : qAsConst(goneItems)) {
+        const ItemInfo &info = m_items[item];
+        bool ancestorGone = false;
+        for (QGraphicsItem *ancestor = info.parent; ancestor && !ancestorGone;
+             ancestor = m_items.value(ancestor).parent)
+            ancestorGone = goneItems.contains(ancestor);
+        if (!ancestorGone)
+            removedRows[info.parent].push_back(info.row);
+    }
+    for (auto it = removedRows.constBegin(); it != removedRows.constEnd(); ++it)
+        removeRows(it.key(), it.value());
+
+    // collect new items by parent, those below a new parent are added with it
+    ChildMap newChildren;
+    QVector<QGraphicsItem *> newRoots;
+    for (QGraphicsItem *item : items) {
+        const auto it = m_items.find(item);
+        if (it != m_items.end()) {
+            if (it.value().visible != item->isVisible()) {
+                it.value().visible = item->isVisible();
+                const QModelIndex index = indexOf(item);
+                emit dataChanged(index, index.sibling(index.row(), 1));
+            }
+            continue;
+        }
+        QGraphicsItem *parent = item->parentItem();
+        auto &children = newChildren[parent];
+        if (children.isEmpty() && (!parent || m_items.contains(parent)))
+            newRoots.push_back(parent);
+        children.push_back(item);
     }
-    return topLevel;
+    for (QGraphicsItem *parent : qAsConst(newRoots))
+        insertRows(parent, newChildren.value(parent), newChildren);
 }
 
 QVariant SceneModel::headerData(int section, Qt::Orientation orientation, int role) const
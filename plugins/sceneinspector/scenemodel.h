@@ -30,11 +30,14 @@
 #define GAMMARAY_SCENEINSPECTOR_SCENEMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
 #include <common/modelroles.h>
 
 QT_BEGIN_NAMESPACE
 class QGraphicsScene;
 class QGraphicsItem;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
@@ -57,13 +60,47 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const override;
 
+    /// Returns the index for @p item, without searching the entire model
+    QModelIndex indexForItem(QGraphicsItem *item);
+
+private slots:
+    void updateItems();
+
 private:
-    QList<QGraphicsItem *> topLevelItems() const;
+    // what we last saw of an item in the scene, so the model never has to
+    // dereference items that might have been deleted since
+    struct ItemInfo {
+        QGraphicsItem *parent = nullptr;
+        int row = -1;
+        int type = 0;
+        bool visible = true;
+        QObject *object = nullptr; // removed in objectDestroyed()
+        QVector<QGraphicsItem *> children;
+    };
+
+    typedef QHash<QGraphicsItem *, QVector<QGraphicsItem *>> ChildMap;
+
+    void scheduleUpdate();
+    void objectDestroyed(QObject *object);
+    QModelIndex indexOf(QGraphicsItem *item) const;
+    const QVector<QGraphicsItem *> &childItems(const QModelIndex &parent) const;
+    QVector<QGraphicsItem *> &childItems(QGraphicsItem *parent);
+    void removeRows(QGraphicsItem *parent, QVector<int> rows);
+    void forgetItem(QGraphicsItem *item);
+    void insertRows(QGraphicsItem *parent, const QVector<QGraphicsItem *> &items, const ChildMap &newChildren);
+    void addItem(QGraphicsItem *item, QGraphicsItem *parent, int row, const ChildMap &newChildren);
     /// Returns a string type name for the given QGV item type id
     QString typeName(int itemType) const;
 
     QGraphicsScene *m_scene;
     QHash<int, QString> m_typeNames;
+    // QGraphicsScene::items() is expensive and there are no notifications for
+    // single items, so this snapshot is compared against the scene after it
+    // reported a change
+    QVector<QGraphicsItem *> m_topLevelItems;
+    QHash<QGraphicsItem *, ItemInfo> m_items;
+    QHash<QObject *, QGraphicsItem *> m_graphicsObjects;
+    QTimer *m_updateTimer;
 };
 }
 
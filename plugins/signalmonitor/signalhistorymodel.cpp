@@ -115,6 +115,14 @@ SignalHistoryModel::Item *SignalHistoryModel::item(const QModelIndex &index) con
     return m_tracedObjects.at(index.row());
 }
 
+QModelIndex SignalHistoryModel::indexForObject(QObject *object) const
+{
+    const auto it = m_itemIndex.constFind(object);
+    if (it == m_itemIndex.constEnd())
+        return QModelIndex();
+    return index(it.value(), 0);
+}
+
 QVariant SignalHistoryModel::data(const QModelIndex &index, int role) const
 {
     switch (static_cast<ColumnId>(index.column())) {
@@ -86,6 +86,8 @@ public:
                         int role = Qt::DisplayRole) const override;
     QMap<int, QVariant> itemData(const QModelIndex &index) const override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
     static qint64 timestamp(qint64 ev) { return ev >> 16; }
     static int signalIndex(qint64 ev) { return ev & 0xffff; }
 
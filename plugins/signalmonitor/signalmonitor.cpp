@@ -33,6 +33,7 @@
 
 #include <core/remote/serverproxymodel.h>
 
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/objectid.h>
 
@@ -79,11 +80,9 @@ void SignalMonitor::sendClockUpdates(bool enabled)
 
 void SignalMonitor::objectSelected(QObject* obj)
 {
-    const auto indexList = m_objModel->match(m_objModel->index(0, 0), ObjectModel::ObjectIdRole,
-        QVariant::fromValue<ObjectId>(ObjectId(obj)), 1, Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const auto index = ModelUtils::indexForObject(m_objModel, obj);
+    if (!index.isValid())
         return;
 
-    const auto index = indexList.first();
     m_objSelectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
 }
@@ -0,0 +1,68 @@
+/*
+  statemachineprofileclientproxymodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "statemachineprofileclientproxymodel.h"
+
+#include "statemachineprofilemodel.h"
+
+#include <ui/uiintegration.h>
+
+#include <QColor>
+
+using namespace GammaRay;
+
+StateMachineProfileClientProxyModel::StateMachineProfileClientProxyModel(QObject *parent)
+    : QIdentityProxyModel(parent)
+{
+}
+
+StateMachineProfileClientProxyModel::~StateMachineProfileClientProxyModel() = default;
+
+QColor StateMachineProfileClientProxyModel::colorForRatio(double ratio)
+{
+    // green for cold, yellow at half of the maximum, red for the hottest element
+    const auto red = qBound<qreal>(0.0, ratio, 0.5);
+    const auto green = qBound<qreal>(0.0, 1 - ratio, 0.5);
+    auto color = QColor(int(255 * red), int(255 * green), 0);
+    if (!UiIntegration::hasDarkUI())
+        return color.lighter(300);
+    return color;
+}
+
+QVariant StateMachineProfileClientProxyModel::data(const QModelIndex &index, int role) const
+{
+    if (!sourceModel() || !index.isValid())
+        return QVariant();
+
+    if (role != Qt::BackgroundRole || index.column() < StateMachineProfileModel::CountColumn)
+        return QIdentityProxyModel::data(index, role);
+
+    const auto heat = QIdentityProxyModel::data(index, StateMachineProfileModel::HeatRole);
+    if (!heat.isValid() || heat.toDouble() <= 0.0)
+        return QVariant();
+    return colorForRatio(heat.toDouble());
+}
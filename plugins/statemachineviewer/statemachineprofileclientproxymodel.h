@@ -0,0 +1,53 @@
+/*
+  statemachineprofileclientproxymodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILECLIENTPROXYMODEL_H
+#define GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILECLIENTPROXYMODEL_H
+
+#include <QIdentityProxyModel>
+
+QT_BEGIN_NAMESPACE
+class QColor;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Colors the profile rows based on their share of the most expensive element. */
+class StateMachineProfileClientProxyModel : public QIdentityProxyModel
+{
+    Q_OBJECT
+public:
+    explicit StateMachineProfileClientProxyModel(QObject *parent = nullptr);
+    ~StateMachineProfileClientProxyModel() override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    /** Heat color for @p ratio, a value between 0 (cold) and 1 (hottest). */
+    static QColor colorForRatio(double ratio);
+};
+}
+
+#endif // GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILECLIENTPROXYMODEL_H
@@ -0,0 +1,253 @@
+/*
+  statemachineprofilemodel.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "statemachineprofilemodel.h"
+
+#include <compat/qasconst.h>
+
+#include <QTimer>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+// the percentiles are computed over this many of the most recent samples per element
+static const int MaxSamples = 1024;
+
+StateMachineProfileModel::StateMachineProfileModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_pendingUpdateTimer(new QTimer(this))
+{
+    m_pendingUpdateTimer->setSingleShot(true);
+    m_pendingUpdateTimer->setInterval(500);
+    connect(m_pendingUpdateTimer, &QTimer::timeout, this, &StateMachineProfileModel::emitPendingUpdates);
+}
+
+StateMachineProfileModel::~StateMachineProfileModel() = default;
+
+int StateMachineProfileModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_entries.size();
+}
+
+int StateMachineProfileModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COUNT;
+}
+
+QVariant StateMachineProfileModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const auto &entry = m_entries.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ElementColumn:
+            return entry.label;
+        case KindColumn:
+            return entry.isTransition ? tr("Transition") : tr("State");
+        case CountColumn:
+            return entry.count;
+        case TotalColumn:
+            return entry.total / 1000;
+        case MeanColumn:
+            return entry.count ? entry.total / entry.count / 1000 : 0;
+        case MedianColumn:
+            return percentile(entry, 50) / 1000;
+        case P95Column:
+            return percentile(entry, 95) / 1000;
+        case P99Column:
+            return percentile(entry, 99) / 1000;
+        case MaxColumn:
+            return entry.max / 1000;
+        }
+    } else if (role == ElementIdRole) {
+        return entry.id;
+    } else if (role == IsTransitionRole) {
+        return entry.isTransition;
+    } else if (role == HeatRole) {
+        const qint64 maxTotal = entry.isTransition ? m_maxTransitionTotal : m_maxStateTotal;
+        if (maxTotal <= 0)
+            return 0.0;
+        return double(entry.total) / double(maxTotal);
+    }
+
+    return QVariant();
+}
+
+QVariant StateMachineProfileModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
+        switch (section) {
+        case ElementColumn:
+            return tr("Element");
+        case KindColumn:
+            return tr("Kind");
+        case CountColumn:
+            return tr("Count");
+        case TotalColumn:
+            return tr("Total (µs)");
+        case MeanColumn:
+            return tr("Mean (µs)");
+        case MedianColumn:
+            return tr("Median (µs)");
+        case P95Column:
+            return tr("95% (µs)");
+        case P99Column:
+            return tr("99% (µs)");
+        case MaxColumn:
+            return tr("Max (µs)");
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QMap<int, QVariant> StateMachineProfileModel::itemData(const QModelIndex &index) const
+{
+    auto d = QAbstractTableModel::itemData(index);
+    if (index.column() == ElementColumn) {
+        d.insert(ElementIdRole, index.data(ElementIdRole));
+        d.insert(IsTransitionRole, index.data(IsTransitionRole));
+    }
+    d.insert(HeatRole, index.data(HeatRole));
+    return d;
+}
+
+void StateMachineProfileModel::clear()
+{
+    if (m_entries.isEmpty())
+        return;
+
+    beginResetModel();
+    m_entries.clear();
+    m_stateRows.clear();
+    m_transitionRows.clear();
+    m_pendingUpdates.clear();
+    m_maxStateTotal = 0;
+    m_maxTransitionTotal = 0;
+    m_maxTotalChanged = false;
+    m_pendingUpdateTimer->stop();
+    endResetModel();
+}
+
+void StateMachineProfileModel::setStateMachine(StateMachineDebugInterface *stateMachine)
+{
+    clear();
+    m_stateMachine = stateMachine;
+}
+
+void StateMachineProfileModel::addStateSample(State state, qint64 nsecs)
+{
+    addSample(entryForSample(m_stateRows, state, false), nsecs);
+}
+
+void StateMachineProfileModel::addTransitionSample(Transition transition, qint64 nsecs)
+{
+    addSample(entryForSample(m_transitionRows, transition, true), nsecs);
+}
+
+StateMachineProfileModel::Entry &StateMachineProfileModel::entryForSample(QHash<quint64, int> &rows,
+                                                                          quint64 id, bool isTransition)
+{
+    const auto it = rows.constFind(id);
+    if (it != rows.constEnd()) {
+        m_pendingUpdates.insert(it.value());
+        return m_entries[it.value()];
+    }
+
+    Q_ASSERT(m_stateMachine);
+    const int row = m_entries.size();
+    beginInsertRows(QModelIndex(), row, row);
+    Entry entry;
+    entry.id = id;
+    entry.isTransition = isTransition;
+    entry.label = isTransition ? m_stateMachine->transitionLabel(Transition(id))
+                               : m_stateMachine->stateLabel(State(id));
+    m_entries.push_back(entry);
+    rows.insert(id, row);
+    endInsertRows();
+    return m_entries[row];
+}
+
+void StateMachineProfileModel::addSample(Entry &entry, qint64 nsecs)
+{
+    ++entry.count;
+    entry.total += nsecs;
+    entry.max = std::max(entry.max, nsecs);
+    if (entry.samples.size() < MaxSamples) {
+        entry.samples.push_back(nsecs);
+    } else {
+        entry.samples[entry.nextSample] = nsecs;
+        entry.nextSample = (entry.nextSample + 1) % MaxSamples;
+    }
+    entry.sortedSamples.clear();
+
+    qint64 &maxTotal = entry.isTransition ? m_maxTransitionTotal : m_maxStateTotal;
+    if (entry.total > maxTotal) {
+        maxTotal = entry.total;
+        m_maxTotalChanged = true;
+    }
+
+    if (!m_pendingUpdateTimer->isActive())
+        m_pendingUpdateTimer->start();
+}
+
+qint64 StateMachineProfileModel::percentile(const Entry &entry, int percent) const
+{
+    if (entry.samples.isEmpty())
+        return 0;
+
+    if (entry.sortedSamples.isEmpty()) {
+        entry.sortedSamples = entry.samples;
+        std::sort(entry.sortedSamples.begin(), entry.sortedSamples.end());
+    }
+
+    // nearest-rank method
+    const int n = entry.sortedSamples.size();
+    const int rank = (percent * n + 99) / 100;
+    return entry.sortedSamples.at(qBound(0, rank - 1, n - 1));
+}
+
+void StateMachineProfileModel::emitPendingUpdates()
+{
+    if (m_entries.isEmpty())
+        return;
+
+    // the heat of every row is relative to a maximum, so all rows change with it
+    if (m_maxTotalChanged) {
+        emit dataChanged(index(0, 0), index(m_entries.size() - 1, COUNT - 1));
+    } else {
+        for (int row : qAsConst(m_pendingUpdates))
+            emit dataChanged(index(row, 0), index(row, COUNT - 1));
+    }
+    m_pendingUpdates.clear();
+    m_maxTotalChanged = false;
+}
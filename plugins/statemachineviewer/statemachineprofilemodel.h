@@ -0,0 +1,120 @@
+/*
+  statemachineprofilemodel.h
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILEMODEL_H
+#define GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILEMODEL_H
+
+#include "statemachinedebuginterface.h"
+
+#include <common/modelroles.h>
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace GammaRay {
+/** Aggregated timing of the states and transitions of the selected state machine.
+ *  States are measured by their dwell time (entered to exited), transitions by the
+ *  duration of their micro step (first exit to last entry, including the actions run
+ *  in between).
+ */
+class StateMachineProfileModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {
+        ElementColumn,
+        KindColumn,
+        CountColumn,
+        TotalColumn,
+        MeanColumn,
+        MedianColumn,
+        P95Column,
+        P99Column,
+        MaxColumn,
+        COUNT
+    };
+
+    enum Role {
+        ElementIdRole = GammaRay::UserRole + 1, ///< quint64, StateId or TransitionId
+        IsTransitionRole, ///< bool
+        HeatRole ///< double, total time relative to the most expensive element of the same kind
+    };
+
+    explicit StateMachineProfileModel(QObject *parent = nullptr);
+    ~StateMachineProfileModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const override;
+
+    void setStateMachine(StateMachineDebugInterface *stateMachine);
+    void clear();
+
+    void addStateSample(State state, qint64 nsecs);
+    void addTransitionSample(Transition transition, qint64 nsecs);
+
+private:
+    struct Entry {
+        quint64 id = 0;
+        bool isTransition = false;
+        QString label;
+        int count = 0;
+        qint64 total = 0;
+        qint64 max = 0;
+        QVector<qint64> samples; // ring buffer of the most recent samples
+        int nextSample = 0;
+        mutable QVector<qint64> sortedSamples; // lazily sorted copy for the percentiles
+    };
+
+    Entry &entryForSample(QHash<quint64, int> &rows, quint64 id, bool isTransition);
+    void addSample(Entry &entry, qint64 nsecs);
+    qint64 percentile(const Entry &entry, int percent) const;
+    void emitPendingUpdates();
+
+    StateMachineDebugInterface *m_stateMachine = nullptr;
+    QVector<Entry> m_entries;
+    QHash<quint64, int> m_stateRows;
+    QHash<quint64, int> m_transitionRows;
+    QSet<int> m_pendingUpdates;
+    // state time and transition time are not comparable, so heat is relative per kind
+    qint64 m_maxStateTotal = 0;
+    qint64 m_maxTransitionTotal = 0;
+    bool m_maxTotalChanged = false;
+    QTimer *m_pendingUpdateTimer;
+};
+}
+
+#endif // GAMMARAY_STATEMACHINEVIEWER_STATEMACHINEPROFILEMODEL_H
@@ -48,3 +48,8 @@ void StateMachineViewerClient::repopulateGraph()
 {
     Endpoint::instance()->invokeObject(objectName(), "repopulateGraph");
 }
+
+void StateMachineViewerClient::resetProfile()
+{
+    Endpoint::instance()->invokeObject(objectName(), "resetProfile");
+}
@@ -40,6 +40,7 @@ public:
     void selectStateMachine(int index) override;
     void toggleRunning() override;
     void repopulateGraph() override;
+    void resetProfile() override;
 };
 }
 
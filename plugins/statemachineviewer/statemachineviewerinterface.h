@@ -121,6 +121,9 @@ public slots:
 
     virtual void repopulateGraph() = 0;
 
+    /** Discards the timing statistics collected for the selected state machine. */
+    virtual void resetProfile() = 0;
+
 signals:
     void statusChanged(bool haveStateMachine, bool running);
     void message(const QString &message);
@@ -33,6 +33,7 @@
 #endif
 #include "statemodel.h"
 #include "statemachinedebuginterface.h"
+#include "statemachineprofilemodel.h"
 #include "statemachinewatcher.h"
 #include "transitionmodel.h"
 
@@ -44,6 +45,8 @@
 
 #include <QStateMachine>
 #include <QItemSelectionModel>
+#include <QSortFilterProxyModel>
+#include <QTimer>
 
 #ifdef HAVE_QT_SCXML
 #include <QScxmlStateMachine>
@@ -60,6 +63,11 @@ StateMachineViewerServer::StateMachineViewerServer(Probe *probe, QObject *parent
     : StateMachineViewerInterface(parent)
     , m_stateModel(new StateModel(this))
     , m_transitionModel(new TransitionModel(this))
+    , m_profileModel(new StateMachineProfileModel(this))
+    , m_microStepBegin(-1)
+    , m_microStepEnd(-1)
+    , m_microStepEntered(false)
+    , m_microStepTimer(new QTimer(this))
 {
     auto proxyModel = new ServerProxyModel<QIdentityProxyModel>(this);
     proxyModel->setSourceModel(m_stateModel);
@@ -81,6 +89,16 @@ StateMachineViewerServer::StateMachineViewerServer(Probe *probe, QObject *parent
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.StateMachineModel"),
                          m_stateMachinesModel);
 
+    auto profileProxy = new ServerProxyModel<QSortFilterProxyModel>(this);
+    profileProxy->setSourceModel(m_profileModel);
+    probe->registerModel(QStringLiteral("com.kdab.GammaRay.StateMachineProfileModel"), profileProxy);
+
+    // a micro step is complete once control returns to the event loop
+    m_microStepTimer->setSingleShot(true);
+    m_microStepTimer->setInterval(0);
+    connect(m_microStepTimer, &QTimer::timeout, this, &StateMachineViewerServer::finishMicroStep);
+    m_profileClock.start();
+
     updateStartStop();
 }
 
@@ -156,6 +174,9 @@ void StateMachineViewerServer::setSelectedStateMachine(StateMachineDebugInterfac
     }
 
     m_stateModel->setStateMachine(machine);
+    resetProfile();
+    m_stateEnteredAt.clear();
+    m_profileModel->setStateMachine(machine);
 
     setFilteredStates(QVector<State>());
 
@@ -228,21 +249,76 @@ void StateMachineViewerServer::stateSelectionChanged()
 
 void StateMachineViewerServer::handleTransitionTriggered(Transition transition)
 {
+    const auto now = m_profileClock.nsecsElapsed();
+    beginMicroStep(now);
+    m_pendingTransitions.push_back(transition);
+    m_microStepEnd = now;
+
     emit transitionTriggered(TransitionId(transition), selectedStateMachine()->transitionLabel(transition));
 }
 
 void StateMachineViewerServer::stateEntered(State state)
 {
+    const auto now = m_profileClock.nsecsElapsed();
+    m_stateEnteredAt.insert(state, now);
+    if (!m_pendingTransitions.isEmpty()) {
+        m_microStepEnd = now;
+        m_microStepEntered = true;
+    }
+
     emit message(tr("State entered: %1").arg(selectedStateMachine()->stateLabel(state)));
     stateConfigurationChanged();
 }
 
 void StateMachineViewerServer::stateExited(State state)
 {
+    const auto now = m_profileClock.nsecsElapsed();
+    beginMicroStep(now);
+    const auto it = m_stateEnteredAt.find(state);
+    if (it != m_stateEnteredAt.end()) {
+        m_profileModel->addStateSample(state, now - it.value());
+        m_stateEnteredAt.erase(it);
+    }
+
     emit message(tr("State exited: %1").arg(selectedStateMachine()->stateLabel(state)));
     stateConfigurationChanged();
 }
 
+void StateMachineViewerServer::beginMicroStep(qint64 now)
+{
+    // exits or triggers after entries belong to the next micro step of the same macro step
+    if (m_microStepEntered)
+        finishMicroStep();
+
+    if (m_microStepBegin < 0) {
+        m_microStepBegin = now;
+        m_microStepTimer->start();
+    }
+}
+
+void StateMachineViewerServer::finishMicroStep()
+{
+    m_microStepTimer->stop();
+    if (selectedStateMachine()) {
+        for (Transition transition : qAsConst(m_pendingTransitions))
+            m_profileModel->addTransitionSample(transition, m_microStepEnd - m_microStepBegin);
+    }
+    m_pendingTransitions.clear();
+    m_microStepBegin = -1;
+    m_microStepEnd = -1;
+    m_microStepEntered = false;
+}
+
+void StateMachineViewerServer::resetProfile()
+{
+    m_microStepTimer->stop();
+    m_pendingTransitions.clear();
+    m_microStepBegin = -1;
+    m_microStepEnd = -1;
+    m_microStepEntered = false;
+    m_profileModel->clear();
+}
+
 void StateMachineViewerServer::stateConfigurationChanged()
 {
     QVector<State> newConfig;
@@ -335,13 +411,12 @@ void StateMachineViewerServer::handleLogMessage(const QString &label, const QStr
 void StateMachineViewerServer::objectSelected(QObject *obj)
 {
     if (auto state = qobject_cast<QAbstractState*>(obj)) {
-        auto model = m_stateSelectionModel->model();
-        const auto idxs = model->match(model->index(0, 0), StateModel::StateValueRole,
-                                       QVariant::fromValue(GammaRay::State(quintptr(state))), 1, Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-        qDebug() << idxs;
-        if (idxs.isEmpty())
+        const auto model = qobject_cast<const QAbstractProxyModel *>(m_stateSelectionModel->model());
+        if (!model)
+            return;
+        const auto idx = model->mapFromSource(m_stateModel->indexForState(GammaRay::State(quintptr(state))));
+        if (!idx.isValid())
             return;
-        const auto idx = idxs.first();
         m_stateSelectionModel->select(idx, QItemSelectionModel::ClearAndSelect |
             QItemSelectionModel::Rows | QItemSelectionModel::Current);
     }
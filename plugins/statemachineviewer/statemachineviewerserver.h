@@ -34,6 +34,7 @@
 
 #include <core/toolfactory.h>
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QSet>
 #include <QString>
@@ -47,10 +48,12 @@ class QAbstractItemModel;
 class QAbstractProxyModel;
 class QItemSelectionModel;
 class QModelIndex;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
 class StateModel;
+class StateMachineProfileModel;
 class TransitionModel;
 class StateMachineDebugInterface;
 
@@ -85,24 +88,38 @@ private slots:
     void toggleRunning() override;
 
     void repopulateGraph() override;
+    void resetProfile() override;
 
     void handleLogMessage(const QString &label, const QString &msg);
 
     void objectSelected(QObject *obj);
 
+    void finishMicroStep();
+
 private:
     bool mayAddState(State state);
+    void beginMicroStep(qint64 now);
 
     QAbstractProxyModel *m_stateMachinesModel;
     StateModel *m_stateModel;
     QItemSelectionModel *m_stateSelectionModel;
     TransitionModel *m_transitionModel;
+    StateMachineProfileModel *m_profileModel;
 
     // filters
     QVector<State> m_filteredStates;
 
     QVector<State> m_recursionGuard;
     QVector<State> m_lastStateConfig;
+
+    // profiling, all times are nanoseconds of m_profileClock
+    QElapsedTimer m_profileClock;
+    QHash<quintptr, qint64> m_stateEnteredAt;
+    QVector<Transition> m_pendingTransitions;
+    qint64 m_microStepBegin;
+    qint64 m_microStepEnd;
+    bool m_microStepEntered;
+    QTimer *m_microStepTimer;
 };
 
 class StateMachineViewerFactory : public QObject,
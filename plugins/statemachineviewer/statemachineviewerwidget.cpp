@@ -28,6 +28,8 @@
 #include "ui_statemachineviewerwidget.h"
 
 #include "statemachineviewerclient.h"
+#include "statemachineprofileclientproxymodel.h"
+#include "statemachineprofilemodel.h"
 #include "statemodeldelegate.h"
 #include "statemodel.h"
 #include "statemachinedebuginterface.h"
@@ -177,15 +179,29 @@ StateMachineViewerWidget::StateMachineViewerWidget(QWidget *parent, Qt::WindowFl
     m_ui->singleStateMachineView->setExpandNewContent(true);
     m_ui->singleStateMachineView->setDeferredResizeMode(0, QHeaderView::Stretch);
     m_ui->singleStateMachineView->setDeferredResizeMode(1, QHeaderView::ResizeToContents);
-    m_ui->singleStateMachineView->setItemDelegate(new StateModelDelegate(this));
+    m_stateModelDelegate = new StateModelDelegate(this);
+    m_ui->singleStateMachineView->setItemDelegate(m_stateModelDelegate);
     m_ui->singleStateMachineView->setModel(stateProxyModel);
     m_ui->singleStateMachineView->setSelectionModel(ObjectBroker::selectionModel(stateProxyModel));
     connect(m_ui->singleStateMachineView, &QWidget::customContextMenuRequested, this,
             &StateMachineViewerWidget::objectInspectorContextMenu);
 
+    auto profileProxyModel = new StateMachineProfileClientProxyModel(this);
+    profileProxyModel->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.StateMachineProfileModel")));
+    m_ui->profileView->header()->setObjectName("profileViewHeader");
+    m_ui->profileView->setDeferredResizeMode(StateMachineProfileModel::ElementColumn, QHeaderView::Stretch);
+    m_ui->profileView->setModel(profileProxyModel);
+    m_ui->profileView->sortByColumn(StateMachineProfileModel::TotalColumn, Qt::DescendingOrder);
+    connect(profileProxyModel, &QAbstractItemModel::dataChanged, this, &StateMachineViewerWidget::updateStateHeat);
+    connect(profileProxyModel, &QAbstractItemModel::rowsInserted, this, &StateMachineViewerWidget::updateStateHeat);
+    connect(profileProxyModel, &QAbstractItemModel::modelReset, this, &StateMachineViewerWidget::updateStateHeat);
+
     connect(m_ui->actionStartStopStateMachine, SIGNAL(triggered()), m_interface,
             SLOT(toggleRunning()));
     addAction(m_ui->actionStartStopStateMachine);
+    connect(m_ui->actionResetProfile, SIGNAL(triggered()), m_interface,
+            SLOT(resetProfile()));
+    addAction(m_ui->actionResetProfile);
 
     auto separatorAction = new QAction(this);
     separatorAction->setSeparator(true);
@@ -235,7 +251,7 @@ StateMachineViewerWidget::StateMachineViewerWidget(QWidget *parent, Qt::WindowFl
     // share selection model
     new SelectionModelSyncer(this);
 
-    m_stateManager.setDefaultSizes(m_ui->verticalSplitter, UISizeVector() << "50%" << "50%");
+    m_stateManager.setDefaultSizes(m_ui->verticalSplitter, UISizeVector() << "50%" << "25%" << "25%");
     m_stateManager.setDefaultSizes(m_ui->horizontalSplitter, UISizeVector() << "30%" << "70%");
 
     loadSettings();
@@ -456,6 +472,23 @@ void StateMachineViewerWidget::objectInspectorContextMenu(QPoint pos)
     showContextMenuForObject(index, globalPos);
 }
 
+void StateMachineViewerWidget::updateStateHeat()
+{
+    QHash<StateId, double> heat;
+    const auto model = m_ui->profileView->model();
+    for (int row = 0; row < model->rowCount(); ++row) {
+        const auto index = model->index(row, StateMachineProfileModel::ElementColumn);
+        if (index.data(StateMachineProfileModel::IsTransitionRole).toBool())
+            continue;
+        const auto id = index.data(StateMachineProfileModel::ElementIdRole);
+        if (!id.isValid())
+            continue;
+        heat.insert(StateId(id.value<quint64>()), index.data(StateMachineProfileModel::HeatRole).toDouble());
+    }
+    m_stateModelDelegate->setStateHeat(heat);
+    m_ui->singleStateMachineView->viewport()->update();
+}
+
 void StateMachineViewerWidget::setShowLog(bool show)
 {
     m_showLog = show;
@@ -42,6 +42,7 @@ class Transition;
 
 namespace GammaRay {
 class DeferredTreeView;
+class StateModelDelegate;
 
 namespace Ui {
 class StateMachineViewerWidget;
@@ -81,6 +82,8 @@ private slots:
 
     void objectInspectorContextMenu(QPoint pos);
 
+    void updateStateHeat();
+
 private:
     /**
      * Show context menu for index @p index (a object inspector model index)
@@ -96,6 +99,7 @@ private:
 
     KDSME::StateMachineView *m_stateMachineView;
     StateMachineViewerInterface *m_interface;
+    StateModelDelegate *m_stateModelDelegate;
 
     QHash<StateId, KDSME::State *> m_idToStateMap;
     QHash<TransitionId, KDSME::Transition *> m_idToTransitionMap;
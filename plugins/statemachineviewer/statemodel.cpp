@@ -258,6 +258,12 @@ QModelIndex StateModel::index(int row, int column, const QModelIndex &parent) co
     return createIndex(row, column, internalPointer);
 }
 
+QModelIndex StateModel::indexForState(State state) const
+{
+    Q_D(const StateModel);
+    return d->indexForState(state);
+}
+
 QModelIndex StateModel::parent(const QModelIndex &index) const
 {
     Q_D(const StateModel);
@@ -40,6 +40,7 @@ QT_END_NAMESPACE
 namespace GammaRay {
 class StateModelPrivate;
 class StateMachineDebugInterface;
+struct State;
 
 class StateModel : public QAbstractItemModel
 {
@@ -70,6 +71,8 @@ public:
     QMap<int, QVariant> itemData(const QModelIndex &index) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    QModelIndex indexForState(State state) const;
+
 protected:
     Q_DECLARE_PRIVATE(StateModel)
     StateModelPrivate * const d_ptr;
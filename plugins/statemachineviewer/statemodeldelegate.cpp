@@ -27,6 +27,10 @@
 */
 
 #include "statemodeldelegate.h"
+#include "statemodel.h"
+#include "statemachineprofileclientproxymodel.h"
+
+#include <QColor>
 
 using namespace GammaRay;
 
@@ -35,6 +39,11 @@ StateModelDelegate::StateModelDelegate(QObject *parent)
 {
 }
 
+void StateModelDelegate::setStateHeat(const QHash<StateId, double> &heat)
+{
+    m_stateHeat = heat;
+}
+
 void StateModelDelegate::initStyleOption(QStyleOptionViewItem *option,
                                          const QModelIndex &index) const
 {
@@ -45,4 +54,11 @@ void StateModelDelegate::initStyleOption(QStyleOptionViewItem *option,
     const auto active
         = index.sibling(index.row(), 0).data(Qt::CheckStateRole).toInt() == Qt::Checked;
     option->font.setBold(active);
+
+    if (m_stateHeat.isEmpty())
+        return;
+    const auto stateId = index.sibling(index.row(), 0).data(StateModel::StateIdRole).value<StateId>();
+    const auto it = m_stateHeat.constFind(stateId);
+    if (it != m_stateHeat.constEnd() && it.value() > 0.0)
+        option->backgroundBrush = StateMachineProfileClientProxyModel::colorForRatio(it.value());
 }
@@ -29,6 +29,9 @@
 #ifndef GAMMARAY_STATEMODELDELEGATE_H
 #define GAMMARAY_STATEMODELDELEGATE_H
 
+#include "statemachineviewerinterface.h"
+
+#include <QHash>
 #include <QStyledItemDelegate>
 
 namespace GammaRay {
@@ -38,9 +41,15 @@ class StateModelDelegate : public QStyledItemDelegate
 public:
     explicit StateModelDelegate(QObject *parent = nullptr);
 
+    /** Heat ratio per state, as reported by the state machine profile. */
+    void setStateHeat(const QHash<StateId, double> &heat);
+
 protected:
     void initStyleOption(QStyleOptionViewItem *option,
                          const QModelIndex &index) const override;
+
+private:
+    QHash<StateId, double> m_stateHeat;
 };
 }
 
@@ -35,6 +35,7 @@
 #include <core/metaobjectrepository.h>
 #include <core/objecttypefilterproxymodel.h>
 
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 
 #include <QAbstractTextDocumentLayout>
@@ -76,14 +77,10 @@ TextDocumentInspector::TextDocumentInspector(Probe *probe, QObject *parent)
 void TextDocumentInspector::objectSelected(QObject* obj)
 {
     if (auto doc = qobject_cast<QTextDocument*>(obj)) {
-        const auto indexList = m_documentsModel->match(m_documentsModel->index(0, 0),
-                                  ObjectModel::ObjectRole,
-                                  QVariant::fromValue<QObject*>(doc), 1,
-                                  Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-        if (indexList.isEmpty())
+        const auto index = ModelUtils::indexForObject(m_documentsModel, doc);
+        if (!index.isValid())
             return;
 
-        const auto index = indexList.first();
         m_documentSelectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
     } else if (auto docObj = qobject_cast<QTextObject*>(obj)) {
         objectSelected(docObj->document());
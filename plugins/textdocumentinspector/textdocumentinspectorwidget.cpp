@@ -113,10 +113,11 @@ void TextDocumentInspectorWidget::documentElementSelected(const QItemSelection &
                                                           const QItemSelection &deselected)
 {
     Q_UNUSED(deselected);
-    const QModelIndex selectedRow = selected.first().topLeft();
-
-    const QRectF boundingBox = selectedRow.data(TextDocumentModel::BoundingBoxRole).toRectF();
-    ui->documentView->setShowBoundingBox(boundingBox);
+    // fragments and table cells show the box of their block or table
+    QVariant boundingBox;
+    for (auto index = selected.first().topLeft(); index.isValid() && !boundingBox.isValid(); index = index.parent())
+        boundingBox = index.data(TextDocumentModel::BoundingBoxRole);
+    ui->documentView->setShowBoundingBox(boundingBox.toRectF());
 }
 
 void TextDocumentInspectorWidget::documentContentChanged()
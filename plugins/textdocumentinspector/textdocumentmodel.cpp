@@ -28,12 +28,16 @@
 
 #include "textdocumentmodel.h"
 
+#include <compat/qasconst.h>
+
 #include <QAbstractTextDocumentLayout>
 #include <QTextCursor>
 #include <QTextDocument>
 #include <QTextFrame>
 #include <QTextTable>
 
+#include <algorithm>
+
 using namespace GammaRay;
 
 static QString formatTypeToString(int type)
@@ -55,36 +59,238 @@ static QString formatTypeToString(int type)
     return QStringLiteral("Unknown format: %1").arg(type);
 }
 
+static void collectFrames(QTextFrame *frame, QVector<QTextFrame *> &frames)
+{
+    foreach (auto child, frame->childFrames()) {
+        frames.push_back(child);
+        collectFrames(child, frames);
+    }
+}
+
+/// The frame and, for tables, the cell a block belongs to.
+static QPair<QTextFrame *, int> blockContainer(const QTextBlock &block)
+{
+    const auto frame = QTextCursor(block).currentFrame();
+    if (const auto table = qobject_cast<QTextTable *>(frame)) {
+        const auto cell = table->cellAt(block.position());
+        return qMakePair(frame, cell.row() * table->columns() + cell.column());
+    }
+    return qMakePair(frame, -1);
+}
+
 TextDocumentModel::TextDocumentModel(QObject *parent)
     : QStandardItemModel(parent)
     , m_document(nullptr)
+    , m_blockCountChanged(false)
 {
 }
 
 void TextDocumentModel::setDocument(QTextDocument *doc)
 {
-    if (m_document)
-        disconnect(m_document, &QTextDocument::contentsChanged, this, &TextDocumentModel::documentChanged);
+    if (m_document) {
+        disconnect(m_document, &QTextDocument::contentsChange, this, &TextDocumentModel::documentChanged);
+        disconnect(m_document, &QTextDocument::contentsChanged, this, &TextDocumentModel::updateBoundingBoxes);
+    }
 
     m_document = doc;
     fillModel();
 
-    if (m_document)
-        connect(m_document, &QTextDocument::contentsChanged, this, &TextDocumentModel::documentChanged);
+    if (m_document) {
+        connect(m_document, &QTextDocument::contentsChange, this, &TextDocumentModel::documentChanged);
+        connect(m_document, &QTextDocument::contentsChanged, this, &TextDocumentModel::updateBoundingBoxes);
+    }
 }
 
-void TextDocumentModel::documentChanged()
+QVariant TextDocumentModel::data(const QModelIndex &index, int role) const
 {
-    // TODO
-    fillModel();
+    if (role == BoundingBoxRole) {
+        if (!m_document)
+            return QVariant();
+        // fragments and table cells have none, they are within the box of their block or table
+        const auto item = itemFromIndex(index);
+        const auto frameIt = m_itemFrames.constFind(item);
+        if (frameIt != m_itemFrames.constEnd())
+            return m_document->documentLayout()->frameBoundingRect(frameIt.value());
+        const auto blockIt = m_itemBlocks.constFind(item);
+        if (blockIt != m_itemBlocks.constEnd())
+            return m_document->documentLayout()->blockBoundingRect(blockIt.value());
+        return QVariant();
+    }
+    return QStandardItemModel::data(index, role);
+}
+
+QMap<int, QVariant> TextDocumentModel::itemData(const QModelIndex &index) const
+{
+    auto itemData = QStandardItemModel::itemData(index);
+    const auto boundingBox = data(index, BoundingBoxRole);
+    if (boundingBox.isValid())
+        itemData.insert(BoundingBoxRole, boundingBox);
+    return itemData;
+}
+
+void TextDocumentModel::documentChanged(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved);
+    // the document is already updated here, unlike its layout, so only the structure is
+    // updated, bounding boxes on the following contentsChanged()
+    if (!updateBlocks(position, charsAdded))
+        fillModel();
+}
+
+/* Updates the items of the blocks touched by a change in place, as long as the
+ * frame structure remains the same. Returns @c false if a full reset is needed.
+ */
+bool TextDocumentModel::updateBlocks(int position, int charsAdded)
+{
+    QVector<QTextFrame *> frames;
+    collectFrames(m_document->rootFrame(), frames);
+    if (frames.size() != m_itemFrames.size())
+        return false; // frames or tables were added or removed
+    QHash<QTextFrame *, QStandardItem *> frameItems;
+    frameItems.reserve(m_itemFrames.size());
+    for (auto it = m_itemFrames.constBegin(); it != m_itemFrames.constEnd(); ++it)
+        frameItems.insert(it.value(), it.key());
+    for (const auto frame : qAsConst(frames)) {
+        const auto it = frameItems.constFind(frame);
+        if (it == frameItems.constEnd())
+            return false;
+        const auto table = qobject_cast<QTextTable *>(frame);
+        if (table && it.value()->rowCount() != table->rows() * table->columns())
+            return false; // rows or columns were added or removed
+    }
+
+    const auto firstBlock = m_document->findBlock(position);
+    const auto lastBlock = m_document->findBlock(std::min(position + charsAdded, m_document->characterCount() - 1));
+    if (!firstBlock.isValid() || !lastBlock.isValid())
+        return false;
+
+    // blocks before and after the changed range are unaffected, the difference in block count
+    // tells us how many of the old ones the changed range replaced
+    const auto first = firstBlock.blockNumber();
+    const auto newCount = lastBlock.blockNumber() - first + 1;
+    const auto oldCount = newCount - (m_document->blockCount() - m_blockItems.size());
+    if (oldCount <= 0 || first + oldCount > m_blockItems.size())
+        return false;
+
+    // old and new blocks need to be consecutive children of the same frame or table cell
+    const auto parent = m_blockItems.at(first)->parent();
+    const auto row = m_blockItems.at(first)->row();
+    for (int i = 1; i < oldCount; ++i) {
+        const auto item = m_blockItems.at(first + i);
+        if (item->parent() != parent || item->row() != row + i)
+            return false;
+    }
+    const auto container = blockContainer(firstBlock);
+    for (auto block = firstBlock.next(); block.isValid() && block != lastBlock.next(); block = block.next()) {
+        if (blockContainer(block) != container)
+            return false;
+    }
+
+    auto block = firstBlock;
+    const auto updateCount = std::min(oldCount, newCount);
+    for (int i = 0; i < updateCount; ++i, block = block.next()) {
+        updateBlockItem(m_blockItems.at(first + i), block);
+        m_changedBlockItems.insert(m_blockItems.at(first + i));
+    }
+
+    if (oldCount > newCount) {
+        for (int i = newCount; i < oldCount; ++i) {
+            const auto item = m_blockItems.at(first + i);
+            m_itemBlocks.remove(item);
+            m_blockHeights.remove(item);
+            m_changedBlockItems.remove(item);
+        }
+        parent->removeRows(row + newCount, oldCount - newCount);
+        m_blockItems.remove(first + newCount, oldCount - newCount);
+    } else if (newCount > oldCount) {
+        m_blockItems.insert(first + oldCount, newCount - oldCount, nullptr);
+        for (int i = oldCount; i < newCount; ++i, block = block.next()) {
+            auto item = blockItem(block);
+            parent->insertRow(row + i, QList<QStandardItem *>() << item << formatItem(block.blockFormat()));
+            m_blockItems[first + i] = item;
+            m_changedBlockItems.insert(item);
+        }
+    }
+    if (oldCount != newCount)
+        m_blockCountChanged = true;
+
+    return true;
+}
+
+void TextDocumentModel::updateBoundingBoxes()
+{
+    if (m_changedBlockItems.isEmpty())
+        return;
+
+    // the layout has processed the changes by now, everything below the changed blocks
+    // moved if their number or one of their heights changed
+    const auto layout = m_document->documentLayout();
+    auto moved = m_blockCountChanged;
+    QStandardItem *firstItem = nullptr;
+    int firstBlockNumber = m_blockItems.size();
+    for (const auto item : qAsConst(m_changedBlockItems)) {
+        const auto block = m_itemBlocks.value(item);
+        const auto height = layout->blockBoundingRect(block).height();
+        const auto it = m_blockHeights.find(item);
+        if (it == m_blockHeights.end() || it.value() != height) {
+            moved = true;
+            m_blockHeights.insert(item, height);
+        }
+        if (block.blockNumber() < firstBlockNumber) {
+            firstBlockNumber = block.blockNumber();
+            firstItem = item;
+        }
+    }
+    m_changedBlockItems.clear();
+    m_blockCountChanged = false;
+
+    if (moved && firstItem)
+        boundingBoxesMoved(firstItem);
+}
+
+/* Notifies about the moved bounding boxes of everything after the block @p item, and of
+ * the frames containing it. That is one ranged dataChanged() per parent, the boxes are
+ * only computed once they are requested.
+ */
+void TextDocumentModel::boundingBoxesMoved(QStandardItem *item)
+{
+    const auto edited = item;
+    for (auto parent = item->parent(); parent; item = parent, parent = parent->parent()) {
+        if (item != edited)
+            emit dataChanged(item->index(), item->index(), QVector<int>() << BoundingBoxRole);
+        emitBoundingBoxesChanged(parent, item->row() + 1);
+    }
+}
+
+void TextDocumentModel::emitBoundingBoxesChanged(QStandardItem *parent, int first)
+{
+    const auto last = parent->rowCount() - 1;
+    if (first > last)
+        return;
+    emit dataChanged(parent->child(first)->index(), parent->child(last)->index(),
+                     QVector<int>() << BoundingBoxRole);
+    for (int row = first; row <= last; ++row) {
+        const auto child = parent->child(row);
+        // frames, tables and cells, fragments have no bounding box
+        if (child->hasChildren() && !m_itemBlocks.contains(child))
+            emitBoundingBoxesChanged(child, 0);
+    }
 }
 
 void TextDocumentModel::fillModel()
 {
     clear();
+    m_blockItems.clear();
+    m_itemBlocks.clear();
+    m_itemFrames.clear();
+    m_blockHeights.clear();
+    m_changedBlockItems.clear();
+    m_blockCountChanged = false;
     if (!m_document)
         return;
 
+    m_blockItems.resize(m_document->blockCount());
+
     QStandardItem *item = new QStandardItem(tr("Root Frame"));
     const QTextFormat f = m_document->rootFrame()->frameFormat();
     item->setData(QVariant::fromValue(f), FormatRole);
@@ -105,26 +311,25 @@ void TextDocumentModel::fillFrame(QTextFrame *frame, QStandardItem *parent)
 void TextDocumentModel::fillFrameIterator(const QTextFrame::iterator &it, QStandardItem *parent)
 {
     if (QTextFrame *frame = it.currentFrame()) {
-        const QRectF b = m_document->documentLayout()->frameBoundingRect(frame);
         QTextTable *table = qobject_cast<QTextTable *>(frame);
         auto item = new QStandardItem;
+        m_itemFrames.insert(item, frame);
         if (table) {
             item->setText(tr("Table"));
-            appendRow(parent, item, table->format(), b);
+            appendRow(parent, item, table->format());
             fillTable(table, item);
         } else {
             item->setText(tr("Frame"));
-            appendRow(parent, item, frame->frameFormat(), b);
+            appendRow(parent, item, frame->frameFormat());
             fillFrame(frame, item);
         }
     }
     const QTextBlock block = it.currentBlock();
     if (block.isValid()) {
-        auto item = new QStandardItem;
-        item->setText(tr("Block: %1").arg(block.text()));
-        const QRectF b = m_document->documentLayout()->blockBoundingRect(block);
-        appendRow(parent, item, block.blockFormat(), b);
-        fillBlock(block, item);
+        auto item = blockItem(block);
+        parent->appendRow(QList<QStandardItem *>() << item << formatItem(block.blockFormat()));
+        Q_ASSERT(block.blockNumber() < m_blockItems.size());
+        m_blockItems[block.blockNumber()] = item;
     }
 }
 
@@ -142,35 +347,125 @@ void TextDocumentModel::fillTable(QTextTable *table, QStandardItem *parent)
     }
 }
 
-void TextDocumentModel::fillBlock(const QTextBlock &block, QStandardItem *parent)
+QStandardItem *TextDocumentModel::blockItem(const QTextBlock &block)
 {
-    for (auto it = block.begin(); it != block.end(); ++it) {
-        QStandardItem *item = new QStandardItem(tr("Fragment: %1").arg(it.fragment().text()));
-        const QRectF b = m_document->documentLayout()->blockBoundingRect(block);
-        appendRow(parent, item, it.fragment().charFormat(), b);
-        if (!block.layout())
-            continue;
+    auto item = new QStandardItem;
+    item->setText(tr("Block: %1").arg(block.text()));
+    item->setData(QVariant::fromValue<QTextFormat>(block.blockFormat()), FormatRole);
+    item->setEditable(false);
+    m_itemBlocks.insert(item, block);
+    for (auto it = block.begin(); it != block.end(); ++it)
+        item->appendRow(fragmentRow(block, it.fragment()));
+    return item;
+}
+
+void TextDocumentModel::updateBlockItem(QStandardItem *item, const QTextBlock &block)
+{
+    item->setText(tr("Block: %1").arg(block.text()));
+    item->setData(QVariant::fromValue<QTextFormat>(block.blockFormat()), FormatRole);
+    setFormat(item->parent()->child(item->row(), 1), block.blockFormat());
+    m_itemBlocks.insert(item, block);
+
+    QVector<QTextFragment> fragments;
+    for (auto it = block.begin(); it != block.end(); ++it)
+        fragments.push_back(it.fragment());
+
+    // keep the items of the unchanged fragments at the start and the end of the block,
+    // and update the changed ones in between in place, so their selection and expansion
+    // state survives typing
+    const auto isUnchanged = [](QStandardItem *fragmentItem, const QTextFragment &fragment) {
+        return fragmentItem->text() == tr("Fragment: %1").arg(fragment.text())
+               && fragmentItem->data(FormatRole).value<QTextFormat>() == fragment.charFormat();
+    };
+    const auto oldCount = item->rowCount();
+    const auto newCount = fragments.size();
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && isUnchanged(item->child(prefix), fragments.at(prefix)))
+        ++prefix;
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+           && isUnchanged(item->child(oldCount - suffix - 1), fragments.at(newCount - suffix - 1)))
+        ++suffix;
+
+    const auto oldChanged = oldCount - prefix - suffix;
+    const auto newChanged = newCount - prefix - suffix;
+    for (int i = 0; i < std::min(oldChanged, newChanged); ++i)
+        updateFragmentItem(item->child(prefix + i), block, fragments.at(prefix + i));
+    if (oldChanged > newChanged) {
+        item->removeRows(prefix + newChanged, oldChanged - newChanged);
+    } else {
+        for (int i = oldChanged; i < newChanged; ++i)
+            item->insertRow(prefix + i, fragmentRow(block, fragments.at(prefix + i)));
+    }
+
+    // a highlighter might have changed the layout formats of any fragment
+    for (int i = 0; i < prefix; ++i)
+        updateLayoutRanges(item->child(i), block, fragments.at(i));
+    for (int i = newCount - suffix; i < newCount; ++i)
+        updateLayoutRanges(item->child(i), block, fragments.at(i));
+}
+
+QList<QStandardItem *> TextDocumentModel::fragmentRow(const QTextBlock &block, const QTextFragment &fragment)
+{
+    auto item = new QStandardItem(tr("Fragment: %1").arg(fragment.text()));
+    item->setData(QVariant::fromValue<QTextFormat>(fragment.charFormat()), FormatRole);
+    item->setEditable(false);
+    updateLayoutRanges(item, block, fragment);
+    return QList<QStandardItem *>() << item << formatItem(fragment.charFormat());
+}
+
+void TextDocumentModel::updateFragmentItem(QStandardItem *item, const QTextBlock &block,
+                                           const QTextFragment &fragment)
+{
+    item->setText(tr("Fragment: %1").arg(fragment.text()));
+    item->setData(QVariant::fromValue<QTextFormat>(fragment.charFormat()), FormatRole);
+    setFormat(item->parent()->child(item->row(), 1), fragment.charFormat());
+    updateLayoutRanges(item, block, fragment);
+}
+
+/* Updates the layout range children of a fragment item in place. */
+void TextDocumentModel::updateLayoutRanges(QStandardItem *item, const QTextBlock &block,
+                                           const QTextFragment &fragment)
+{
+    int row = 0;
 #if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    if (block.layout()) {
         foreach (const auto &range, block.layout()->formats()) {
-            const auto start = std::max(range.start, it.fragment().position() - block.position());
+            const auto start = std::max(range.start, fragment.position() - block.position());
             const auto end = std::min(range.start + range.length,
-                                      it.fragment().position() + it.fragment().length()
-                                      - block.position());
+                                      fragment.position() + fragment.length() - block.position());
             if (start >= end)
                 continue;
-            auto child
-                = new QStandardItem(tr("Layout Range: %1").arg(it.fragment().text().mid(start,
-                                                                                        end
-                                                                                        -start)));
-            appendRow(item, child, range.format, QRectF());
+            const auto text = tr("Layout Range: %1").arg(block.text().mid(start, end - start));
+            if (row < item->rowCount()) {
+                auto child = item->child(row);
+                child->setText(text);
+                child->setData(QVariant::fromValue<QTextFormat>(range.format), FormatRole);
+                setFormat(item->child(row, 1), range.format);
+            } else {
+                appendRow(item, new QStandardItem(text), range.format);
+            }
+            ++row;
         }
-#endif
     }
+#else
+    Q_UNUSED(block);
+    Q_UNUSED(fragment);
+#endif
+    if (row < item->rowCount())
+        item->removeRows(row, item->rowCount() - row);
 }
 
 QStandardItem *TextDocumentModel::formatItem(const QTextFormat &format)
 {
     auto *item = new QStandardItem;
+    setFormat(item, format);
+    item->setEditable(false);
+    return item;
+}
+
+void TextDocumentModel::setFormat(QStandardItem *item, const QTextFormat &format)
+{
     if (!format.isValid()) {
         item->setText(tr("no format"));
     } else if (format.isImageFormat()) {
@@ -179,15 +474,12 @@ QStandardItem *TextDocumentModel::formatItem(const QTextFormat &format)
     } else {
         item->setText(formatTypeToString(format.type()));
     }
-    item->setEditable(false);
-    return item;
 }
 
 void TextDocumentModel::appendRow(QStandardItem *parent, QStandardItem *item,
-                                  const QTextFormat &format, const QRectF &boundingBox)
+                                  const QTextFormat &format)
 {
     item->setData(QVariant::fromValue(format), FormatRole);
-    item->setData(boundingBox, BoundingBoxRole);
     item->setEditable(false);
     parent->appendRow(QList<QStandardItem *>() << item << formatItem(format));
 }
@@ -31,17 +31,24 @@
 
 #include "common/modelroles.h"
 
+#include <QHash>
+#include <QSet>
 #include <QStandardItemModel>
 #include <QTextObject>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QTextTable;
-class QTextBlock;
 class QTextFrame;
 class QTextDocument;
 QT_END_NAMESPACE
 
 namespace GammaRay {
+/** Tree of frames, tables, blocks and fragments of a QTextDocument.
+ *  Bounding boxes are computed on demand, so the document layout isn't forced
+ *  beyond what is being looked at. Edits update the items of the changed blocks
+ *  in place, all other items keep their identity.
+ */
 class TextDocumentModel : public QStandardItemModel
 {
     Q_OBJECT
@@ -55,21 +62,42 @@ public:
 
     void setDocument(QTextDocument *doc);
 
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const override;
+
 private:
     void fillModel();
     void fillFrame(QTextFrame *frame, QStandardItem *parent);
     void fillFrameIterator(const QTextFrame::iterator &it, QStandardItem *parent);
     void fillTable(QTextTable *table, QStandardItem *parent);
-    void fillBlock(const QTextBlock &block, QStandardItem *parent);
+    QStandardItem *blockItem(const QTextBlock &block);
+    void updateBlockItem(QStandardItem *item, const QTextBlock &block);
+    QList<QStandardItem *> fragmentRow(const QTextBlock &block, const QTextFragment &fragment);
+    void updateFragmentItem(QStandardItem *item, const QTextBlock &block, const QTextFragment &fragment);
+    void updateLayoutRanges(QStandardItem *item, const QTextBlock &block, const QTextFragment &fragment);
     QStandardItem *formatItem(const QTextFormat &format);
-    void appendRow(QStandardItem *parent, QStandardItem *item, const QTextFormat &format,
-                   const QRectF &boundingBox = QRectF());
+    void setFormat(QStandardItem *item, const QTextFormat &format);
+    void appendRow(QStandardItem *parent, QStandardItem *item, const QTextFormat &format);
+    bool updateBlocks(int position, int charsAdded);
+    void boundingBoxesMoved(QStandardItem *item);
+    void emitBoundingBoxesChanged(QStandardItem *parent, int first);
 
 private slots:
-    void documentChanged();
+    void documentChanged(int position, int charsRemoved, int charsAdded);
+    void updateBoundingBoxes();
 
 private:
     QTextDocument *m_document;
+    // indexed by block number
+    QVector<QStandardItem *> m_blockItems;
+    QHash<QStandardItem *, QTextBlock> m_itemBlocks;
+    // child frames and tables, the root frame has no bounding box
+    QHash<QStandardItem *, QTextFrame *> m_itemFrames;
+    // heights of edited blocks, to tell if the following ones moved
+    QHash<QStandardItem *, qreal> m_blockHeights;
+    // blocks edited since the last contentsChanged()
+    QSet<QStandardItem *> m_changedBlockItems;
+    bool m_blockCountChanged;
 };
 }
 
@@ -30,6 +30,7 @@
 
 #include <core/objectdataprovider.h>
 
+#include <common/modelutils.h>
 #include <common/objectmodel.h>
 #include <common/objectid.h>
 #include <common/sourcelocation.h>
@@ -484,6 +485,16 @@ int TimerModel::rowCount(const QModelIndex &parent) const
     return m_sourceModel->rowCount() + m_freeTimersInfo.count();
 }
 
+QModelIndex TimerModel::indexForObject(QObject *object) const
+{
+    if (!m_sourceModel)
+        return QModelIndex();
+    const auto sourceIndex = ModelUtils::indexForObject(m_sourceModel, object);
+    if (!sourceIndex.isValid())
+        return QModelIndex();
+    return index(sourceIndex.row(), 0);
+}
+
 QVariant TimerModel::data(const QModelIndex &index, int role) const
 {
     if (!m_sourceModel || !index.isValid())
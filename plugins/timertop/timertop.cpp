@@ -32,6 +32,7 @@
 #include <core/objecttypefilterproxymodel.h>
 #include <core/signalspycallbackset.h>
 
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/objectid.h>
 
@@ -111,6 +112,8 @@ TimerTop::TimerTop(Probe *probe, QObject *parent)
     SignalSpyCallbackSet callbacks;
     callbacks.signalBeginCallback = signal_begin_callback;
     callbacks.signalEndCallback = signal_end_callback;
+    callbacks.subscribe("QTimer", { QByteArrayLiteral("timeout()") });
+    callbacks.subscribe("QQmlTimer", { QByteArrayLiteral("triggered()"), QByteArrayLiteral("runningChanged()") });
     probe->registerSignalSpyCallbackSet(callbacks);
 
     probe->registerModel(QStringLiteral("com.kdab.GammaRay.TimerModel"), TimerModel::instance());
@@ -130,14 +133,10 @@ void TimerTop::objectSelected(QObject* obj)
     if (!timer)
         return;
 
-    const auto model = m_selectionModel->model();
-    const auto indexList = model->match(model->index(0, 0), ObjectModel::ObjectIdRole,
-                       QVariant::fromValue(ObjectId(timer)), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const auto index = ModelUtils::indexForObject(m_selectionModel->model(), timer);
+    if (!index.isValid())
         return;
 
-    const auto index = indexList.first();
     m_selectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
 }
 
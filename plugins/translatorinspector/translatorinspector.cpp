@@ -35,6 +35,7 @@
 #include <core/objecttypefilterproxymodel.h>
 #include <core/remote/serverproxymodel.h>
 
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/objectid.h>
 #include <common/objectmodel.h>
@@ -148,14 +149,10 @@ void TranslatorInspector::objectSelected(QObject* obj)
     if (!t)
         return;
 
-    const auto indexList = m_translatorsModel->match(m_translationsModel->index(0, 0),
-                       TranslatorsModel::ObjectIdRole,
-                       QVariant::fromValue(ObjectId(t)), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const auto index = ModelUtils::indexForObject(m_translatorsModel, t);
+    if (!index.isValid())
         return;
 
-    const auto index = indexList.first();
     m_selectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows | QItemSelectionModel::Current);
 }
 
@@ -53,6 +53,15 @@ int TranslatorsModel::rowCount(const QModelIndex &parent) const
     return m_translators.size();
 }
 
+QModelIndex TranslatorsModel::indexForObject(QObject *object) const
+{
+    for (int row = 0; row < m_translators.size(); ++row) {
+        if (m_translators.at(row)->translator() == object)
+            return index(row, 0);
+    }
+    return QModelIndex();
+}
+
 QVariant TranslatorsModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid())
@@ -52,6 +52,8 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
     QMap<int, QVariant> itemData(const QModelIndex & index) const override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
     TranslatorWrapper *translator(const QModelIndex &index) const;
 
 public slots:
@@ -29,13 +29,22 @@
 #include "translatorwrapper.h"
 
 #include <QItemSelection>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
 
 using namespace GammaRay;
 
 TranslationsModel::TranslationsModel(TranslatorWrapper *translator)
     : QAbstractTableModel(translator)
     , m_translator(translator)
+    , m_pendingDataChangedTimer(new QTimer(this))
 {
+    m_pendingDataChangedTimer->setInterval(100);
+    m_pendingDataChangedTimer->setSingleShot(true);
+    connect(m_pendingDataChangedTimer, &QTimer::timeout, this, &TranslationsModel::emitPendingDataChanged);
+
     connect(this, &QAbstractItemModel::rowsInserted,
             this, &TranslationsModel::rowCountChanged);
     connect(this, &QAbstractItemModel::rowsRemoved,
@@ -135,12 +144,16 @@ void TranslationsModel::resetTranslations(const QItemSelection &selection)
         }
     }
 
+    // pending rows would shift under us otherwise
+    emitPendingDataChanged();
+
     for (int i = ranges.count() -1; i >= 0; --i) {
         const auto &range = ranges[i];
         beginRemoveRows(QModelIndex(), range.first, range.second);
         m_nodes.remove(range.first, range.second - range.first + 1);
         endRemoveRows();
     }
+    rebuildNodeIndex();
 }
 
 QString TranslationsModel::translation(const char *context, const char *sourceText,
@@ -157,10 +170,12 @@ QString TranslationsModel::translation(const char *context, const char *sourceTe
 
 void TranslationsModel::resetAllUnchanged()
 {
+    QItemSelection selection;
     for (int i = 0; i < m_nodes.size(); ++i) {
         if (!m_nodes[i].isOverridden)
-            resetTranslations(QItemSelection(index(i, 0), index(i, 0)));
+            selection.select(index(i, 0), index(i, 0));
     }
+    resetTranslations(selection);
 }
 
 void TranslationsModel::setTranslation(const QModelIndex &index, const QString &translation)
@@ -172,7 +187,59 @@ void TranslationsModel::setTranslation(const QModelIndex &index, const QString &
     if (row.isOverridden || row.translation == translation)
         return;
     row.translation = translation;
-    emit dataChanged(index, index);
+
+    // retranslating tends to touch lots of rows at once, so coalesce the notifications
+    {
+        QMutexLocker lock(&m_pendingDataChangedLock);
+        m_pendingDataChanged.insert(index.row());
+    }
+    if (QThread::currentThread() == thread()) {
+        startPendingDataChangedTimer();
+    } else if (m_pendingDataChangedTimerRequested.testAndSetOrdered(0, 1)) {
+        // translate() runs on any thread, the timer can only be started from ours
+        QMetaObject::invokeMethod(this, "startPendingDataChangedTimer", Qt::QueuedConnection);
+    }
+}
+
+void TranslationsModel::startPendingDataChangedTimer()
+{
+    m_pendingDataChangedTimerRequested.storeRelease(0);
+    if (!m_pendingDataChangedTimer->isActive())
+        m_pendingDataChangedTimer->start();
+}
+
+void TranslationsModel::emitPendingDataChanged()
+{
+    m_pendingDataChangedTimer->stop();
+    QList<int> rows;
+    {
+        QMutexLocker lock(&m_pendingDataChangedLock);
+        rows = m_pendingDataChanged.values();
+        m_pendingDataChanged.clear();
+    }
+    if (rows.isEmpty())
+        return;
+    std::sort(rows.begin(), rows.end());
+
+    // emit one signal per consecutive range of rows
+    int first = rows.at(0);
+    for (int i = 1; i <= rows.size(); ++i) {
+        if (i < rows.size() && rows.at(i) == rows.at(i - 1) + 1)
+            continue;
+        emit dataChanged(index(first, 3), index(rows.at(i - 1), 3));
+        if (i < rows.size())
+            first = rows.at(i);
+    }
+}
+
+void TranslationsModel::rebuildNodeIndex()
+{
+    m_nodeIndex.clear();
+    m_nodeIndex.reserve(m_nodes.size());
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        const Row &node = m_nodes.at(i);
+        m_nodeIndex.insert({ node.context, node.sourceText, node.disambiguation }, i);
+    }
 }
 
 QModelIndex TranslationsModel::findNode(const char *context, const char *sourceText,
@@ -180,12 +247,16 @@ QModelIndex TranslationsModel::findNode(const char *context, const char *sourceT
 {
     Q_UNUSED(n);
     // QUESTION make use of n?
-    for (int i = 0; i < m_nodes.size(); ++i) {
-        const Row &node = m_nodes.at(i);
-        if (node.context == context && node.sourceText == sourceText
-            && node.disambiguation == disambiguation)
-            return index(i, 0);
-    }
+    // raw data keys avoid copying the strings for the lookup
+    const Key lookupKey = {
+        QByteArray::fromRawData(context, context ? qstrlen(context) : 0),
+        QByteArray::fromRawData(sourceText, sourceText ? qstrlen(sourceText) : 0),
+        QByteArray::fromRawData(disambiguation, disambiguation ? qstrlen(disambiguation) : 0)
+    };
+    const auto it = m_nodeIndex.constFind(lookupKey);
+    if (it != m_nodeIndex.constEnd())
+        return index(it.value(), 0);
+
     if (create) {
         Row node;
         node.context = context;
@@ -194,6 +265,7 @@ QModelIndex TranslationsModel::findNode(const char *context, const char *sourceT
         const int newRow = m_nodes.size();
         beginInsertRows(QModelIndex(), newRow, newRow);
         m_nodes.append(node);
+        m_nodeIndex.insert({ node.context, node.sourceText, node.disambiguation }, newRow);
         endInsertRows();
         return index(newRow, 0);
     }
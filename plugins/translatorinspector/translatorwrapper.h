@@ -29,13 +29,19 @@
 #ifndef TRANSLATORWRAPPER_H
 #define TRANSLATORWRAPPER_H
 
+#include <common/commonutils.h>
 #include <common/modelroles.h>
 
 #include <QAbstractItemModel>
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
 #include <QTranslator>
 
 QT_BEGIN_NAMESPACE
 class QItemSelection;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
@@ -73,10 +79,34 @@ public:
 signals:
     void rowCountChanged();
 
+private slots:
+    void emitPendingDataChanged();
+    void startPendingDataChangedTimer();
+
 private:
     friend class TranslatorWrapper;
     TranslatorWrapper *m_translator;
 
+    struct Key
+    {
+        QByteArray context;
+        QByteArray sourceText;
+        QByteArray disambiguation;
+
+        bool operator==(const Key &other) const
+        {
+            return context == other.context && sourceText == other.sourceText
+                   && disambiguation == other.disambiguation;
+        }
+        friend uint qHash(const Key &key, uint seed = 0)
+        {
+            seed = CommonUtils::hashCombine(seed, qHash(key.context));
+            seed = CommonUtils::hashCombine(seed, qHash(key.sourceText));
+            seed = CommonUtils::hashCombine(seed, qHash(key.disambiguation));
+            return seed;
+        }
+    };
+
     struct Row
     {
         Row() = default;
@@ -87,7 +117,16 @@ private:
         bool isOverridden = false;
     };
     QVector<Row> m_nodes;
+    // row lookup for the translate() hot path, the keys share the data of the rows
+    QHash<Key, int> m_nodeIndex;
+
+    QTimer *m_pendingDataChangedTimer;
+    QAtomicInt m_pendingDataChangedTimerRequested;
+    // filled from any thread translate() is called in
+    QMutex m_pendingDataChangedLock;
+    QSet<int> m_pendingDataChanged;
 
+    void rebuildNodeIndex();
     QModelIndex findNode(const char *context, const char *sourceText, const char *disambiguation,
                          const int n, const bool create);
     void setTranslation(const QModelIndex &index, const QString &translation);
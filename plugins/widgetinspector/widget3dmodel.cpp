@@ -28,12 +28,16 @@
 
 #include "widget3dmodel.h"
 
+#include <QAbstractScrollArea>
 #include <QDebug>
 #include <QEvent>
 #include <QTimer>
 #include <QResizeEvent>
 #include <QMenu>
 #include <QMetaObject>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
 
 #include <common/objectmodel.h>
 #include <core/objecttreemodel.h>
@@ -42,16 +46,25 @@
 
 using namespace GammaRay;
 
+// Larger widgets get a downscaled texture, nobody will look at a 4k window
+// in the 3D view closely enough to notice, but uploading it is expensive.
+static const int MaxTextureExtent = 2048;
+
+// Set while we are rendering a texture, QWidget::render() sends paint events
+// to the widget and its children which must not invalidate the textures again.
+static bool s_renderingTexture = false;
+
 Widget3DWidget::Widget3DWidget(QWidget *qWidget, const QPersistentModelIndex &modelIndex,
                                Widget3DWidget *parent)
     : QObject(parent)
     , mModelIndex(modelIndex)
     , mQWidget(qWidget)
     , mUpdateTimer(nullptr)
+    , mTextureScale(1.0)
     , mDepth(0)
-    , mIsPainting(false)
     , mGeomDirty(true)
     , mTextureDirty(true)
+    , mTextureChangeNotified(false)
 {
     connect(qWidget, &QObject::destroyed,
             this, &QObject::deleteLater);
@@ -77,6 +90,19 @@ Widget3DWidget::Widget3DWidget(QWidget *qWidget, const QPersistentModelIndex &mo
 
     mQWidget->installEventFilter(this);
 
+    // QWidget::scroll() moves the already painted content and only sends
+    // paint events for the exposed area, so the texture of a scrolled
+    // viewport has to be re-rendered in full.
+    auto scrollArea = qobject_cast<QAbstractScrollArea*>(mQWidget->parentWidget());
+    if (scrollArea && scrollArea->viewport() == mQWidget) {
+        auto scrolled = [this]() {
+            invalidateTexture();
+            startUpdateTimer();
+        };
+        connect(scrollArea->horizontalScrollBar(), &QAbstractSlider::valueChanged, this, scrolled);
+        connect(scrollArea->verticalScrollBar(), &QAbstractSlider::valueChanged, this, scrolled);
+    }
+
     mMetaData[QLatin1String("className")] = QString::fromUtf8(mQWidget->metaObject()->className());
     mMetaData[QLatin1String("objectName")] = mQWidget->objectName();
     mMetaData[QLatin1String("address")] = quintptr(mQWidget.data());
@@ -124,22 +150,37 @@ bool Widget3DWidget::eventFilter(QObject *obj, QEvent *ev)
             }
             return false;
         }
+        case QEvent::Move: {
+            mMetaData[QStringLiteral("geometry")] = mQWidget->geometry();
+            mGeomDirty = true;
+            startUpdateTimer();
+            // children are moved by QWidget::scroll() without the parent
+            // getting paint events for the moved content
+            if (auto parent = parentWidget()) {
+                parent->invalidateTexture();
+                parent->startUpdateTimer();
+            }
+            return false;
+        }
         case QEvent::Paint: {
-            if (!mIsPainting) {
-                mTextureDirty = true;
+            if (!s_renderingTexture) {
+                invalidateTexture(static_cast<QPaintEvent*>(ev)->region());
                 startUpdateTimer();
             }
             return false;
         }
         case QEvent::Show: {
             mGeomDirty = true;
-            mTextureDirty = true;
+            invalidateTexture();
             updateTimeout();
             return false;
         }
         case QEvent::Hide: {
             mTextureImage = QImage();
             mBackTextureImage = QImage();
+            mDirtyRegion = QRegion();
+            mTextureDirty = false;
+            mTextureChangeNotified = false;
             mUpdateTimer->stop();
             Q_EMIT changed(QVector<int>() << Widget3DModel::TextureRole
                                           << Widget3DModel::BackTextureRole);
@@ -163,13 +204,38 @@ void Widget3DWidget::startUpdateTimer()
     }
 }
 
+void Widget3DWidget::invalidateTexture(const QRegion &region)
+{
+    if (region.isEmpty()) {
+        mDirtyRegion = QRect(0, 0, QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+    } else {
+        mDirtyRegion += region;
+    }
+    mTextureDirty = true;
+}
+
+QImage Widget3DWidget::texture()
+{
+    updateTexture();
+    return mTextureImage;
+}
+
+QImage Widget3DWidget::backTexture()
+{
+    updateTexture();
+    return mBackTextureImage;
+}
+
 void GammaRay::Widget3DWidget::updateTimeout()
 {
     QVector<int> changedRoles;
     if (mGeomDirty && updateGeometry()) {
         changedRoles << Widget3DModel::GeometryRole;
     }
-    if (mTextureDirty && updateTexture()) {
+    // Textures are only rendered once somebody asks for them, so we just
+    // announce the change here, and only once until they are fetched again.
+    if (mTextureDirty && !mTextureChangeNotified && mQWidget && mQWidget->isVisible()) {
+        mTextureChangeNotified = true;
         changedRoles << Widget3DModel::TextureRole
                      << Widget3DModel::BackTextureRole;
     }
@@ -226,7 +292,7 @@ bool Widget3DWidget::updateGeometry()
     bool changed = false;
     if (textureGeometry != mTextureGeometry) {
         mTextureGeometry = textureGeometry;
-        mTextureDirty = true;
+        invalidateTexture();
         changed = true;
     }
     if (geometry != mGeometry) {
@@ -244,29 +310,55 @@ bool Widget3DWidget::updateTexture()
         return false;
     }
 
+    mTextureChangeNotified = false;
     if (!mQWidget->isVisible()) {
         mTextureDirty = false;
+        mDirtyRegion = QRegion();
         return false;
     }
 
-    mIsPainting = true;
+    const QSize widgetSize = mTextureGeometry.size();
+    const int extent = qMax(widgetSize.width(), widgetSize.height());
+    const qreal scale = extent > MaxTextureExtent ? qreal(MaxTextureExtent) / extent : 1.0;
+    const QSize textureSize(qMax(1, qRound(widgetSize.width() * scale)),
+                            qMax(1, qRound(widgetSize.height() * scale)));
 
+    // Only re-render what was reported dirty by paint events, unless the
+    // texture has to be recreated anyway.
+    QRegion region = mDirtyRegion & QRegion(mTextureGeometry);
     const QImage::Format format = QImage::Format_RGBA8888;
-    mTextureImage = QImage(mTextureGeometry.size(), format);
-    mTextureImage.fill(mQWidget->palette().button().color());
+    if (mTextureImage.size() != textureSize || !qFuzzyCompare(mTextureScale, scale)) {
+        mTextureImage = QImage(textureSize, format);
+        mTextureScale = scale;
+        region = QRegion(mTextureGeometry);
+    }
+    mDirtyRegion = QRegion();
+    mTextureDirty = false;
 
-    if (isWindow()) {
-        mQWidget->render(&mTextureImage, QPoint(0, 0), QRegion(mTextureGeometry));
-        mBackTextureImage = QImage(mTextureGeometry.size(), format);
-        mQWidget->render(&mBackTextureImage, QPoint(0, 0), QRegion(mTextureGeometry));
-    } else {
-        mQWidget->render(&mTextureImage, QPoint(0, 0), QRegion(mTextureGeometry), QWidget::DrawWindowBackground);
-        mBackTextureImage = mTextureImage;
+    if (region.isEmpty()) {
+        return false;
     }
 
-    mIsPainting = false;
+    s_renderingTexture = true;
+    {
+        QPainter painter(&mTextureImage);
+        painter.scale(mTextureScale, mTextureScale);
+        // the dirty region is in widget coordinates, the texture starts at
+        // the top left corner of the visible part of the widget
+        const QRegion textureRegion = region.translated(-mTextureGeometry.topLeft());
+        painter.setClipRegion(textureRegion);
+        painter.fillRect(textureRegion.boundingRect(), mQWidget->palette().button());
+        painter.translate(region.boundingRect().topLeft() - mTextureGeometry.topLeft());
+        if (isWindow()) {
+            mQWidget->render(&painter, QPoint(0, 0), region);
+        } else {
+            mQWidget->render(&painter, QPoint(0, 0), region, QWidget::DrawWindowBackground);
+        }
+    }
+    s_renderingTexture = false;
 
-    mTextureDirty = false;
+    // front and back are identical, share the image data rather than rendering twice
+    mBackTextureImage = mTextureImage;
     return true;
 }
 
@@ -34,6 +34,7 @@
 #include <QWidget>
 #include <QMap>
 #include <QPointer>
+#include <QRegion>
 #include <QString>
 
 #include <common/objectmodel.h>
@@ -50,8 +51,9 @@ public:
     Widget3DWidget(QWidget *qWidget, const QPersistentModelIndex &modelIndex, Widget3DWidget *parent);
     ~Widget3DWidget() override;
 
-    inline QImage texture() const { return mTextureImage; }
-    inline QImage backTexture() const { return mBackTextureImage; }
+    // textures are rendered lazily, on first access after they were invalidated
+    QImage texture();
+    QImage backTexture();
     inline QRect geometry() const { return mGeometry; }
     inline QWidget *qWidget() const { return mQWidget; }
     inline Widget3DWidget *parentWidget() const { return static_cast<Widget3DWidget*>(parent()); }
@@ -82,6 +84,7 @@ private Q_SLOTS:
 
 private:
     void startUpdateTimer();
+    void invalidateTexture(const QRegion &region = QRegion());
 
 private:
     QPersistentModelIndex mModelIndex;
@@ -89,13 +92,15 @@ private:
     QImage mTextureImage;
     QImage mBackTextureImage;
     QRect mTextureGeometry;
+    QRegion mDirtyRegion;
+    qreal mTextureScale;
     QRect mGeometry;
     QVariantMap mMetaData;
     QTimer *mUpdateTimer;
     int mDepth;
-    bool mIsPainting;
     bool mGeomDirty;
     bool mTextureDirty;
+    bool mTextureChangeNotified;
 };
 
 class Widget3DModel : public QSortFilterProxyModel
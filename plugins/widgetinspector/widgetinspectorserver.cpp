@@ -42,6 +42,7 @@
 #include "core/metaobjectrepository.h"
 #include "core/varianthandler.h"
 #include "core/probesettings.h"
+#include "core/objectsearchproxymodel.h"
 #include "core/objecttypefilterproxymodel.h"
 #include <core/probe.h>
 #include "core/probeguard.h"
@@ -58,10 +59,9 @@
 #include <common/probecontrollerinterface.h>
 #include <common/remoteviewframe.h>
 
-#include <3rdparty/kde/krecursivefilterproxymodel.h>
-
 #include <QAction>
 #include <QAbstractItemView>
+#include <QAbstractScrollArea>
 #include <QApplication>
 #include <QButtonGroup>
 #include <QComboBox>
@@ -80,10 +80,12 @@
 #include <QMainWindow>
 #include <QMouseEvent>
 #include <QEvent>
+#include <QPaintEvent>
 #include <QScrollArea>
 #include <QScrollBar>
 #include <QSplitter>
 #include <QStyle>
+#include <QTimer>
 #include <QToolButton>
 #include <QWindow>
 
@@ -96,6 +98,9 @@ Q_DECLARE_METATYPE(QSizePolicy::ControlTypes)
 using namespace GammaRay;
 using namespace std;
 
+// minimum time between two remote view frames, limits our paint overhead for animated UIs
+static const int MinimumPreviewInterval = 40; // ms
+
 static bool isGoodCandidateWidget(QWidget *widget)
 {
     if (!widget->isVisible() || widget->testAttribute(Qt::WA_NoSystemBackground) ||
@@ -114,6 +119,7 @@ WidgetInspectorServer::WidgetInspectorServer(Probe *probe, QObject *parent)
                                         this))
     , m_remoteView(new RemoteViewServer(QStringLiteral("com.kdab.GammaRay.WidgetRemoteView"), this))
     , m_probe(probe)
+    , m_previewThrottleTimer(new QTimer(this))
 {
     registerWidgetMetaTypes();
     registerVariantHandlers();
@@ -122,13 +128,15 @@ WidgetInspectorServer::WidgetInspectorServer(Probe *probe, QObject *parent)
     PropertyController::registerExtension<WidgetAttributeExtension>();
 
     connect(m_remoteView, &RemoteViewServer::requestUpdate, this, &WidgetInspectorServer::updateWidgetPreview);
+    m_previewThrottleTimer->setSingleShot(true);
+    connect(m_previewThrottleTimer, &QTimer::timeout, this, &WidgetInspectorServer::updateWidgetPreview);
 
     recreateOverlayWidget();
 
     auto *widgetFilterProxy = new WidgetTreeModel(this);
     widgetFilterProxy->setSourceModel(probe->objectTreeModel());
 
-    auto widgetSearchProxy = new ServerProxyModel<KRecursiveFilterProxyModel>(this);
+    auto widgetSearchProxy = new ServerProxyModel<ObjectSearchProxyModel>(this);
     widgetSearchProxy->setSourceModel(widgetFilterProxy);
     widgetSearchProxy->addRole(ObjectModel::ObjectIdRole);
 
@@ -220,8 +228,34 @@ void WidgetInspectorServer::widgetSelectionChanged(const QItemSelection &selecti
 
 bool WidgetInspectorServer::eventFilter(QObject *object, QEvent *event)
 {
-    if (object == m_selectedWidget && event->type() == QEvent::Paint)
-        m_remoteView->sourceChanged();
+    if (m_selectedWidget && object->isWidgetType()
+        && (event->type() == QEvent::Paint
+            || (event->type() == QEvent::Move && !static_cast<QWidget *>(object)->isWindow()))) {
+        auto widget = static_cast<QWidget *>(object);
+        if (m_previewWindow && widget->window() == m_previewWindow) {
+            if (m_remoteView->isActive()) {
+                // QWidget::scroll() moves already painted content and children
+                // around and only sends paint events for the exposed area, so
+                // re-render scrolled viewports and the parents of moved widgets
+                // in full
+                QRegion region;
+                auto scrollArea = qobject_cast<QAbstractScrollArea *>(widget->parentWidget());
+                if (event->type() == QEvent::Move) {
+                    widget = widget->parentWidget();
+                    region = widget->rect();
+                } else if (scrollArea && scrollArea->viewport() == widget) {
+                    region = widget->rect();
+                } else {
+                    region = static_cast<QPaintEvent *>(event)->region();
+                }
+                m_previewDirtyRegion += region.translated(widget->mapTo(m_previewWindow, QPoint(0, 0)));
+                m_remoteView->sourceChanged();
+            } else {
+                // nobody is looking, no need to keep the backing store up to date
+                m_previewImage = QImage();
+            }
+        }
+    }
 
     // make modal dialogs non-modal so that the gammaray window is still reachable
     // TODO: should only be done in in-process mode
@@ -261,8 +295,20 @@ void WidgetInspectorServer::updateWidgetPreview()
     if (!m_remoteView->isActive() || !m_selectedWidget)
         return;
 
+    if (m_previewUpdateTime.isValid()) {
+        const auto remaining = MinimumPreviewInterval - m_previewUpdateTime.elapsed();
+        if (remaining > 0) {
+            m_previewThrottleTimer->start(static_cast<int>(remaining));
+            return;
+        }
+    }
+    m_previewThrottleTimer->stop();
+    m_previewUpdateTime.start();
+
+    updatePreviewImage(m_selectedWidget->window());
+
     RemoteViewFrame frame;
-    frame.setImage(imageForWidget(m_selectedWidget->window()));
+    frame.setImage(m_previewImage);
     WidgetFrameData data;
     data.tabFocusRects = tabFocusChain(m_selectedWidget->window());
     frame.setData(QVariant::fromValue(data));
@@ -327,6 +373,29 @@ QImage WidgetInspectorServer::imageForWidget(QWidget *widget)
     return img;
 }
 
+void WidgetInspectorServer::updatePreviewImage(QWidget *window)
+{
+    if (window != m_previewWindow || m_previewImage.size() != window->size()) {
+        m_previewWindow = window;
+        m_previewImage = QImage(window->size(), QImage::Format_ARGB32);
+        m_previewDirtyRegion = window->rect();
+    }
+
+    const QRegion region = m_previewDirtyRegion & window->rect();
+    m_previewDirtyRegion = QRegion();
+    if (region.isEmpty())
+        return;
+
+    // prevent "recursion", i.e. infinite update loop, in our eventFilter
+    Util::SetTempValue<QPointer<QWidget> > guard(m_selectedWidget, nullptr);
+    QPainter painter(&m_previewImage);
+    painter.setClipRegion(region);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(region.boundingRect(), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    window->render(&painter, region.boundingRect().topLeft(), region);
+}
+
 void WidgetInspectorServer::recreateOverlayWidget()
 {
     ProbeGuard guard;
@@ -345,15 +414,9 @@ void WidgetInspectorServer::widgetSelected(QWidget *widget)
     if (m_selectedWidget == widget)
         return;
 
-    const QAbstractItemModel *model = m_widgetSelectionModel->model();
-    const QModelIndexList indexList
-        = model->match(model->index(0, 0),
-                       ObjectModel::ObjectRole,
-                       QVariant::fromValue<QObject *>(widget), 1,
-                       Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-    if (indexList.isEmpty())
+    const QModelIndex index = ModelUtils::indexForObject(m_widgetSelectionModel->model(), widget);
+    if (!index.isValid())
         return;
-    const QModelIndex index = indexList.first();
     m_widgetSelectionModel->select(
         index,
         QItemSelectionModel::Select | QItemSelectionModel::Clear
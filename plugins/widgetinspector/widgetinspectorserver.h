@@ -33,7 +33,10 @@
 #include <widgetinspectorinterface.h>
 #include <common/remoteviewinterface.h>
 
+#include <QElapsedTimer>
+#include <QImage>
 #include <QPointer>
+#include <QRegion>
 
 QT_BEGIN_NAMESPACE
 class QModelIndex;
@@ -41,6 +44,7 @@ class QItemSelection;
 class QItemSelectionModel;
 class QLibrary;
 class QPoint;
+class QTimer;
 QT_END_NAMESPACE
 
 namespace GammaRay {
@@ -71,6 +75,7 @@ private:
                                            GammaRay::RemoteViewInterface::RequestMode mode, int& bestCandidate) const;
     void callExternalExportAction(const char *name, QWidget *widget, const QString &fileName);
     QImage imageForWidget(QWidget *widget);
+    void updatePreviewImage(QWidget *window);
     void registerWidgetMetaTypes();
     void registerVariantHandlers();
     void discoverObjects();
@@ -106,6 +111,13 @@ private:
     PaintAnalyzer *m_paintAnalyzer;
     RemoteViewServer *m_remoteView;
     Probe *m_probe;
+
+    // backing store for the remote view, only the dirty parts get re-rendered
+    QPointer<QWidget> m_previewWindow;
+    QImage m_previewImage;
+    QRegion m_previewDirtyRegion;
+    QElapsedTimer m_previewUpdateTime;
+    QTimer *m_previewThrottleTimer;
 };
 }
 
@@ -86,6 +86,12 @@ int ClientsModel::columnCount(const QModelIndex &) const
     return EndColumn;
 }
 
+QModelIndex ClientsModel::indexForObject(QObject *object) const
+{
+    const int row = m_clients.indexOf(qobject_cast<QWaylandClient *>(object));
+    return row < 0 ? QModelIndex() : index(row, 0);
+}
+
 QVariant ClientsModel::data(const QModelIndex &index, int role) const
 {
     auto client = m_clients.at(index.row());
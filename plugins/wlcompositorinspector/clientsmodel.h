@@ -67,6 +67,8 @@ public:
     QMap<int, QVariant> itemData(const QModelIndex &index) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int) const override;
 
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const;
+
 private:
     QVector<QWaylandClient *> m_clients;
 };
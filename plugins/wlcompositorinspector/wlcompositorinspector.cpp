@@ -38,6 +38,7 @@
 #include <QWaylandSurfaceGrabber>
 
 #include <common/modelroles.h>
+#include <common/modelutils.h>
 #include <common/objectbroker.h>
 #include <common/objectid.h>
 #include <common/objectmodel.h>
@@ -463,15 +464,10 @@ void WlCompositorInspector::objectAdded(QObject *obj)
 void WlCompositorInspector::objectSelected(QObject *obj)
 {
     if (auto client = qobject_cast<QWaylandClient*>(obj)) {
-        const auto indexList = m_clientsModel->match(m_clientsModel->index(0, 0),
-                    ClientsModel::ObjectIdRole,
-                    QVariant::fromValue(ObjectId(client)), 1,
-                    Qt::MatchExactly | Qt::MatchRecursive | Qt::MatchWrap);
-
-        if (indexList.isEmpty())
+        const auto index = ModelUtils::indexForObject(m_clientsModel, client);
+        if (!index.isValid())
             return;
 
-        const auto index = indexList.first();
         m_clientSelectionModel->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows | QItemSelectionModel::Current);
     }
 }
@@ -0,0 +1,106 @@
+/*
+  connectiontraffictest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "baseprobetest.h"
+
+#include <core/tools/connectiontraffic/connectiontrafficrecorder.h>
+
+#include <QAtomicInt>
+#include <QThread>
+
+#include <algorithm>
+
+using namespace GammaRay;
+
+class TrafficSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void ping();
+};
+
+class TrafficReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QAtomicInt calls;
+
+public slots:
+    void pong() { calls.ref(); }
+};
+
+class ConnectionTrafficTest : public BaseProbeTest
+{
+    Q_OBJECT
+private slots:
+    void testCrossThreadQueuedConnection()
+    {
+        createProbe();
+        ConnectionTrafficRecorder::registerCallbacks(Probe::instance());
+        ConnectionTrafficRecorder::setEnabled(true);
+
+        QThread thread;
+        thread.start();
+        TrafficSender sender;
+        auto receiver = new TrafficReceiver;
+        receiver->moveToThread(&thread);
+        connect(&sender, &TrafficSender::ping, receiver, &TrafficReceiver::pong);
+        QTest::qWait(1); // let the probe track the new objects
+
+        // the connection is learned from its first delivery, only later emissions are timed
+        emit sender.ping();
+        QTRY_COMPARE(receiver->calls.loadAcquire(), 1);
+        for (int i = 0; i < 3; ++i)
+            emit sender.ping();
+        QTRY_COMPARE(receiver->calls.loadAcquire(), 4);
+
+        const auto edges = ConnectionTrafficRecorder::edges();
+        const auto edge = std::find_if(edges.begin(), edges.end(), [](const ConnectionTrafficRecorder::Edge &edge) {
+                return edge.signal == "ping()" && edge.slot == "pong()";
+            });
+        QVERIFY(edge != edges.end());
+        QCOMPARE(edge->deliveries, quint64(4));
+        QCOMPARE(edge->queueWait.count, quint64(3));
+        QCOMPARE(edge->emitCost.count, quint64(3));
+        QVERIFY(edge->senderThread != edge->receiverThread);
+
+        ConnectionTrafficRecorder::setEnabled(false);
+        thread.quit();
+        QVERIFY(thread.wait());
+        delete receiver;
+    }
+
+    void cleanupTestCase()
+    {
+        delete Probe::instance();
+    }
+};
+
+QTEST_MAIN(ConnectionTrafficTest)
+
+#include "connectiontraffictest.moc"
@@ -0,0 +1,104 @@
+/*
+  eventlooprecordertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <core/tools/eventloopmonitor/eventlooprecorder.h>
+
+#include <QtTest/qtest.h>
+
+#include <limits>
+
+using namespace GammaRay;
+
+class EventLoopRecorderTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testEmptyHistogram()
+    {
+        EventLoopRecorder::Histogram histogram;
+        QCOMPARE(histogram.count, quint64(0));
+        QCOMPARE(histogram.percentile(50), qint64(0));
+        QCOMPARE(histogram.percentile(100), qint64(0));
+    }
+
+    void testBuckets()
+    {
+        EventLoopRecorder::Histogram histogram;
+        histogram.add(0);
+        histogram.add(1);
+        histogram.add(-5); // clock hiccups count as zero
+        histogram.add(3);
+        histogram.add(1000);
+        QCOMPARE(histogram.buckets[0], quint64(3));
+        QCOMPARE(histogram.buckets[1], quint64(1));
+        QCOMPARE(histogram.buckets[9], quint64(1)); // 512 to 1023
+        QCOMPARE(histogram.count, quint64(5));
+        QCOMPARE(histogram.total, quint64(1004));
+        QCOMPARE(histogram.max, quint64(1000));
+
+        histogram.add(std::numeric_limits<qint64>::max());
+        QCOMPARE(histogram.buckets[EventLoopRecorder::Histogram::BucketCount - 1], quint64(1));
+    }
+
+    void testPercentile()
+    {
+        EventLoopRecorder::Histogram histogram;
+        for (int i = 0; i < 99; ++i)
+            histogram.add(10);
+        histogram.add(1000000);
+
+        // percentiles report the upper bound of their bucket, 8 to 15 here
+        QCOMPARE(histogram.percentile(50), qint64(15));
+        QCOMPARE(histogram.percentile(99), qint64(15));
+        // but never more than the largest value seen
+        QCOMPARE(histogram.percentile(100), qint64(1000000));
+
+        EventLoopRecorder::Histogram single;
+        single.add(1000);
+        QCOMPARE(single.percentile(1), qint64(1000));
+    }
+
+    void testMerge()
+    {
+        EventLoopRecorder::Histogram a;
+        a.add(10);
+        EventLoopRecorder::Histogram b;
+        b.add(10);
+        b.add(1000);
+        a.merge(b);
+        QCOMPARE(a.count, quint64(3));
+        QCOMPARE(a.total, quint64(1020));
+        QCOMPARE(a.max, quint64(1000));
+        QCOMPARE(a.buckets[3], quint64(2));
+        QCOMPARE(a.percentile(100), qint64(1000));
+    }
+};
+
+QTEST_MAIN(EventLoopRecorderTest)
+
+#include "eventlooprecordertest.moc"
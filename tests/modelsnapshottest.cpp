@@ -0,0 +1,180 @@
+/*
+  modelsnapshottest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <common/modelsnapshot.h>
+#include <common/objectmodel.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QtTest/qtest.h>
+#include <QStandardItemModel>
+#include <QTemporaryFile>
+
+using namespace GammaRay;
+
+class ModelSnapshotTest : public QObject
+{
+    Q_OBJECT
+private:
+    static bool writeSnapshot(const QAbstractItemModel *model, QTemporaryFile *file)
+    {
+        if (!file->open())
+            return false;
+        const bool result = ModelSnapshot::write(model, file);
+        file->close();
+        return result;
+    }
+
+private slots:
+    void testEmptyModel()
+    {
+        QStandardItemModel model;
+        QTemporaryFile file;
+        QVERIFY(writeSnapshot(&model, &file));
+
+        ModelSnapshotModel snapshot;
+        ModelTest tester(&snapshot);
+        QVERIFY(snapshot.load(file.fileName()));
+        QCOMPARE(snapshot.rowCount(), 0);
+        QCOMPARE(snapshot.columnCount(), 0);
+    }
+
+    void testTree()
+    {
+        QObject obj;
+        QStandardItemModel model;
+        model.setHorizontalHeaderLabels(QStringList() << QStringLiteral("Name") << QStringLiteral("Value"));
+        for (int i = 0; i < 3; ++i) {
+            auto item = new QStandardItem(QStringLiteral("top %1").arg(i));
+            item->setData(QVariant::fromValue(&obj), ObjectModel::ObjectRole);
+            item->setToolTip(QStringLiteral("tip %1").arg(i));
+            for (int j = 0; j < i; ++j) {
+                auto child = new QStandardItem(QStringLiteral("child %1.%2").arg(i).arg(j));
+                child->appendRow(new QStandardItem(QStringLiteral("grandchild")));
+                item->appendRow(QList<QStandardItem *>() << child << new QStandardItem(QString::number(j)));
+            }
+            model.appendRow(QList<QStandardItem *>() << item << new QStandardItem(QString::number(i * 10)));
+        }
+
+        QTemporaryFile file;
+        QVERIFY(writeSnapshot(&model, &file));
+
+        ModelSnapshotModel snapshot;
+        ModelTest tester(&snapshot);
+        QVERIFY(snapshot.load(file.fileName()));
+
+        QCOMPARE(snapshot.columnCount(), 2);
+        QCOMPARE(snapshot.headerData(1, Qt::Horizontal).toString(), QStringLiteral("Value"));
+        QCOMPARE(snapshot.rowCount(), 3);
+
+        const auto top = snapshot.index(2, 0);
+        QCOMPARE(top.data().toString(), QStringLiteral("top 2"));
+        QCOMPARE(top.data(Qt::ToolTipRole).toString(), QStringLiteral("tip 2"));
+        QVERIFY(!top.data(ObjectModel::ObjectRole).isValid()); // pointers are not stored
+        QCOMPARE(top.sibling(2, 1).data().toString(), QStringLiteral("20"));
+        QCOMPARE(snapshot.rowCount(top), 2);
+        QCOMPARE(snapshot.rowCount(snapshot.index(0, 0)), 0);
+
+        const auto child = snapshot.index(1, 0, top);
+        QCOMPARE(child.data().toString(), QStringLiteral("child 2.1"));
+        QCOMPARE(child.sibling(1, 1).data().toString(), QStringLiteral("1"));
+        QCOMPARE(child.parent(), top);
+
+        const auto grandChild = snapshot.index(0, 0, child);
+        QCOMPARE(grandChild.data().toString(), QStringLiteral("grandchild"));
+        QCOMPARE(grandChild.parent(), child);
+        QCOMPARE(grandChild.parent().parent(), top);
+    }
+
+    void testIncrementalWrite()
+    {
+        QStandardItemModel model;
+        for (int i = 0; i < 3; ++i) {
+            auto item = new QStandardItem(QStringLiteral("top %1").arg(i));
+            for (int j = 0; j < 2; ++j)
+                item->appendRow(new QStandardItem(QStringLiteral("child %1.%2").arg(i).arg(j)));
+            model.appendRow(item);
+        }
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        ModelSnapshotWriter writer(&model, &file);
+        QVERIFY(writer.writeRows(1));
+        QVERIFY(!writer.isFinished());
+
+        int steps = 1;
+        while (!writer.isFinished()) {
+            QVERIFY(writer.writeRows(1));
+            ++steps;
+        }
+        QCOMPARE(steps, 9);
+        file.close();
+
+        ModelSnapshotModel snapshot;
+        ModelTest tester(&snapshot);
+        QVERIFY(snapshot.load(file.fileName()));
+        QCOMPARE(snapshot.rowCount(), 3);
+        QCOMPARE(snapshot.index(1, 0).data().toString(), QStringLiteral("top 1"));
+        QCOMPARE(snapshot.rowCount(snapshot.index(1, 0)), 2);
+        QCOMPARE(snapshot.index(1, 0, snapshot.index(1, 0)).data().toString(), QStringLiteral("child 1.1"));
+    }
+
+    void testStructureChangeDuringWrite()
+    {
+        QStandardItemModel model;
+        for (int i = 0; i < 3; ++i)
+            model.appendRow(new QStandardItem(QStringLiteral("top %1").arg(i)));
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        ModelSnapshotWriter writer(&model, &file);
+        QVERIFY(writer.writeRows(1));
+
+        // pending rows are not tracked, so the export fails rather than writing stale rows
+        model.removeRow(2);
+        QVERIFY(!writer.writeRows(1));
+        QVERIFY(!writer.isFinished());
+    }
+
+    void testInvalidFile()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write("not a model snapshot, just some random text");
+        file.close();
+
+        ModelSnapshotModel snapshot;
+        QVERIFY(!snapshot.load(file.fileName()));
+        QCOMPARE(snapshot.rowCount(), 0);
+        QVERIFY(!snapshot.load(QStringLiteral("/does/not/exist")));
+    }
+};
+
+QTEST_MAIN(ModelSnapshotTest)
+
+#include "modelsnapshottest.moc"
@@ -0,0 +1,128 @@
+/*
+  modelutilstest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <common/modelutils.h>
+#include <common/objectmodel.h>
+
+#include <QtTest/qtest.h>
+#include <QSortFilterProxyModel>
+#include <QStandardItemModel>
+
+using namespace GammaRay;
+
+class LookupModel : public QStandardItemModel
+{
+    Q_OBJECT
+public:
+    explicit LookupModel(QObject *parent = nullptr)
+        : QStandardItemModel(parent)
+    {
+    }
+
+    void addObject(QObject *obj)
+    {
+        auto item = new QStandardItem(obj->objectName());
+        item->setData(QVariant::fromValue(obj), ObjectModel::ObjectRole);
+        appendRow(item);
+        m_objects.push_back(obj);
+    }
+
+    Q_INVOKABLE QModelIndex indexForObject(QObject *object) const
+    {
+        ++lookupCount;
+        const int row = m_objects.indexOf(object);
+        return row < 0 ? QModelIndex() : index(row, 0);
+    }
+
+    mutable int lookupCount = 0;
+
+private:
+    QVector<QObject *> m_objects;
+};
+
+class ModelUtilsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testFallbackMatch()
+    {
+        QObject obj1, obj2, obj3;
+        QStandardItemModel model;
+        auto item = new QStandardItem;
+        item->setData(QVariant::fromValue<QObject *>(&obj1), ObjectModel::ObjectRole);
+        model.appendRow(item);
+        auto child = new QStandardItem;
+        child->setData(QVariant::fromValue<QObject *>(&obj2), ObjectModel::ObjectRole);
+        item->appendRow(child);
+
+        QCOMPARE(ModelUtils::indexForObject(&model, &obj1), model.indexFromItem(item));
+        QCOMPARE(ModelUtils::indexForObject(&model, &obj2), model.indexFromItem(child));
+        QVERIFY(!ModelUtils::indexForObject(&model, &obj3).isValid());
+        QVERIFY(!ModelUtils::indexForObject(&model, nullptr).isValid());
+    }
+
+    void testDirectLookup()
+    {
+        QObject obj1, obj2, obj3;
+        LookupModel model;
+        model.addObject(&obj1);
+        model.addObject(&obj2);
+
+        QCOMPARE(ModelUtils::indexForObject(&model, &obj2), model.index(1, 0));
+        QCOMPARE(model.lookupCount, 1);
+        QVERIFY(!ModelUtils::indexForObject(&model, &obj3).isValid());
+        QCOMPARE(model.lookupCount, 2);
+    }
+
+    void testProxyChain()
+    {
+        QObject obj1, obj2, obj3;
+        obj1.setObjectName(QStringLiteral("a"));
+        obj2.setObjectName(QStringLiteral("b"));
+        obj3.setObjectName(QStringLiteral("c"));
+        LookupModel model;
+        model.addObject(&obj1);
+        model.addObject(&obj2);
+        model.addObject(&obj3);
+
+        QSortFilterProxyModel sortProxy;
+        sortProxy.setSourceModel(&model);
+        sortProxy.sort(0, Qt::DescendingOrder);
+        QSortFilterProxyModel filterProxy;
+        filterProxy.setSourceModel(&sortProxy);
+        filterProxy.setFilterFixedString(QStringLiteral("a"));
+
+        QCOMPARE(ModelUtils::indexForObject(&sortProxy, &obj1), sortProxy.index(2, 0));
+        QCOMPARE(ModelUtils::indexForObject(&filterProxy, &obj1), filterProxy.index(0, 0));
+        QVERIFY(!ModelUtils::indexForObject(&filterProxy, &obj2).isValid());
+        QCOMPARE(model.lookupCount, 3);
+    }
+};
+
+QTEST_MAIN(ModelUtilsTest)
+
+#include "modelutilstest.moc"
@@ -0,0 +1,170 @@
+/*
+  objectsearchproxymodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "baseprobetest.h"
+#include "testhelpers.h"
+
+#include <core/objectsearchproxymodel.h>
+#include <core/util.h>
+
+#include <QDebug>
+
+#include <memory>
+
+using namespace GammaRay;
+using namespace TestHelpers;
+
+class ObjectSearchProxyModelTest : public BaseProbeTest
+{
+    Q_OBJECT
+private:
+    static int matchCount(QAbstractItemModel *model, const QString &name)
+    {
+        return searchFixedIndexes(model, name, Qt::MatchRecursive).size();
+    }
+
+    static void setFilter(ObjectSearchProxyModel *model, const QString &pattern)
+    {
+        // the client sends case-insensitive fixed strings across all columns
+        model->setFilterKeyColumn(-1);
+        model->setFilterCaseSensitivity(Qt::CaseInsensitive);
+        model->setFilterFixedString(pattern);
+    }
+
+private slots:
+    void testFilter()
+    {
+        createProbe();
+        ObjectSearchProxyModel model;
+        model.setSourceModel(Probe::instance()->objectTreeModel());
+
+        QObject parent;
+        parent.setObjectName(QStringLiteral("searchParent"));
+        auto child = new QObject(&parent);
+        child->setObjectName(QStringLiteral("searchChild"));
+        QTest::qWait(1); // event loop re-entry
+
+        setFilter(&model, QStringLiteral("searchchild"));
+        QCOMPARE(matchCount(&model, QStringLiteral("searchChild")), 1);
+        QCOMPARE(matchCount(&model, QStringLiteral("searchParent")), 1); // ancestor stays visible
+
+        setFilter(&model, Util::addressToString(child));
+        QCOMPARE(matchCount(&model, QStringLiteral("searchChild")), 1);
+
+        setFilter(&model, QStringLiteral("noSuchObjectAnywhere"));
+        QCOMPARE(matchCount(&model, QStringLiteral("searchChild")), 0);
+    }
+
+    void testRefine()
+    {
+        createProbe();
+        ObjectSearchProxyModel model;
+        model.setSourceModel(Probe::instance()->objectTreeModel());
+
+        QObject alpha;
+        alpha.setObjectName(QStringLiteral("refineAlpha"));
+        QObject beta;
+        beta.setObjectName(QStringLiteral("refineBeta"));
+        QTest::qWait(1);
+
+        // typing character by character narrows the previous matches
+        setFilter(&model, QStringLiteral("re"));
+        setFilter(&model, QStringLiteral("ref"));
+        setFilter(&model, QStringLiteral("refine"));
+        QCOMPARE(matchCount(&model, QStringLiteral("refineAlpha")), 1);
+        QCOMPARE(matchCount(&model, QStringLiteral("refineBeta")), 1);
+        setFilter(&model, QStringLiteral("refineA"));
+        QCOMPARE(matchCount(&model, QStringLiteral("refineAlpha")), 1);
+        QCOMPARE(matchCount(&model, QStringLiteral("refineBeta")), 0);
+
+        // deleting characters or replacing the pattern goes through the trigrams
+        setFilter(&model, QStringLiteral("refine"));
+        QCOMPARE(matchCount(&model, QStringLiteral("refineBeta")), 1);
+        setFilter(&model, QStringLiteral("ineBET"));
+        QCOMPARE(matchCount(&model, QStringLiteral("refineAlpha")), 0);
+        QCOMPARE(matchCount(&model, QStringLiteral("refineBeta")), 1);
+
+        // objects created while a pattern is active are matched too
+        QObject gamma;
+        gamma.setObjectName(QStringLiteral("refineBetaGamma"));
+        QTest::qWait(1);
+        QCOMPARE(matchCount(&model, QStringLiteral("refineBetaGamma")), 1);
+    }
+
+    void testRename()
+    {
+        createProbe();
+        ObjectSearchProxyModel model;
+        model.setSourceModel(Probe::instance()->objectTreeModel());
+
+        QObject obj;
+        obj.setObjectName(QStringLiteral("nameBeforeRename"));
+        QTest::qWait(1);
+
+        setFilter(&model, QStringLiteral("nameBefore"));
+        QCOMPARE(matchCount(&model, QStringLiteral("nameBeforeRename")), 1);
+
+        // the object models don't emit dataChanged for this
+        obj.setObjectName(QStringLiteral("nameAfterRename"));
+        setFilter(&model, QStringLiteral("nameAfter"));
+        QCOMPARE(matchCount(&model, QStringLiteral("nameAfterRename")), 1);
+        setFilter(&model, QStringLiteral("nameBefore"));
+        QCOMPARE(matchCount(&model, QStringLiteral("nameAfterRename")), 0);
+    }
+
+    void testDestruction()
+    {
+        createProbe();
+        ObjectSearchProxyModel model;
+        model.setSourceModel(Probe::instance()->objectTreeModel());
+
+        std::unique_ptr<QObject> obj(new QObject);
+        obj->setObjectName(QStringLiteral("destroyedSearchObject"));
+        QTest::qWait(1);
+
+        setFilter(&model, QStringLiteral("SearchObject"));
+        QCOMPARE(matchCount(&model, QStringLiteral("destroyedSearchObject")), 1);
+
+        obj.reset();
+        QTest::qWait(1);
+        QCOMPARE(matchCount(&model, QStringLiteral("destroyedSearchObject")), 0);
+
+        // the allocator is likely to hand out the same address again
+        obj.reset(new QObject);
+        obj->setObjectName(QStringLiteral("recycledSearchObject"));
+        QTest::qWait(1);
+        setFilter(&model, QStringLiteral("recycled"));
+        QCOMPARE(matchCount(&model, QStringLiteral("recycledSearchObject")), 1);
+        setFilter(&model, QStringLiteral("destroyed"));
+        QCOMPARE(matchCount(&model, QStringLiteral("recycledSearchObject")), 0);
+    }
+};
+
+QTEST_MAIN(ObjectSearchProxyModelTest)
+
+#include "objectsearchproxymodeltest.moc"
@@ -0,0 +1,501 @@
+/*
+  probebench.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "baseprobetest.h"
+
+#include <core/signalspycallbackset.h>
+#include <plugins/signalmonitor/signalhistorymodel.h>
+
+#ifdef PROBEBENCH_REMOTE_MODEL
+#include <core/remote/remotemodelserver.h>
+#include <client/remotemodel.h>
+#include <common/message.h>
+#include <common/remotemodelroles.h>
+
+#include <QBuffer>
+#endif
+
+#ifdef PROBEBENCH_QML
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#endif
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QTimer>
+
+#include <memory>
+
+using namespace GammaRay;
+
+/*
+ * Measures the probe overhead on synthetic workloads.
+ *
+ * The remote model workload needs the client library, and the QML workload
+ * QtQuick, they are skipped in builds without those.
+ *
+ * Besides the normal QTest output, results are written as JSON to the file named
+ * in the GAMMARAY_BENCHMARK_OUTPUT environment variable, for comparing runs
+ * between commits.
+ */
+
+class ChurnThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit ChurnThread(int objectCount)
+        : m_objectCount(objectCount)
+    {
+    }
+
+    void run() override
+    {
+        static const int batchSize = 100;
+        QVector<QObject *> objects;
+        objects.reserve(batchSize);
+        for (int i = 0; i < m_objectCount; i += batchSize) {
+            for (int j = 0; j < batchSize; ++j)
+                objects.push_back(new QObject);
+            qDeleteAll(objects);
+            objects.clear();
+        }
+    }
+
+private:
+    int m_objectCount;
+};
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void triggered(int value);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    int sum = 0;
+public slots:
+    void receive(int value)
+    {
+        sum += value;
+    }
+};
+
+class EventCounter : public QObject
+{
+    Q_OBJECT
+public:
+    int count = 0;
+
+protected:
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::User) {
+            ++count;
+            return true;
+        }
+        return QObject::event(event);
+    }
+};
+
+#ifdef PROBEBENCH_REMOTE_MODEL
+static void fakeRegister() {}
+
+namespace GammaRay {
+// in-process message transport, as in remotemodeltest, including the
+// serialization of each message
+class FakeRemoteModelServer : public RemoteModelServer
+{
+    Q_OBJECT
+public:
+    explicit FakeRemoteModelServer(const QString &objectName, QObject *parent = nullptr)
+        : RemoteModelServer(objectName, parent)
+    {
+        m_myAddress = 42;
+    }
+
+    static void setup()
+    {
+        FakeRemoteModelServer::s_registerServerCallback = &fakeRegister;
+    }
+
+signals:
+    void message(const GammaRay::Message &msg);
+
+private slots:
+    void deliverMessage(const QByteArray &ba)
+    {
+        QBuffer buffer(const_cast<QByteArray *>(&ba));
+        buffer.open(QIODevice::ReadOnly);
+        emit message(Message::readMessage(&buffer));
+    }
+
+private:
+    bool isConnected() const override { return true; }
+    void sendMessage(const Message &msg) const override
+    {
+        QByteArray ba;
+        QBuffer buffer(&ba);
+        buffer.open(QIODevice::WriteOnly);
+        msg.write(&buffer);
+        buffer.close();
+        QMetaObject::invokeMethod(const_cast<FakeRemoteModelServer *>(this), "deliverMessage",
+                                  Qt::QueuedConnection, Q_ARG(QByteArray, ba));
+    }
+};
+
+class FakeRemoteModel : public RemoteModel
+{
+    Q_OBJECT
+public:
+    explicit FakeRemoteModel(const QString &serverObject, QObject *parent = nullptr)
+        : RemoteModel(serverObject, parent)
+    {
+        m_myAddress = 42;
+    }
+
+    static void setup()
+    {
+        FakeRemoteModel::s_registerClientCallback = &fakeRegister;
+    }
+
+signals:
+    void message(const GammaRay::Message &msg);
+
+private:
+    void sendMessage(const Message &msg) const override
+    {
+        QByteArray ba;
+        QBuffer buffer(&ba);
+        buffer.open(QIODevice::ReadWrite);
+        msg.write(&buffer);
+        buffer.seek(0);
+        emit const_cast<FakeRemoteModel *>(this)->message(Message::readMessage(&buffer));
+    }
+};
+}
+#endif
+
+#ifdef PROBEBENCH_REMOTE_MODEL
+// busy-waits rather than sleeping, so the wait doesn't add to the measured time
+template<typename Condition>
+static bool processEventsUntil(Condition condition)
+{
+    QElapsedTimer timeout;
+    timeout.start();
+    while (!condition()) {
+        if (timeout.elapsed() > 10000)
+            return false;
+        QCoreApplication::processEvents();
+    }
+    return true;
+}
+#endif
+
+static void signalBegin(QObject *, int, void **)
+{
+}
+
+static void signalEnd(QObject *, int)
+{
+}
+
+class ProbeBench : public BaseProbeTest
+{
+    Q_OBJECT
+private:
+    void recordResult(qint64 operations, qint64 nsecs)
+    {
+        QJsonObject result;
+        result.insert(QStringLiteral("benchmark"), QString::fromLatin1(QTest::currentTestFunction()));
+        result.insert(QStringLiteral("tag"), QString::fromLatin1(QTest::currentDataTag()));
+        result.insert(QStringLiteral("operations"), operations);
+        result.insert(QStringLiteral("nsecs"), nsecs);
+        result.insert(QStringLiteral("nsecsPerOperation"), operations ? double(nsecs) / operations : 0.0);
+        m_results.push_back(result);
+    }
+
+private slots:
+    void initTestCase()
+    {
+        createProbe();
+    }
+
+    void cleanupTestCase()
+    {
+        const auto fileName = QString::fromLocal8Bit(qgetenv("GAMMARAY_BENCHMARK_OUTPUT"));
+        if (fileName.isEmpty())
+            return;
+
+        QJsonObject doc;
+        doc.insert(QStringLiteral("qtVersion"), QString::fromLatin1(qVersion()));
+        doc.insert(QStringLiteral("results"), m_results);
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+        f.write(QJsonDocument(doc).toJson());
+    }
+
+    void benchObjectChurn_data()
+    {
+        QTest::addColumn<int>("threadCount");
+        QTest::addColumn<int>("objectCount");
+
+        QTest::newRow("main thread") << 0 << 100000;
+        QTest::newRow("1 thread") << 1 << 100000;
+        QTest::newRow("4 threads") << 4 << 25000;
+    }
+
+    void benchObjectChurn()
+    {
+        QFETCH(int, threadCount);
+        QFETCH(int, objectCount);
+
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            if (threadCount == 0) {
+                ChurnThread(objectCount).run();
+            } else {
+                QVector<ChurnThread *> threads;
+                for (int i = 0; i < threadCount; ++i) {
+                    threads.push_back(new ChurnThread(objectCount));
+                    threads.last()->start();
+                }
+                for (auto thread : qAsConst(threads))
+                    thread->wait();
+                qDeleteAll(threads);
+            }
+            // includes processing the queued object changes in the probe
+            QCoreApplication::processEvents();
+        }
+        recordResult(qMax(1, threadCount) * objectCount, timer.nsecsElapsed());
+    }
+
+    void benchSignalEmission_data()
+    {
+        QTest::addColumn<int>("monitoring");
+        QTest::addColumn<int>("emissions");
+
+        // order matters, callbacks cannot be unregistered again, so each
+        // row also includes the callbacks of the previous ones
+        QTest::newRow("unmonitored") << 0 << 1000000;
+        QTest::newRow("monitored") << 1 << 1000000;
+        // the signal monitor tool records every emission from its callback
+        QTest::newRow("signal monitor") << 2 << 100000;
+    }
+
+    void benchSignalEmission()
+    {
+        QFETCH(int, monitoring);
+        QFETCH(int, emissions);
+
+        if (monitoring == 1) {
+            SignalSpyCallbackSet callbacks;
+            callbacks.signalBeginCallback = signalBegin;
+            callbacks.signalEndCallback = signalEnd;
+            callbacks.slotBeginCallback = signalBegin;
+            callbacks.slotEndCallback = signalEnd;
+            Probe::instance()->registerSignalSpyCallbackSet(callbacks);
+        }
+        std::unique_ptr<SignalHistoryModel> history;
+        if (monitoring == 2)
+            history.reset(new SignalHistoryModel(Probe::instance()));
+
+        Emitter emitter;
+        Receiver receiver;
+        connect(&emitter, &Emitter::triggered, &receiver, &Receiver::receive);
+        QCoreApplication::processEvents(); // let the probe see the new objects
+
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            for (int i = 0; i < emissions; ++i)
+                emit emitter.triggered(1);
+            // includes recording the emissions in the signal monitor
+            QCoreApplication::processEvents();
+        }
+        recordResult(emissions, timer.nsecsElapsed());
+        QCOMPARE(receiver.sum, emissions);
+    }
+
+    void benchTimerStorm()
+    {
+        static const int timerCount = 10000;
+        int fired = 0;
+        QVector<QTimer *> timers;
+        timers.reserve(timerCount);
+        for (int i = 0; i < timerCount; ++i) {
+            auto t = new QTimer(this);
+            t->setSingleShot(true);
+            t->setInterval(0);
+            connect(t, &QTimer::timeout, this, [&fired]() { ++fired; });
+            timers.push_back(t);
+        }
+
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            for (auto t : qAsConst(timers))
+                t->start();
+            while (fired < timerCount)
+                QCoreApplication::processEvents();
+        }
+        recordResult(timerCount, timer.nsecsElapsed());
+        qDeleteAll(timers);
+    }
+
+    void benchEventFlood()
+    {
+        static const int eventCount = 100000;
+        EventCounter receiver;
+
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            for (int i = 0; i < eventCount; ++i)
+                QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+            QCoreApplication::sendPostedEvents(&receiver, QEvent::User);
+        }
+        recordResult(eventCount, timer.nsecsElapsed());
+        QCOMPARE(receiver.count, eventCount);
+    }
+
+    void benchRemoteModelScrolling()
+    {
+#ifdef PROBEBENCH_REMOTE_MODEL
+        static const int objectCount = 20000;
+        static const int pageSize = 50;
+        QObject parent;
+        for (int i = 0; i < objectCount; ++i)
+            (new QObject(&parent))->setObjectName(QStringLiteral("object%1").arg(i));
+        QCoreApplication::processEvents();
+
+        FakeRemoteModelServer::setup();
+        FakeRemoteModel::setup();
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.Bench.ObjectList"));
+        server.setModel(Probe::instance()->objectListModel());
+        server.modelMonitored(true);
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.Bench.ObjectList"));
+        connect(&server, &FakeRemoteModelServer::message, &client, &RemoteModel::newMessage);
+        connect(&client, &FakeRemoteModel::message, &server, &RemoteModelServer::newRequest);
+
+        QVERIFY(processEventsUntil([&client]() { return client.rowCount() > objectCount; }));
+        const int rowCount = client.rowCount();
+        const int columnCount = client.columnCount();
+
+        // fetches one page of rows after the other, like scrolling through a view
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            for (int first = 0; first < rowCount; first += pageSize) {
+                const int last = qMin(first + pageSize, rowCount) - 1;
+                const auto pageLoaded = [&]() {
+                    for (int row = first; row <= last; ++row) {
+                        for (int column = 0; column < columnCount; ++column) {
+                            const auto state = client.index(row, column).data(RemoteModelRole::LoadingState)
+                                               .value<RemoteModelNodeState::NodeStates>();
+                            if (state & RemoteModelNodeState::Loading)
+                                return false;
+                        }
+                    }
+                    return true;
+                };
+                for (int row = first; row <= last; ++row) {
+                    for (int column = 0; column < columnCount; ++column)
+                        client.index(row, column).data();
+                }
+                QVERIFY(processEventsUntil(pageLoaded));
+            }
+        }
+        recordResult(rowCount, timer.nsecsElapsed());
+#else
+        QSKIP("Needs the client library.");
+#endif
+    }
+
+    void benchDeepQmlTree_data()
+    {
+        QTest::addColumn<int>("depth");
+        QTest::addColumn<int>("leafCount");
+
+        QTest::newRow("depth 100") << 100 << 4;
+        QTest::newRow("depth 500") << 500 << 4;
+    }
+
+    void benchDeepQmlTree()
+    {
+#ifdef PROBEBENCH_QML
+        QFETCH(int, depth);
+        QFETCH(int, leafCount);
+
+        // nested items, each with a few leaf siblings
+        QByteArray qml("import QtQuick 2.0\n");
+        for (int level = 0; level < depth; ++level) {
+            qml += "Item {\n";
+            for (int leaf = 0; leaf < leafCount; ++leaf)
+                qml += "Rectangle { width: 10; height: 10 }\n";
+        }
+        for (int level = 0; level < depth; ++level)
+            qml += "}\n";
+
+        QQmlEngine engine;
+        QQmlComponent component(&engine);
+        component.setData(qml, QUrl());
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+        QElapsedTimer timer;
+        QBENCHMARK_ONCE {
+            timer.start();
+            std::unique_ptr<QObject> root(component.create());
+            QVERIFY(root);
+            // includes processing the queued object changes in the probe
+            QCoreApplication::processEvents();
+            root.reset();
+            QCoreApplication::processEvents();
+        }
+        recordResult(depth * (leafCount + 1), timer.nsecsElapsed());
+#else
+        QSKIP("Needs QtQuick.");
+#endif
+    }
+
+private:
+    QJsonArray m_results;
+};
+
+QTEST_MAIN(ProbeBench)
+
+#include "probebench.moc"
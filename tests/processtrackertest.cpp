@@ -0,0 +1,164 @@
+/*
+  processtrackertest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <client/processtracker_linux.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QSignalSpy>
+
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace GammaRay;
+
+namespace {
+// kills and reaps the forked child, also when a test fails half way
+struct ChildProcess
+{
+    explicit ChildProcess(pid_t pid)
+        : pid(pid)
+    {
+    }
+
+    ~ChildProcess()
+    {
+        if (pid <= 0)
+            return;
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+
+    pid_t pid;
+};
+}
+
+class ProcessTrackerTest : public QObject
+{
+    Q_OBJECT
+private:
+    static ProcessTrackerInfo lastInfo(const QSignalSpy &spy)
+    {
+        if (spy.isEmpty())
+            return ProcessTrackerInfo();
+        return spy.last().at(0).value<ProcessTrackerInfo>();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        qRegisterMetaType<GammaRay::ProcessTrackerInfo>();
+    }
+
+    void testStopAndResume()
+    {
+        const pid_t pid = fork();
+        QVERIFY(pid >= 0);
+        if (pid == 0) {
+            for (;;)
+                pause();
+        }
+        ChildProcess child(pid);
+
+        ProcessTrackerBackendLinux backend;
+        QSignalSpy spy(&backend, &ProcessTrackerBackend::processChecked);
+        QVERIFY(spy.isValid());
+
+        backend.checkProcess(pid);
+        QCOMPARE(lastInfo(spy).pid, qint64(pid));
+        QCOMPARE(lastInfo(spy).state, ProcessTracker::Running);
+        QCOMPARE(lastInfo(spy).traced, false);
+
+        // changes are reported without asking again
+        kill(pid, SIGSTOP);
+        QTRY_COMPARE(lastInfo(spy).state, ProcessTracker::Suspended);
+        kill(pid, SIGCONT);
+        QTRY_COMPARE(lastInfo(spy).state, ProcessTracker::Running);
+
+        kill(pid, SIGKILL);
+        QTRY_COMPARE(lastInfo(spy).state, ProcessTracker::Unknown);
+        QCOMPARE(lastInfo(spy).pid, qint64(pid));
+        waitpid(pid, nullptr, 0);
+        child.pid = -1;
+
+        // the pid is not looked at again, it might be reused already
+        spy.clear();
+        backend.checkProcess(pid);
+        QCOMPARE(spy.size(), 1);
+        QCOMPARE(lastInfo(spy).state, ProcessTracker::Unknown);
+    }
+
+    void testStopChecking()
+    {
+        const pid_t pid = fork();
+        QVERIFY(pid >= 0);
+        if (pid == 0) {
+            for (;;)
+                pause();
+        }
+        ChildProcess child(pid);
+
+        ProcessTrackerBackendLinux backend;
+        QSignalSpy spy(&backend, &ProcessTrackerBackend::processChecked);
+        QVERIFY(spy.isValid());
+        backend.checkProcess(pid);
+        QCOMPARE(lastInfo(spy).state, ProcessTracker::Running);
+
+        // nothing is reported in between checks anymore
+        backend.stopChecking();
+        spy.clear();
+        kill(pid, SIGSTOP);
+        QTest::qWait(200);
+        QVERIFY(spy.isEmpty());
+
+        backend.checkProcess(pid);
+        QCOMPARE(lastInfo(spy).state, ProcessTracker::Suspended);
+        kill(pid, SIGCONT);
+        QTRY_COMPARE(lastInfo(spy).state, ProcessTracker::Running);
+    }
+
+    void testNonExistingProcess()
+    {
+        const pid_t pid = fork();
+        QVERIFY(pid >= 0);
+        if (pid == 0)
+            _exit(0);
+        waitpid(pid, nullptr, 0);
+
+        ProcessTrackerBackendLinux backend;
+        QSignalSpy spy(&backend, &ProcessTrackerBackend::processChecked);
+        backend.checkProcess(pid);
+        QCOMPARE(spy.size(), 1);
+        QCOMPARE(lastInfo(spy).state, ProcessTracker::Unknown);
+    }
+};
+
+QTEST_MAIN(ProcessTrackerTest)
+
+#include "processtrackertest.moc"
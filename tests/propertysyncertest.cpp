@@ -129,20 +129,31 @@ private slots:
 
         // regular sync on changes on one side
         serverObj.setIntProp(42);
-        QCOMPARE(m_server2ClientCount, 2);
+        QCOMPARE(m_server2ClientCount, 1);
+        QTRY_COMPARE(m_server2ClientCount, 2);
         QCOMPARE(clientObj->intProp(), 42);
 
         QCOMPARE(m_client2ServerCount, 1);
         clientObj->setIntProp(23);
-        QCOMPARE(serverObj.intProp(), 23);
+        QTRY_COMPARE(serverObj.intProp(), 23);
         QCOMPARE(m_client2ServerCount, 2);
         QCOMPARE(m_server2ClientCount, 2);
 
+        // changes within one event loop pass are coalesced
+        for (int i = 0; i < 1000; ++i)
+            serverObj.setIntProp(i);
+        QTRY_COMPARE(m_server2ClientCount, 3);
+        QCOMPARE(clientObj->intProp(), 999);
+        QTest::qWait(10);
+        QCOMPARE(m_server2ClientCount, 3);
+        QCOMPARE(m_client2ServerCount, 2);
+
         // client destroyed
         m_server->setObjectEnabled(42, false);
         delete clientObj;
         serverObj.setIntProp(26);
-        QCOMPARE(m_server2ClientCount, 2);
+        QTest::qWait(10);
+        QCOMPARE(m_server2ClientCount, 3);
     }
 
 private:
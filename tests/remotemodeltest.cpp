@@ -263,6 +263,93 @@ private slots:
         QCOMPARE(i11.data().toString(), QStringLiteral("entry11"));
     }
 
+    void testServerSidePermutation()
+    {
+        QScopedPointer<QStandardItemModel> listModel(new QStandardItemModel(this));
+        listModel->appendRow(new QStandardItem(QStringLiteral("entry2")));
+        listModel->appendRow(new QStandardItem(QStringLiteral("entry0")));
+        listModel->appendRow(new QStandardItem(QStringLiteral("entry1")));
+        QSortFilterProxyModel serverProxy;
+        serverProxy.setSourceModel(listModel.data());
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.SortedListModel"), this);
+        server.setModel(&serverProxy);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.SortedListModel"), this);
+        connect(&server, &FakeRemoteModelServer::message, &client,
+                &RemoteModel::newMessage);
+        connect(&client, &FakeRemoteModel::message, &server,
+                &RemoteModelServer::newRequest);
+
+        ModelTest modelTest(&client);
+        QTest::qWait(100); // ModelTest is going to fetch stuff for us already
+
+        QCOMPARE(client.rowCount(), 3);
+        for (int row = 0; row < 3; ++row)
+            QVERIFY(waitForData(client.index(row, 0)));
+        QPersistentModelIndex entry2 = client.index(0, 0);
+
+        QSignalSpy layoutSpy(&client, SIGNAL(layoutChanged()));
+        QVERIFY(layoutSpy.isValid());
+        client.sort(0);
+        QVERIFY(layoutSpy.wait());
+
+        // rows keep their cached data and move to their sorted position
+        for (int row = 0; row < 3; ++row) {
+            const auto index = client.index(row, 0);
+            QVERIFY(index.data(RemoteModelRole::LoadingState).value<RemoteModelNodeState::NodeStates>()
+                    == RemoteModelNodeState::NoState);
+            QCOMPARE(index.data().toString(), QStringLiteral("entry%1").arg(row));
+        }
+        QCOMPARE(entry2.row(), 2);
+    }
+
+    void testServerSideDynamicSortMove()
+    {
+        QScopedPointer<QStandardItemModel> listModel(new QStandardItemModel(this));
+        for (int i = 0; i < 10; ++i)
+            listModel->appendRow(new QStandardItem(QStringLiteral("entry%1").arg(i)));
+        QSortFilterProxyModel serverProxy;
+        serverProxy.setDynamicSortFilter(true);
+        serverProxy.setSourceModel(listModel.data());
+        serverProxy.sort(0);
+
+        FakeRemoteModelServer server(QStringLiteral("com.kdab.GammaRay.UnitTest.DynamicSortedListModel"), this);
+        server.setModel(&serverProxy);
+        server.modelMonitored(true);
+
+        FakeRemoteModel client(QStringLiteral("com.kdab.GammaRay.UnitTest.DynamicSortedListModel"), this);
+        connect(&server, &FakeRemoteModelServer::message, &client,
+                &RemoteModel::newMessage);
+        connect(&client, &FakeRemoteModel::message, &server,
+                &RemoteModelServer::newRequest);
+
+        ModelTest modelTest(&client);
+        QTest::qWait(100);
+
+        QCOMPARE(client.rowCount(), 10);
+        for (int row = 0; row < 10; ++row)
+            QVERIFY(waitForData(client.index(row, 0)));
+        QPersistentModelIndex entry9 = client.index(9, 0);
+
+        // moves a single row to the end, shifting the ones behind it up
+        QSignalSpy layoutSpy(&client, SIGNAL(layoutChanged()));
+        QVERIFY(layoutSpy.isValid());
+        listModel->item(3)->setText(QStringLiteral("entry95"));
+        QVERIFY(layoutSpy.wait());
+
+        QCOMPARE(entry9.row(), 8);
+        for (int row = 0; row < 9; ++row) {
+            const auto index = client.index(row, 0);
+            QVERIFY(index.data(RemoteModelRole::LoadingState).value<RemoteModelNodeState::NodeStates>()
+                    == RemoteModelNodeState::NoState);
+            QCOMPARE(index.data().toString(), QStringLiteral("entry%1").arg(row < 3 ? row : row + 1));
+        }
+        QVERIFY(waitForData(client.index(9, 0)));
+        QCOMPARE(client.index(9, 0).data().toString(), QStringLiteral("entry95"));
+    }
+
     // this should not make a difference if the above works, however it broke massively with Qt 5.4...
     void testSortProxy()
     {
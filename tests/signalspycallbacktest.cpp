@@ -26,6 +26,8 @@
 
 #include "baseprobetest.h"
 
+#include <core/signalspycallbackset.h>
+
 #include <QPointer>
 
 using namespace GammaRay;
@@ -36,6 +38,14 @@ class Sender : public QObject
 public:
     void emitSignal() { emit mySignal(); }
 
+signals:
+    void mySignal();
+    void otherSignal();
+};
+
+class OtherSender : public QObject
+{
+    Q_OBJECT
 signals:
     void mySignal();
 };
@@ -47,6 +57,13 @@ public slots:
     void senderDeletingSlot() { delete sender(); }
 };
 
+static QVector<QPair<QObject *, int>> s_emissions;
+
+static void recordEmission(QObject *caller, int methodIndex, void **)
+{
+    s_emissions.push_back(qMakePair(caller, methodIndex));
+}
+
 class SignalSpyCallbackTest : public BaseProbeTest
 {
     Q_OBJECT
@@ -71,6 +88,30 @@ private slots:
         QVERIFY(s2.isNull());
     }
 
+    void testSubscription()
+    {
+        createProbe();
+
+        SignalSpyCallbackSet callbacks;
+        callbacks.signalBeginCallback = recordEmission;
+        callbacks.subscribe("Sender", QVector<QByteArray>() << QByteArrayLiteral("mySignal()"));
+        Probe::instance()->registerSignalSpyCallbackSet(callbacks);
+
+        Sender s;
+        OtherSender o;
+        QTest::qWait(1); // let the probe track the new objects
+        s_emissions.clear();
+
+        emit s.otherSignal();
+        emit o.mySignal();
+        QVERIFY(s_emissions.isEmpty());
+
+        s.emitSignal();
+        QCOMPARE(s_emissions.size(), 1);
+        QCOMPARE(s_emissions.at(0).first, static_cast<QObject *>(&s));
+        QCOMPARE(s_emissions.at(0).second, Sender::staticMetaObject.indexOfSignal("mySignal()"));
+    }
+
     void cleanupTestCase()
     {
         // explicitly delete the probe as our usual cleanup doesn't work since we will
@@ -0,0 +1,204 @@
+/*
+  textdocumentmodeltest.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <plugins/textdocumentinspector/textdocumentmodel.h>
+
+#include <3rdparty/qt/modeltest.h>
+
+#include <QAbstractTextDocumentLayout>
+#include <QSignalSpy>
+#include <QTextBlock>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QtTest/qtest.h>
+
+using namespace GammaRay;
+
+class TextDocumentModelTest : public QObject
+{
+    Q_OBJECT
+private:
+    static void verifyBlocks(const TextDocumentModel &model, QTextDocument &doc)
+    {
+        const auto root = model.index(0, 0);
+        QCOMPARE(model.rowCount(root), doc.blockCount());
+
+        const auto layout = doc.documentLayout();
+        int row = 0;
+        for (auto block = doc.begin(); block != doc.end(); block = block.next(), ++row) {
+            const auto idx = model.index(row, 0, root);
+            QCOMPARE(idx.data().toString(), QStringLiteral("Block: ") + block.text());
+            QCOMPARE(idx.data(TextDocumentModel::BoundingBoxRole).toRectF(), layout->blockBoundingRect(block));
+        }
+    }
+
+private slots:
+    void testInsertAndRemoveBlocks()
+    {
+        QTextDocument doc;
+        doc.setTextWidth(200);
+        doc.setPlainText(QStringLiteral("first\nsecond\nthird"));
+
+        TextDocumentModel model;
+        ModelTest tester(&model);
+        model.setDocument(&doc);
+        verifyBlocks(model, doc);
+        if (QTest::currentTestFailed())
+            return;
+
+        // edits are applied in place, the following blocks move down and up again
+        QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+        QVERIFY(resetSpy.isValid());
+
+        QTextCursor cursor(doc.findBlockByNumber(1));
+        cursor.insertText(QStringLiteral("new\nnewer\n"));
+        QCOMPARE(doc.blockCount(), 5);
+        verifyBlocks(model, doc);
+        if (QTest::currentTestFailed())
+            return;
+
+        cursor.setPosition(doc.findBlockByNumber(1).position());
+        cursor.setPosition(doc.findBlockByNumber(3).position(), QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        QCOMPARE(doc.blockCount(), 3);
+        verifyBlocks(model, doc);
+        if (QTest::currentTestFailed())
+            return;
+
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertBlock();
+        cursor.insertText(QStringLiteral("last"));
+        verifyBlocks(model, doc);
+
+        QCOMPARE(resetSpy.size(), 0);
+    }
+
+    void testBoundingBoxesMoved()
+    {
+        QTextDocument doc;
+        doc.setTextWidth(200);
+        doc.setPlainText(QStringLiteral("first\nsecond\nthird"));
+
+        TextDocumentModel model;
+        ModelTest tester(&model);
+        model.setDocument(&doc);
+        const auto root = model.index(0, 0);
+        const QPersistentModelIndex third = model.index(2, 0, root);
+
+        QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+        QVERIFY(changedSpy.isValid());
+
+        // the following blocks move down, one notification covers all of them
+        QTextCursor cursor(doc.findBlockByNumber(0));
+        cursor.movePosition(QTextCursor::EndOfBlock);
+        cursor.insertBlock();
+        QVERIFY(third.isValid());
+        bool notified = false;
+        for (const auto &args : changedSpy) {
+            const auto topLeft = args.at(0).toModelIndex();
+            const auto bottomRight = args.at(1).toModelIndex();
+            if (topLeft.parent() == root && topLeft.row() <= third.row() && bottomRight.row() >= third.row()
+                && args.at(2).value<QVector<int>>().contains(TextDocumentModel::BoundingBoxRole))
+                notified = true;
+        }
+        QVERIFY(notified);
+        verifyBlocks(model, doc);
+        if (QTest::currentTestFailed())
+            return;
+
+        // typing within a line moves nothing
+        changedSpy.clear();
+        cursor.insertText(QStringLiteral("x"));
+        for (const auto &args : changedSpy)
+            QVERIFY(!args.at(2).value<QVector<int>>().contains(TextDocumentModel::BoundingBoxRole));
+        verifyBlocks(model, doc);
+    }
+
+    void testFragmentsSurviveEdits()
+    {
+        QTextDocument doc;
+        QTextCursor cursor(&doc);
+        cursor.insertText(QStringLiteral("plain "));
+        QTextCharFormat bold;
+        bold.setFontWeight(QFont::Bold);
+        cursor.insertText(QStringLiteral("bold"), bold);
+        cursor.insertText(QStringLiteral(" tail"), QTextCharFormat());
+
+        TextDocumentModel model;
+        ModelTest tester(&model);
+        model.setDocument(&doc);
+        const auto block = model.index(0, 0, model.index(0, 0));
+        QCOMPARE(model.rowCount(block), 3);
+        const QPersistentModelIndex first = model.index(0, 0, block);
+        const QPersistentModelIndex edited = model.index(1, 0, block);
+        const QPersistentModelIndex last = model.index(2, 0, block);
+
+        // typing within a fragment updates its item in place
+        cursor.setPosition(8);
+        cursor.insertText(QStringLiteral("er"), bold);
+        QCOMPARE(model.rowCount(block), 3);
+        QVERIFY(first.isValid());
+        QVERIFY(edited.isValid());
+        QVERIFY(last.isValid());
+        QCOMPARE(edited.row(), 1);
+        QCOMPARE(edited.data().toString(), QStringLiteral("Fragment: boerld"));
+        QCOMPARE(last.row(), 2);
+        QCOMPARE(last.data().toString(), QStringLiteral("Fragment:  tail"));
+    }
+
+    void testMaximumBlockCount()
+    {
+        // appending to a full document removes blocks from its start within the same edit
+        QTextDocument doc;
+        doc.setPlainText(QStringLiteral("first\nsecond\nthird"));
+        doc.setMaximumBlockCount(3);
+
+        TextDocumentModel model;
+        ModelTest tester(&model);
+        model.setDocument(&doc);
+        QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+        QVERIFY(resetSpy.isValid());
+
+        QTextCursor cursor(&doc);
+        cursor.movePosition(QTextCursor::End);
+        for (int i = 0; i < 3; ++i) {
+            cursor.insertBlock();
+            cursor.insertText(QStringLiteral("line %1").arg(i));
+            QCOMPARE(doc.blockCount(), 3);
+            verifyBlocks(model, doc);
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QCOMPARE(resetSpy.size(), 0);
+    }
+};
+
+QTEST_MAIN(TextDocumentModelTest)
+
+#include "textdocumentmodeltest.moc"
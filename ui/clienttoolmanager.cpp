@@ -31,9 +31,12 @@
 
 #include <ui/proxytooluifactory.h>
 #include <ui/tools/messagehandler/messagehandlerwidget.h>
+#include <ui/tools/connectiontraffic/connectiontrafficwidget.h>
+#include <ui/tools/eventloopmonitor/eventloopmonitorwidget.h>
 #include <ui/tools/metaobjectbrowser/metaobjectbrowserwidget.h>
 #include <ui/tools/metatypebrowser/metatypebrowserwidget.h>
 #include <ui/tools/objectinspector/objectinspectorwidget.h>
+#include <ui/tools/overheadmonitor/overheadmonitorwidget.h>
 #include <ui/tools/problemreporter/problemreporterwidget.h>
 #include <ui/tools/resourcebrowser/resourcebrowserwidget.h>
 
@@ -61,9 +64,12 @@ using namespace GammaRay;
         } \
     }
 
+MAKE_FACTORY(ConnectionTraffic, qApp->translate("GammaRay::ConnectionTrafficFactory", "Connection Traffic"));
+MAKE_FACTORY(EventLoopMonitor,  qApp->translate("GammaRay::EventLoopMonitorFactory", "Event Loops"));
 MAKE_FACTORY(MessageHandler,    qApp->translate("GammaRay::MessageHandlerFactory", "Messages"));
 MAKE_FACTORY(MetaObjectBrowser, qApp->translate("GammaRay::MetaObjectBrowserFactory", "Meta Objects"));
 MAKE_FACTORY(MetaTypeBrowser,   qApp->translate("GammaRay::MetaTypeBrowserFactory", "Meta Types"));
+MAKE_FACTORY(OverheadMonitor,   qApp->translate("GammaRay::OverheadMonitorFactory", "GammaRay Overhead"));
 MAKE_FACTORY(ProblemReporter,   qApp->translate("GammaRay::ProblemReporterFactory", "Problems"));
 MAKE_FACTORY(ResourceBrowser,   qApp->translate("GammaRay::ResourceBrowserFactory", "Resources"));
 
@@ -94,10 +100,13 @@ static void initPluginRepository()
     if (!s_pluginRepository()->factories.isEmpty())
         return;
 
+    insertFactory(new ConnectionTrafficFactory);
+    insertFactory(new EventLoopMonitorFactory);
     insertFactory(new MessageHandlerFactory);
     insertFactory(new MetaObjectBrowserFactory);
     insertFactory(new MetaTypeBrowserFactory);
     insertFactory(new ObjectInspectorFactory);
+    insertFactory(new OverheadMonitorFactory);
     insertFactory(new ProblemReporterFactory);
     insertFactory(new ResourceBrowserFactory);
 
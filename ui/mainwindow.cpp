@@ -43,6 +43,7 @@
 #include "common/objectbroker.h"
 #include "common/modelroles.h"
 #include "common/endpoint.h"
+#include "common/modelsnapshot.h"
 #include "common/probecontrollerinterface.h"
 
 #include "kde/klinkitemselectionmodel.h"
@@ -68,15 +69,19 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDesktopServices>
+#include <QFile>
+#include <QFileDialog>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QLabel>
 #include <QMenu>
+#include <QMessageBox>
 #include <QProcess>
 #include <QSettings>
 #include <QStyleFactory>
 #include <QTableView>
 #include <QToolButton>
+#include <QTreeView>
 #include <QUrl>
 #include <QWidgetAction>
 
@@ -200,6 +205,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->actionPlugins, &QAction::triggered,
             this, &MainWindow::aboutPlugins);
     connect(ui->actionMessageStatistics, &QAction::triggered, this, &MainWindow::showMessageStatistics);
+    connect(ui->actionSaveModelSnapshot, &QAction::triggered, this, &MainWindow::saveModelSnapshot);
+    connect(ui->actionOpenModelSnapshot, &QAction::triggered, this, &MainWindow::openModelSnapshot);
     connect(ui->actionAboutQt, &QAction::triggered,
             qobject_cast<QApplication*>(QApplication::instance()), &QApplication::aboutQt);
     connect(ui->actionAboutGammaRay, &QAction::triggered, this, &MainWindow::about);
@@ -425,6 +432,78 @@ void MainWindow::showMessageStatistics()
     view->showMaximized();
 }
 
+void MainWindow::saveModelSnapshot()
+{
+    // any registered model can be entered, these are the ones worth analyzing offline
+    const QStringList models = {
+        QStringLiteral("com.kdab.GammaRay.ObjectTree"),
+        QStringLiteral("com.kdab.GammaRay.ObjectList"),
+        QStringLiteral("com.kdab.GammaRay.ProblemModel"),
+        QStringLiteral("com.kdab.GammaRay.SignalHistoryModel"),
+        QStringLiteral("com.kdab.GammaRay.TimerModel"),
+        QStringLiteral("com.kdab.GammaRay.EventModel")
+    };
+    bool ok = false;
+    const QString modelName = QInputDialog::getItem(this, tr("Save Model Snapshot"), tr("Model:"),
+                                                    models, 0, true, &ok);
+    if (!ok || modelName.isEmpty())
+        return;
+
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("Save Model Snapshot"), QString(),
+                                                          tr("Model Snapshots (*.grms)"));
+    if (fileName.isEmpty())
+        return;
+
+    auto probeController = ObjectBroker::object<ProbeControllerInterface *>();
+    connect(probeController, &ProbeControllerInterface::modelSnapshotData,
+            this, &MainWindow::modelSnapshotDataReceived, Qt::UniqueConnection);
+    probeController->requestModelSnapshot(modelName, fileName);
+}
+
+void MainWindow::modelSnapshotDataReceived(const QString &targetFilePath, const QByteArray &data,
+                                           qint64 offset, bool finished)
+{
+    if (offset < 0) {
+        QMessageBox::warning(this, tr("Save Model Snapshot"),
+                             tr("The model snapshot for %1 could not be created. "
+                                "The model might have changed while it was exported.").arg(targetFilePath));
+        return;
+    }
+
+    QFile file(targetFilePath);
+    const QIODevice::OpenMode mode = offset == 0 ? QIODevice::WriteOnly | QIODevice::Truncate
+                                                 : QIODevice::WriteOnly | QIODevice::Append;
+    if (!file.open(mode) || file.size() != offset || file.write(data) != data.size()) {
+        // no point in transferring the rest
+        if (!finished)
+            ObjectBroker::object<ProbeControllerInterface *>()->cancelModelSnapshot(targetFilePath);
+        QMessageBox::warning(this, tr("Save Model Snapshot"),
+                             tr("Unable to write %1.").arg(targetFilePath));
+    }
+}
+
+void MainWindow::openModelSnapshot()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Open Model Snapshot"), QString(),
+                                                          tr("Model Snapshots (*.grms)"));
+    if (fileName.isEmpty())
+        return;
+
+    auto view = new QTreeView;
+    auto model = new ModelSnapshotModel(view);
+    if (!model->load(fileName)) {
+        delete view;
+        QMessageBox::warning(this, tr("Open Model Snapshot"),
+                             tr("%1 is not a valid model snapshot.").arg(fileName));
+        return;
+    }
+    view->setWindowTitle(tr("Model Snapshot: %1").arg(fileName));
+    view->setAttribute(Qt::WA_DeleteOnClose);
+    view->setUniformRowHeights(true);
+    view->setModel(model);
+    view->show();
+}
+
 bool MainWindow::selectTool(const QString &id)
 {
     if (id.isEmpty())
@@ -85,6 +85,10 @@ private slots:
     void aboutKDAB();
 
     void showMessageStatistics();
+    void saveModelSnapshot();
+    void openModelSnapshot();
+    void modelSnapshotDataReceived(const QString &targetFilePath, const QByteArray &data,
+                                   qint64 offset, bool finished);
 
     void toolSelected();
     bool selectTool(const QString &id);
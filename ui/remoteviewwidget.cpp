@@ -53,6 +53,7 @@
 #include <QPainter>
 #include <QStandardItemModel>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -69,6 +70,8 @@ RemoteViewWidget::RemoteViewWidget(QWidget *parent)
     , m_unavailableText(tr("No remote view available."))
     , m_interactionModeActions(new QActionGroup(this))
     , m_trailingColorLabel(new TrailingColorLabel(this))
+    , m_viewCacheZoom(0.0)
+    , m_viewCacheValid(false)
     , m_zoom(1.0)
     , m_x(0)
     , m_y(0)
@@ -314,6 +317,10 @@ void RemoteViewWidget::elementsAtReceived(const GammaRay::ObjectIds &ids, int be
 
 void RemoteViewWidget::frameUpdated(const RemoteViewFrame &frame)
 {
+    m_framePixmap = QPixmap::fromImage(frame.image());
+    m_frameMipmaps.clear();
+    m_viewCacheValid = false;
+
     if (!m_frame.isValid()) {
         m_frame = frame;
         if (m_initialZoomDone)
@@ -382,6 +389,10 @@ void RemoteViewWidget::setPickSourceModel(QAbstractItemModel *sourceModel)
 void RemoteViewWidget::reset()
 {
     m_frame = RemoteViewFrame();
+    m_framePixmap = QPixmap();
+    m_frameMipmaps.clear();
+    m_viewCache = QPixmap();
+    m_viewCacheValid = false;
     m_hasMeasurement = false;
     update();
     emit frameChanged();
@@ -589,21 +600,10 @@ void RemoteViewWidget::paintEvent(QPaintEvent *event)
         return;
     }
 
-    drawBackground(&p);
+    drawFrame(&p);
 
     p.save();
     p.setTransform(QTransform::fromTranslate(m_x, m_y));
-    if (m_zoom < 1.0) { // We want the preview to look nice when zoomed out,
-                        // but need to be able to see single pixels when zoomed in.
-        p.setRenderHint(QPainter::SmoothPixmapTransform);
-    }
-
-    p.save();
-    p.setTransform(QTransform().scale(m_zoom, m_zoom), true);
-    p.setTransform(m_frame.transform(), true);
-    p.drawImage(QPoint(), m_frame.image());
-    p.restore();
-
     drawDecoration(&p);
     p.restore();
 
@@ -625,6 +625,66 @@ void RemoteViewWidget::drawBackground(QPainter *p)
                 m_activeBackgroundBrush);
 }
 
+void RemoteViewWidget::drawFrame(QPainter *p)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    const qreal dpr = devicePixelRatioF();
+#else
+    const qreal dpr = devicePixelRatio();
+#endif
+    const QSize cacheSize = size() * dpr;
+    if (m_viewCacheValid && m_viewCache.size() == cacheSize && m_viewCacheZoom == m_zoom
+        && m_viewCacheOrigin == QPoint(m_x, m_y)) {
+        p->drawPixmap(0, 0, m_viewCache);
+        return;
+    }
+
+    m_viewCache = QPixmap(cacheSize);
+    m_viewCache.setDevicePixelRatio(dpr);
+    m_viewCacheZoom = m_zoom;
+    m_viewCacheOrigin = QPoint(m_x, m_y);
+    m_viewCacheValid = true;
+
+    QPainter cachePainter(&m_viewCache);
+    drawBackground(&cachePainter);
+
+    cachePainter.setTransform(QTransform::fromTranslate(m_x, m_y));
+    if (m_zoom < 1.0) { // We want the preview to look nice when zoomed out,
+                        // but need to be able to see single pixels when zoomed in.
+        cachePainter.setRenderHint(QPainter::SmoothPixmapTransform);
+    }
+    cachePainter.setTransform(QTransform().scale(m_zoom, m_zoom), true);
+    cachePainter.setTransform(m_frame.transform(), true);
+
+    // when zoomed out, start from the closest pre-scaled version that still has
+    // enough resolution, rather than scaling down the full frame on every change
+    int level = 0;
+    if (m_zoom < 1.0)
+        level = std::floor(std::log2(1.0 / m_zoom));
+    const QPixmap &pixmap = frameMipmap(level);
+    const qreal scale = std::pow(2.0, m_frameMipmaps.size() < level ? m_frameMipmaps.size() : level);
+    cachePainter.scale(scale, scale);
+    cachePainter.drawPixmap(QPoint(), pixmap);
+    cachePainter.end();
+
+    p->drawPixmap(0, 0, m_viewCache);
+}
+
+const QPixmap &RemoteViewWidget::frameMipmap(int level)
+{
+    while (level > m_frameMipmaps.size()) {
+        const QPixmap &source = m_frameMipmaps.isEmpty() ? m_framePixmap : m_frameMipmaps.last();
+        if (source.width() < 2 || source.height() < 2)
+            break;
+        QPixmap mipmap = source.scaled(source.size() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        mipmap.setDevicePixelRatio(m_framePixmap.devicePixelRatio());
+        m_frameMipmaps.push_back(mipmap);
+    }
+    if (level <= 0 || m_frameMipmaps.isEmpty())
+        return m_framePixmap;
+    return m_frameMipmaps.at(std::min(level, m_frameMipmaps.size()) - 1);
+}
+
 void RemoteViewWidget::drawDecoration(QPainter *p)
 {
     Q_UNUSED(p);
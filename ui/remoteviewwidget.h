@@ -36,6 +36,7 @@
 #include <common/remoteviewframe.h>
 
 #include <QElapsedTimer>
+#include <QPixmap>
 #include <QPointer>
 #include <QTouchEvent>
 #include <QWidget>
@@ -181,6 +182,9 @@ private:
     void updateActions();
 
     void drawBackground(QPainter *p);
+    void drawFrame(QPainter *p);
+    /// returns the frame pixmap scaled down by 2^level, creating it if necessary
+    const QPixmap &frameMipmap(int level);
     void drawRuler(QPainter *p);
     void drawFPS(QPainter *p);
     int sourceTickLabelDistance(int viewDistance);
@@ -216,6 +220,16 @@ private slots:
 
 private:
     RemoteViewFrame m_frame;
+    // m_frame's image converted to the display format once per frame
+    QPixmap m_framePixmap;
+    // m_framePixmap scaled down by 2^(i+1), for zoom levels below 50%
+    QVector<QPixmap> m_frameMipmaps;
+    // background and frame as drawn with the below view parameters, so that
+    // repaints for rulers and overlays don't need to scale the frame again
+    QPixmap m_viewCache;
+    double m_viewCacheZoom;
+    QPoint m_viewCacheOrigin;
+    bool m_viewCacheValid;
     QBrush m_activeBackgroundBrush;
     QBrush m_inactiveBackgroundBrush;
     QVector<double> m_zoomLevels;
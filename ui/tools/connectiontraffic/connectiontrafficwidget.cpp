@@ -0,0 +1,78 @@
+/*
+  connectiontrafficwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "connectiontrafficwidget.h"
+
+#include <ui/deferredtreeview.h>
+#include <ui/searchlinecontroller.h>
+
+#include <common/objectbroker.h>
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSortFilterProxyModel>
+#include <QVBoxLayout>
+
+using namespace GammaRay;
+
+ConnectionTrafficWidget::ConnectionTrafficWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_stateManager(this)
+{
+    setObjectName("ConnectionTrafficWidget");
+
+    auto proxy = new QSortFilterProxyModel(this);
+    proxy->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.ConnectionTrafficModel")));
+
+    auto searchLine = new QLineEdit(this);
+    new SearchLineController(searchLine, proxy);
+
+    auto view = new DeferredTreeView(this);
+    view->header()->setObjectName("connectionTrafficViewHeader");
+    view->setDeferredResizeMode(0, QHeaderView::Stretch);
+    view->setDeferredResizeMode(1, QHeaderView::Stretch);
+    for (int i = 2; i < 11; ++i)
+        view->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    view->setRootIsDecorated(false);
+    view->setUniformRowHeights(true);
+    view->setSortingEnabled(true);
+    view->setModel(proxy);
+    // hottest edges first
+    view->sortByColumn(4, Qt::DescendingOrder);
+
+    auto label = new QLabel(tr("Calls over queued connections, recorded while this view is open. "
+                               "Deliveries are grouped by signal, slot and the threads involved."), this);
+    label->setWordWrap(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(label);
+    layout->addWidget(searchLine);
+    layout->addWidget(view);
+}
+
+ConnectionTrafficWidget::~ConnectionTrafficWidget() = default;
@@ -0,0 +1,87 @@
+/*
+  eventloopmonitorwidget.cpp
+
+  This file is part of GammaRay, the Qt application inspection and
+  manipulation tool.
+
+  Copyright (C) 2020 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  Licensees holding valid commercial KDAB GammaRay licenses may use this file in
+  accordance with GammaRay Commercial License Agreement provided with the Software.
+
+  Contact info@kdab.com if any conditions of this licensing are not clear to you.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventloopmonitorwidget.h"
+
+#include <ui/deferredtreeview.h>
+
+#include <common/objectbroker.h>
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QSortFilterProxyModel>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+using namespace GammaRay;
+
+EventLoopMonitorWidget::EventLoopMonitorWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_stateManager(this)
+{
+    setObjectName("EventLoopMonitorWidget");
+
+    auto threadProxy = new QSortFilterProxyModel(this);
+    threadProxy->setSourceModel(ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventLoopModel")));
+
+    auto threadView = new DeferredTreeView(this);
+    threadView->header()->setObjectName("eventLoopViewHeader");
+    threadView->setDeferredResizeMode(0, QHeaderView::Stretch);
+    for (int i = 1; i < 10; ++i)
+        threadView->setDeferredResizeMode(i, QHeaderView::ResizeToContents);
+    threadView->setRootIsDecorated(false);
+    threadView->setUniformRowHeights(true);
+    threadView->setSortingEnabled(true);
+    threadView->setModel(threadProxy);
+    threadView->sortByColumn(2, Qt::DescendingOrder);
+
+    // stalls are listed chronologically
+    auto stallModel = ObjectBroker::model(QStringLiteral("com.kdab.GammaRay.EventLoopStallModel"));
+    auto stallView = new DeferredTreeView(this);
+    stallView->header()->setObjectName("eventLoopStallViewHeader");
+    stallView->setDeferredResizeMode(2, QHeaderView::Stretch);
+    stallView->setRootIsDecorated(false);
+    stallView->setUniformRowHeights(true);
+    stallView->setModel(stallModel);
+
+    auto splitter = new QSplitter(Qt::Vertical, this);
+    splitter->setObjectName("eventLoopSplitter");
+    splitter->addWidget(threadView);
+    splitter->addWidget(stallView);
+
+    auto label = new QLabel(tr("Event loop activity per thread, recorded while this view is open. "
+                               "Deliveries blocking the event loop for a long time are listed as stalls below."), this);
+    label->setWordWrap(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(label);
+    layout->addWidget(splitter);
+
+    m_stateManager.setDefaultSizes(splitter, UISizeVector() << "40%" << "60%");
+}
+
+EventLoopMonitorWidget::~EventLoopMonitorWidget() = default;
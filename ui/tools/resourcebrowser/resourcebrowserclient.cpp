@@ -47,6 +47,12 @@ void ResourceBrowserClient::downloadResource(const QString &sourceFilePath,
                                        QVariantList() << sourceFilePath << targetFilePath);
 }
 
+void ResourceBrowserClient::cancelDownload(const QString &targetFilePath)
+{
+    Endpoint::instance()->invokeObject(objectName(), "cancelDownload",
+                                       QVariantList() << targetFilePath);
+}
+
 void ResourceBrowserClient::selectResource(const QString &sourceFilePath, int line, int column)
 {
     Endpoint::instance()->invokeObject(objectName(), "selectResource",
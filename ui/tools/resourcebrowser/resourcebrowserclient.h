@@ -43,6 +43,7 @@ public:
 
     void downloadResource(const QString &sourceFilePath,
                           const QString &targetFilePath) override;
+    void cancelDownload(const QString &targetFilePath) override;
     void selectResource(const QString &sourceFilePath, int line = -1,
                         int column = -1) override;
 };
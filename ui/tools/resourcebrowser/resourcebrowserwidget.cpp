@@ -169,15 +169,19 @@ void ResourceBrowserWidget::resourceSelected(const QByteArray &contents, int lin
 }
 
 void ResourceBrowserWidget::resourceDownloaded(const QString &targetFilePath,
-                                               const QByteArray &contents)
+                                               const QByteArray &contents,
+                                               qint64 offset, bool finished)
 {
     QFile file(targetFilePath);
-    if (!file.open(QIODevice::WriteOnly)) {
+    const QIODevice::OpenMode mode = offset == 0 ? QIODevice::WriteOnly | QIODevice::Truncate
+                                                 : QIODevice::WriteOnly | QIODevice::Append;
+    if (!file.open(mode) || file.size() != offset || file.write(contents) != contents.size()) {
         qWarning("Unable to write resource content to %s", qPrintable(targetFilePath));
+        // no point in transferring the rest
+        if (!finished)
+            m_interface->cancelDownload(targetFilePath);
         return;
     }
-
-    file.write(contents);
     file.close();
 }
 
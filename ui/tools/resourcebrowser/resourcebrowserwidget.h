@@ -58,7 +58,8 @@ private slots:
     void setupLayout();
     void resourceDeselected();
     void resourceSelected(const QByteArray &contents, int line, int column);
-    void resourceDownloaded(const QString &targetFilePath, const QByteArray &contents);
+    void resourceDownloaded(const QString &targetFilePath, const QByteArray &contents,
+                            qint64 offset, bool finished);
 
     void handleCustomContextMenu(const QPoint &pos);
 